@@ -6,11 +6,44 @@
 namespace dentra {
 namespace tion {
 
+/// CRC-16/CCITT-FALSE polynomial.
+constexpr uint16_t CRC16_CCITT_POLY = 0x1021;
+
+/// Compile-time generator of CRC-16/CCITT-FALSE lookup table entry.
+constexpr uint16_t crc16_ccitt_false_table_entry(uint8_t index) {
+  uint16_t crc = index << 8;
+  for (int bit = 0; bit < 8; bit++) {
+    crc = (crc & 0x8000) ? (crc << 1) ^ CRC16_CCITT_POLY : (crc << 1);
+  }
+  return crc;
+}
+
 /// CRC-16/CCITT-FALSE. The result is in big-endian byte order.
+/// Uses ESP32 ROM implementation when built with TION_ENABLE_CRC_ROM, otherwise slice-by-8 for long data.
 uint16_t crc16_ccitt_false(uint16_t init, const void *data, size_t size);
 
 /// CRC-16/CCITT-FALSE with 0xFFFF initial value. The result is in big-endian byte order.
 inline uint16_t crc16_ccitt_false_ffff(const void *data, size_t size) { return crc16_ccitt_false(0xFFFF, data, size); }
 
+/// Streaming CRC-16/CCITT-FALSE. Start with 0xFFFF state and feed data as it arrives,
+/// the final state is the same as crc16_ccitt_false_ffff over all data at once.
+inline uint16_t crc16_update(uint16_t state, const void *data, size_t size) {
+  return crc16_ccitt_false(state, data, size);
+}
+
+/// Streaming CRC-16/CCITT-FALSE for single byte.
+uint16_t crc16_update(uint16_t state, uint8_t byte);
+
+/// CRC-16/CCITT-FALSE byte at a time with single 256 entries table.
+uint16_t crc16_ccitt_false_bytewise(uint16_t init, const void *data, size_t size);
+
+/// CRC-16/CCITT-FALSE slice-by-8, processes 8 bytes per iteration with 8x256 entries table.
+uint16_t crc16_ccitt_false_slice8(uint16_t init, const void *data, size_t size);
+
+#if defined(USE_ESP32) && defined(TION_ENABLE_CRC_ROM)
+/// CRC-16/CCITT-FALSE using ESP32 ROM function esp_rom_crc16_be.
+uint16_t crc16_ccitt_false_rom(uint16_t init, const void *data, size_t size);
+#endif
+
 }  // namespace tion
 }  // namespace dentra
@@ -176,5 +176,18 @@ struct tion3s_state_set_t {
 
 #pragma pack(pop)
 
+/// Response frame handlers of Tion3sApi sorted by frame type.
+// NOLINTNEXTLINE(readability-identifier-naming)
+template<class api_t> struct tion3s_frame_handlers_t {
+  using handler_type = tion::tion_frame_handler_t<api_t>;
+  static constexpr handler_type HANDLERS[] = {
+      {FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), sizeof(tion3s_state_t), "state get", &api_t::handle_state_get_rsp_},
+      {FRAME_TYPE_RSP(FRAME_TYPE_STATE_SET), sizeof(tion3s_state_t), "state set", &api_t::handle_state_set_rsp_},
+      {FRAME_TYPE_RSP(FRAME_TYPE_TIMERS_GET), handler_type::ANY_SIZE, "timers", &api_t::handle_timers_rsp_},
+      {FRAME_TYPE_RSP(FRAME_TYPE_SRV_MODE_SET), handler_type::ANY_SIZE, "pair", &api_t::handle_pair_rsp_},
+  };
+  static_assert(tion::is_frame_handlers_sorted(HANDLERS), "3s frame handlers must be sorted by type");
+};
+
 }  // namespace tion_3s
 }  // namespace dentra
@@ -99,46 +99,70 @@ struct Tion3sTimersResponse {
 
 uint16_t Tion3sApi::get_state_type() const { return FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET); }
 
-void Tion3sApi::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
-  // invalid size is never possible
-  // if (frame_data_size != sizeof(tion3s_state_t)) {
-  //   TION_LOGW(TAG, "Incorrect state data size: %zu", frame_data_size);
-  //   return;
-  // }
-  if (frame_type == FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET)) {
-    TION_LOGD(TAG, "Response State Get");
-    this->update_state_(*static_cast<const tion3s_state_t *>(frame_data));
-    this->notify_state_(0);
-  } else if (frame_type == FRAME_TYPE_RSP(FRAME_TYPE_STATE_SET)) {
-    TION_LOGD(TAG, "Response State Set");
-    this->update_state_(*static_cast<const tion3s_state_t *>(frame_data));
-    this->notify_state_(0);
-  } else if (frame_type == FRAME_TYPE_RSP(FRAME_TYPE_TIMERS_GET)) {
-    TION_LOGD(TAG, "Response Timers: %s", hex_cstr(frame_data, frame_data_size));
-    // структура Tion3sTimersResponse
-  } else if (frame_type == FRAME_TYPE_RSP(FRAME_TYPE_SRV_MODE_SET)) {
-    // есть подозрение, что актуальными является первые два байта,
-    // остальное условный мусор из предыдущей команды
-    //
-    // один из ответов на команду сопряжения через удержание кнопки на бризере
-    // B3.50.01.00.08.00.08.00.08.00.00.00.00.00.00.00.00.00.00.5A
-    // еще:
-    // [17:36:21][V][vport:015]: VTX: 3D.01
-    // [17:36:21][V][vport:011]: VRX: B3.10.21.19.02.00.19.19.17.68.01.0F.04.00.1E.00.00.3C.00 (19)
-    // [17:37:16][V][vport:015]: VTX: 3D.04
-    // [17:37:16][V][vport:011]: VRX: B3.40.11.00.08.00.08.00.08.00.00.00.00.00.00.00.00.00.00 (19)
-    // [17:37:21][V][vport:015]: VTX: 3D.01
-    // [17:37:21][V][vport:011]: VRX: B3.10.21.19.02.00.19.19.17.68.01.0F.05.00.1E.00.00.3C.00 (19)
-    // [17:37:39][V][vport:011]: VRX: B3.50.01.00.02.00.19.19.17.68.01.0F.05.00.1E.00.00.3C.00 (19)
-    // [17:38:09][V][vport:011]: VRX: B3.50.00.00.02.00.19.19.17.68.01.0F.05.00.1E.00.00.3C.00 (19)
-    // [17:38:16][V][vport:015]: VTX: 3D.04
-    // [17:38:16][V][vport:011]: VRX: B3.40.11.00.08.00.08.00.08.00.00.00.00.00.00.00.00.00.00 (19)
-    // [17:38:21][V][vport:015]: VTX: 3D.01
-    // [17:38:21][V][vport:011]: VRX: B3.10.21.19.02.00.19.19.17.68.01.0F.06.00.1E.00.00.3C.00 (19)
-    TION_LOGD(TAG, "Response Pair: %s", hex_cstr(frame_data, frame_data_size));
-  } else {
+TionCommandClass Tion3sApi::get_command_class(uint16_t frame_type) {
+  switch (frame_type) {
+    case FRAME_TYPE_REQ(FRAME_TYPE_STATE_GET):
+      return TionCommandClass::STATE;
+    case FRAME_TYPE_REQ(FRAME_TYPE_TIMERS_GET):
+    case FRAME_TYPE_REQ(FRAME_TYPE_ALARM):
+    case FRAME_TYPE_REQ(FRAME_TYPE_UNKNOWN_8):
+      return TionCommandClass::DIAGNOSTIC;
+    default:
+      return TionCommandClass::CONTROL;
+  }
+}
+
+bool Tion3sApi::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
+  const auto *handler = find_frame_handler(tion3s_frame_handlers_t<Tion3sApi>::HANDLERS, frame_type);
+  if (handler == nullptr) {
     TION_LOGW(TAG, "Unsupported frame %04X: %s", frame_type, hex_cstr(frame_data, frame_data_size));
+    return false;
   }
+  if (!handler->check_size(frame_data_size)) {
+    TION_LOGW(TAG, "Incorrect %s response data size: %zu", handler->name, frame_data_size);
+    return false;
+  }
+  (this->*handler->handler)(frame_data, frame_data_size);
+  return true;
+}
+
+void Tion3sApi::handle_state_get_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "Response State Get");
+  this->update_state_(*static_cast<const tion3s_state_t *>(frame_data));
+  this->notify_state_(0);
+}
+
+void Tion3sApi::handle_state_set_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "Response State Set");
+  this->update_state_(*static_cast<const tion3s_state_t *>(frame_data));
+  this->notify_state_(0);
+}
+
+void Tion3sApi::handle_timers_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "Response Timers: %s", hex_cstr(frame_data, frame_data_size));
+  // структура Tion3sTimersResponse
+}
+
+void Tion3sApi::handle_pair_rsp_(const void *frame_data, size_t frame_data_size) {
+  // есть подозрение, что актуальными является первые два байта,
+  // остальное условный мусор из предыдущей команды
+  //
+  // один из ответов на команду сопряжения через удержание кнопки на бризере
+  // B3.50.01.00.08.00.08.00.08.00.00.00.00.00.00.00.00.00.00.5A
+  // еще:
+  // [17:36:21][V][vport:015]: VTX: 3D.01
+  // [17:36:21][V][vport:011]: VRX: B3.10.21.19.02.00.19.19.17.68.01.0F.04.00.1E.00.00.3C.00 (19)
+  // [17:37:16][V][vport:015]: VTX: 3D.04
+  // [17:37:16][V][vport:011]: VRX: B3.40.11.00.08.00.08.00.08.00.00.00.00.00.00.00.00.00.00 (19)
+  // [17:37:21][V][vport:015]: VTX: 3D.01
+  // [17:37:21][V][vport:011]: VRX: B3.10.21.19.02.00.19.19.17.68.01.0F.05.00.1E.00.00.3C.00 (19)
+  // [17:37:39][V][vport:011]: VRX: B3.50.01.00.02.00.19.19.17.68.01.0F.05.00.1E.00.00.3C.00 (19)
+  // [17:38:09][V][vport:011]: VRX: B3.50.00.00.02.00.19.19.17.68.01.0F.05.00.1E.00.00.3C.00 (19)
+  // [17:38:16][V][vport:015]: VTX: 3D.04
+  // [17:38:16][V][vport:011]: VRX: B3.40.11.00.08.00.08.00.08.00.00.00.00.00.00.00.00.00.00 (19)
+  // [17:38:21][V][vport:015]: VTX: 3D.01
+  // [17:38:21][V][vport:011]: VRX: B3.10.21.19.02.00.19.19.17.68.01.0F.06.00.1E.00.00.3C.00 (19)
+  TION_LOGD(TAG, "Response Pair: %s", hex_cstr(frame_data, frame_data_size));
 }
 
 bool Tion3sApi::pair() const {
@@ -160,7 +184,7 @@ bool Tion3sApi::write_state_(const tion::TionState &state) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tion3s_state_set_t st_set(state);
+  auto &st_set = this->make_frame_data_<tion3s_state_set_t>(state);
   TION_DUMP(TAG, "fan   : %u", st_set.fan_speed);
   TION_DUMP(TAG, "temp  : %u", st_set.target_temperature);
   TION_DUMP(TAG, "gate  : %s",
@@ -181,7 +205,7 @@ bool Tion3sApi::write_state_(const tion::TionState &state) {
   return this->write_frame(FRAME_TYPE_REQ(FRAME_TYPE_STATE_SET), st_set);
 }
 
-bool Tion3sApi::reset_filter_(const tion::TionState &state) const {
+bool Tion3sApi::reset_filter_(const tion::TionState &state) {
   TION_LOGD(TAG, "Request Filter Time Reset");
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
@@ -202,7 +226,7 @@ bool Tion3sApi::reset_filter_(const tion::TionState &state) const {
   // 3D:01:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:5A
   // 3D:04:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:5A
 
-  tion3s_state_set_t st_set(state);
+  auto &st_set = this->make_frame_data_<tion3s_state_set_t>(state);
   st_set.filter_time.reset = true;
   return this->write_frame(FRAME_TYPE_REQ(FRAME_TYPE_STATE_SET), st_set);
 }
@@ -212,13 +236,13 @@ bool Tion3sApi::request_command4() const {
   return this->write_frame(FRAME_TYPE_REQ(FRAME_TYPE_TIMERS_GET));
 }
 
-bool Tion3sApi::factory_reset_(const tion::TionState &state) const {
+bool Tion3sApi::factory_reset_(const tion::TionState &state) {
   TION_LOGD(TAG, "Request Factory Reset");
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tion3s_state_set_t st_set(state);
+  auto &st_set = this->make_frame_data_<tion3s_state_set_t>(state);
   st_set.factory_reset = true;
   return this->write_frame(FRAME_TYPE_REQ(FRAME_TYPE_STATE_SET), st_set);
 }
@@ -9,12 +9,16 @@ namespace dentra {
 namespace tion {
 
 class Tion3sApi : public TionApiBase, public tion::TionApiWriter {
+  friend struct tion_3s::tion3s_frame_handlers_t<Tion3sApi>;
+
  public:
   Tion3sApi();
 
-  void read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
+  /// @return true if frame was passed to its handler.
+  bool read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
 
   uint16_t get_state_type() const;
+  static TionCommandClass get_command_class(uint16_t frame_type);
 
   bool pair() const;
 
@@ -27,11 +31,16 @@ class Tion3sApi : public TionApiBase, public tion::TionApiWriter {
  protected:
   bool request_state_() const;
   bool write_state_(const tion::TionState &state);
-  bool reset_filter_(const tion::TionState &state) const;
-  bool factory_reset_(const tion::TionState &state) const;
+  bool reset_filter_(const tion::TionState &state);
+  bool factory_reset_(const tion::TionState &state);
 
   void dump_state_(const tion_3s::tion3s_state_t &state) const;
   void update_state_(const tion_3s::tion3s_state_t &state);
+
+  void handle_state_get_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_state_set_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_timers_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_pair_rsp_(const void *frame_data, size_t frame_data_size);
 };
 
 }  // namespace tion
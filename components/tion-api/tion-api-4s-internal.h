@@ -285,5 +285,33 @@ struct tion4s_errors_t {
 
 #pragma pack(pop)
 
+/// Response frame handlers of Tion4sApi sorted by frame type.
+// NOLINTNEXTLINE(readability-identifier-naming)
+template<class api_t> struct tion4s_frame_handlers_t {
+  using handler_type = tion::tion_frame_handler_t<api_t>;
+  static constexpr handler_type HANDLERS[] = {
+#ifdef TION_ENABLE_DIAGNOSTIC
+      {FRAME_TYPE_TEST_RSP, 440, "test", &api_t::handle_test_rsp_},
+#endif
+      {FRAME_TYPE_STATE_RSP, sizeof(tion4s_raw_frame_t<tion4s_state_t>), "state", &api_t::handle_state_rsp_},
+      {FRAME_TYPE_DEV_INFO_RSP, sizeof(tion::tion_dev_info_t), "device info", &api_t::handle_dev_info_rsp_},
+#ifdef TION_ENABLE_SCHEDULER
+      {FRAME_TYPE_TIMER_RSP, sizeof(tion4s_raw_frame_t<tion4s_timer_rsp_t>), "timer", &api_t::handle_timer_rsp_},
+      {FRAME_TYPE_TIMERS_STATE_RSP, sizeof(tion4s_raw_frame_t<tion4s_timers_state_t>), "timers state",
+       &api_t::handle_timers_state_rsp_},
+      {FRAME_TYPE_TIME_RSP, sizeof(tion4s_raw_frame_t<tion4s_time_t>), "time", &api_t::handle_time_rsp_},
+#endif
+#ifdef TION_ENABLE_DIAGNOSTIC
+      {FRAME_TYPE_ERR_CNT_RSP, sizeof(tion4s_raw_frame_t<tion4s_errors_t>), "error", &api_t::handle_err_cnt_rsp_},
+#endif
+#ifdef TION_ENABLE_HEARTBEAT
+      {FRAME_TYPE_HEARTBEAT_RSP, sizeof(tion::tion_dev_info_t::work_mode_t), "heartbeat",
+       &api_t::handle_heartbeat_rsp_},
+#endif
+      {FRAME_TYPE_TURBO_RSP, sizeof(tion4s_raw_frame_t<tion4s_turbo_t>), "turbo", &api_t::handle_turbo_rsp_},
+  };
+  static_assert(tion::is_frame_handlers_sorted(HANDLERS), "4s frame handlers must be sorted by type");
+};
+
 }  // namespace tion_4s
 }  // namespace dentra
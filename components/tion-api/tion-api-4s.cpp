@@ -87,132 +87,122 @@ void tion4s_state_t::report_errors(uint32_t errors) {
 
 uint16_t Tion4sApi::get_state_type() const { return FRAME_TYPE_STATE_RSP; }
 
-void Tion4sApi::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
-  // do not use switch statement with non-contiguous values, as this will generate a lookup table with wasted space.
-#ifdef TION_ENABLE_HEARTBEAT
-  if (frame_type == FRAME_TYPE_HEARTBEAT_RSP) {
-    struct RawHeartbeatFrame {
-      tion::tion_dev_info_t::work_mode_t work_mode;  // always 1
-    } PACKED;
-    if (frame_data_size != sizeof(RawHeartbeatFrame)) {
-      TION_LOGW(TAG, "Incorrect heartbeat response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawHeartbeatFrame *>(frame_data);
-      TION_LOGD(TAG, "Response Heartbeat (%u)", frame->work_mode);
-      if (this->on_heartbeat_) {
-        this->on_heartbeat_(frame->work_mode);
-      }
-    }
-    return;
+tion::TionCommandClass Tion4sApi::get_command_class(uint16_t frame_type) {
+  switch (frame_type) {
+    case FRAME_TYPE_STATE_REQ:
+    case FRAME_TYPE_DEV_INFO_REQ:
+    case FRAME_TYPE_TURBO_REQ:
+      return tion::TionCommandClass::STATE;
+    case FRAME_TYPE_HEARTBEAT_REQ:
+      return tion::TionCommandClass::KEEPALIVE;
+    case FRAME_TYPE_TIMER_REQ:
+    case FRAME_TYPE_TIMERS_STATE_REQ:
+    case FRAME_TYPE_TIME_REQ:
+    case FRAME_TYPE_ERR_CNT_REQ:
+    case FRAME_TYPE_TEST_REQ:
+    case FRAME_TYPE_CURR_TEST_REQ:
+      return tion::TionCommandClass::DIAGNOSTIC;
+    default:
+      return tion::TionCommandClass::CONTROL;
   }
-#endif
-  if (frame_type == FRAME_TYPE_STATE_RSP) {
-    using RawStateFrame = tion4s_raw_frame_t<tion4s_state_t>;
-    if (frame_data_size != sizeof(RawStateFrame)) {
-      TION_LOGW(TAG, "Incorrect state response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawStateFrame *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] %s", frame->request_id, frame->request_id == 1 ? "State" : "Write State");
-      this->update_state_(frame->data);
-      this->notify_state_(frame->request_id);
-    }
-    return;
+}
+
+bool Tion4sApi::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
+  const auto *handler = tion::find_frame_handler(tion4s_frame_handlers_t<Tion4sApi>::HANDLERS, frame_type);
+  if (handler == nullptr) {
+    TION_LOGW(TAG, "Unsupported frame %04X: %s", frame_type, tion::hex_cstr(frame_data, frame_data_size));
+    return false;
+  }
+  if (!handler->check_size(frame_data_size)) {
+    TION_LOGW(TAG, "Incorrect %s response data size: %zu", handler->name, frame_data_size);
+    return false;
   }
+  (this->*handler->handler)(frame_data, frame_data_size);
+  return true;
+}
 
-  if (frame_type == FRAME_TYPE_TURBO_RSP) {
-    using RawTurboFrame = tion4s_raw_frame_t<tion4s_turbo_t>;
-    if (frame_data_size != sizeof(RawTurboFrame)) {
-      TION_LOGW(TAG, "Incorrect turbo response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawTurboFrame *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] Turbo", frame->request_id);
-      this->update_turbo_(frame->data);
-      if (this->on_turbo_) {
-        this->on_turbo_(frame->data, frame->request_id);
-      }
-    }
-    return;
+#ifdef TION_ENABLE_HEARTBEAT
+void Tion4sApi::handle_heartbeat_rsp_(const void *frame_data, size_t frame_data_size) {
+  struct RawHeartbeatFrame {
+    tion::tion_dev_info_t::work_mode_t work_mode;  // always 1
+  } PACKED;
+  auto *frame = static_cast<const RawHeartbeatFrame *>(frame_data);
+  TION_LOGD(TAG, "Response Heartbeat (%u)", frame->work_mode);
+  if (this->on_heartbeat_) {
+    this->on_heartbeat_(frame->work_mode);
   }
+}
+#endif
+
+void Tion4sApi::handle_state_rsp_(const void *frame_data, size_t frame_data_size) {
+  using RawStateFrame = tion4s_raw_frame_t<tion4s_state_t>;
+  auto *frame = static_cast<const RawStateFrame *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] %s", frame->request_id, frame->request_id == 1 ? "State" : "Write State");
+  this->update_state_(frame->data);
+  this->notify_state_(frame->request_id);
+}
 
-  if (frame_type == FRAME_TYPE_DEV_INFO_RSP) {
-    if (frame_data_size != sizeof(tion_dev_info_t)) {
-      TION_LOGW(TAG, "Incorrect device info response data size: %zu", frame_data_size);
-    } else {
-      TION_LOGD(TAG, "Response Device info");
-      this->update_dev_info_(*static_cast<const tion_dev_info_t *>(frame_data));
-    }
-    return;
+void Tion4sApi::handle_turbo_rsp_(const void *frame_data, size_t frame_data_size) {
+  using RawTurboFrame = tion4s_raw_frame_t<tion4s_turbo_t>;
+  auto *frame = static_cast<const RawTurboFrame *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] Turbo", frame->request_id);
+  this->update_turbo_(frame->data);
+  // time left is counting down while turbo is active
+  if (frame->data.is_active) {
+    this->planner_.invalidate(REQUEST_TURBO);
+  } else {
+    this->planner_.complete(REQUEST_TURBO);
   }
+  if (this->on_turbo_) {
+    this->on_turbo_(frame->data, frame->request_id);
+  }
+}
+
+void Tion4sApi::handle_dev_info_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "Response Device info");
+  this->update_dev_info_(*static_cast<const tion_dev_info_t *>(frame_data));
+  this->planner_.complete(REQUEST_DEV_INFO);
+}
+
 #ifdef TION_ENABLE_SCHEDULER
-  if (frame_type == FRAME_TYPE_TIME_RSP) {
-    using RawTimeFrame = tion4s_raw_frame_t<tion4s_time_t>;
-    if (frame_data_size != sizeof(RawTimeFrame)) {
-      TION_LOGW(TAG, "Incorrect time response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawTimeFrame *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] Time", frame->request_id);
-      if (this->on_time_) {
-        this->on_time_(frame->data.unix_time, frame->request_id);
-      }
-    }
-    return;
+void Tion4sApi::handle_time_rsp_(const void *frame_data, size_t frame_data_size) {
+  using RawTimeFrame = tion4s_raw_frame_t<tion4s_time_t>;
+  auto *frame = static_cast<const RawTimeFrame *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] Time", frame->request_id);
+  if (this->on_time_) {
+    this->on_time_(frame->data.unix_time, frame->request_id);
   }
+}
 
-  if (frame_type == FRAME_TYPE_TIMER_RSP) {
-    using RawTimerFrame = tion4s_raw_frame_t<tion4s_timer_rsp_t>;
-    if (frame_data_size != sizeof(RawTimerFrame)) {
-      TION_LOGW(TAG, "Incorrect timer response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawTimerFrame *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] Timer %u", frame->request_id, frame->data.timer_id);
-      if (this->on_timer_) {
-        this->on_timer_(frame->data.timer_id, frame->data.timer, frame->request_id);
-      }
-    }
-    return;
+void Tion4sApi::handle_timer_rsp_(const void *frame_data, size_t frame_data_size) {
+  using RawTimerFrame = tion4s_raw_frame_t<tion4s_timer_rsp_t>;
+  auto *frame = static_cast<const RawTimerFrame *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] Timer %u", frame->request_id, frame->data.timer_id);
+  if (this->on_timer_) {
+    this->on_timer_(frame->data.timer_id, frame->data.timer, frame->request_id);
   }
+}
 
-  if (frame_type == FRAME_TYPE_TIMERS_STATE_RSP) {
-    using RawTimersStateFrame = tion4s_raw_frame_t<tion4s_timers_state_t>;
-    if (frame_data_size != sizeof(RawTimersStateFrame)) {
-      TION_LOGW(TAG, "Incorrect timers state response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawTimersStateFrame *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] Timers state", frame->request_id);
-      if (this->on_timers_state_) {
-        this->on_timers_state_(frame->data, frame->request_id);
-      }
-    }
-    return;
+void Tion4sApi::handle_timers_state_rsp_(const void *frame_data, size_t frame_data_size) {
+  using RawTimersStateFrame = tion4s_raw_frame_t<tion4s_timers_state_t>;
+  auto *frame = static_cast<const RawTimersStateFrame *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] Timers state", frame->request_id);
+  if (this->on_timers_state_) {
+    this->on_timers_state_(frame->data, frame->request_id);
   }
+}
 #endif
+
 #ifdef TION_ENABLE_DIAGNOSTIC
-  if (frame_type == FRAME_TYPE_ERR_CNT_RSP) {
-    using RawErrorFrame = tion4s_raw_frame_t<tion4s_errors_t>;
-    if (frame_data_size != sizeof(RawErrorFrame)) {
-      TION_LOGW(TAG, "Incorrect error response data size: %zu", frame_data_size);
-    } else {
-      auto *frame = static_cast<const RawErrorFrame *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] Errors", frame->request_id);
-      // this->on_errors(frame->errors, frame->request_id);
-    }
-    return;
-  }
+void Tion4sApi::handle_err_cnt_rsp_(const void *frame_data, size_t frame_data_size) {
+  using RawErrorFrame = tion4s_raw_frame_t<tion4s_errors_t>;
+  auto *frame = static_cast<const RawErrorFrame *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] Errors", frame->request_id);
+  // this->on_errors(frame->errors, frame->request_id);
+}
 
-  if (frame_type == FRAME_TYPE_TEST_RSP) {
-    struct RawTestFrame {
-      uint8_t unknown[440];
-    } PACKED;
-    if (frame_data_size != sizeof(RawTestFrame)) {
-      TION_LOGW(TAG, "Incorrect test response data size: %zu", frame_data_size);
-    } else {
-      TION_LOGD(TAG, "Response Test");
-    }
-    return;
-  }
+void Tion4sApi::handle_test_rsp_(const void *frame_data, size_t frame_data_size) { TION_LOGD(TAG, "Response Test"); }
 #endif
-  TION_LOGW(TAG, "Unsupported frame %04X: %s", frame_type, tion::hex_cstr(frame_data, frame_data_size));
-}
 
 bool Tion4sApi::request_dev_info_() const {
   TION_LOGD(TAG, "Request Device info");
@@ -230,13 +220,13 @@ bool Tion4sApi::request_turbo_() const {
   return this->write_frame(FRAME_TYPE_TURBO_REQ);
 }
 
-bool Tion4sApi::write_state(const TionState &state, uint32_t request_id) const {
+bool Tion4sApi::write_state(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Write state", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tion4s_raw_state_set_req_t req(request_id, state);
+  auto &req = this->make_frame_data_<tion4s_raw_state_set_req_t>(request_id, state);
   TION_DUMP(TAG, "req  : %" PRIu32, req.request_id);
   TION_DUMP(TAG, "power: %s", ONOFF(req.data.power_state));
   TION_DUMP(TAG, "sound: %s", ONOFF(req.data.sound_state));
@@ -251,25 +241,25 @@ bool Tion4sApi::write_state(const TionState &state, uint32_t request_id) const {
   return this->write_frame(FRAME_TYPE_STATE_SET, req);
 }
 
-bool Tion4sApi::reset_filter(const TionState &state, uint32_t request_id) const {
+bool Tion4sApi::reset_filter(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Reset filter", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tion4s_raw_state_set_req_t req(request_id, state);
+  auto &req = this->make_frame_data_<tion4s_raw_state_set_req_t>(request_id, state);
   req.data.filter_reset = true;
   req.data.filter_time = 0;
   return this->write_frame(FRAME_TYPE_STATE_SET, req);
 }
 
-bool Tion4sApi::factory_reset(const TionState &state, uint32_t request_id) const {
+bool Tion4sApi::factory_reset(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Factory reset", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tion4s_raw_state_set_req_t req(request_id, state);
+  auto &req = this->make_frame_data_<tion4s_raw_state_set_req_t>(request_id, state);
   req.data.factory_reset = true;
   return this->write_frame(FRAME_TYPE_STATE_SET, req);
 }
@@ -344,22 +334,23 @@ bool Tion4sApi::request_test() const {
 }
 #endif
 
-bool Tion4sApi::reset_errors(const TionState &state, uint32_t request_id) const {
+bool Tion4sApi::reset_errors(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Errors reset", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tion4s_raw_state_set_req_t req(request_id, state);
+  auto &req = this->make_frame_data_<tion4s_raw_state_set_req_t>(request_id, state);
   req.data.error_reset = true;
   return this->write_frame(FRAME_TYPE_STATE_SET, req);
 }
 
 void Tion4sApi::request_state() {
-  if (this->state_.firmware_version == 0) {
+  const auto now = tion::millis();
+  if (this->planner_.plan(REQUEST_DEV_INFO, now)) {
     this->request_dev_info_();
   }
-  if (this->traits_.supports_boost) {
+  if (this->traits_.supports_boost && this->planner_.plan(REQUEST_TURBO, now)) {
     this->request_turbo_();
   }
   this->request_state_();
@@ -395,6 +386,10 @@ Tion4sApi::Tion4sApi() {
 #ifdef TION_ENABLE_PI_CONTROLLER
   this->traits_.auto_prod = PROD;
 #endif
+
+  this->planner_.set_policy(REQUEST_DEV_INFO, RequestPlanner::ONCE);
+  // turbo may be enabled from the breezer itself, so it is checked on fan speed change and periodically
+  this->planner_.set_policy(REQUEST_TURBO, RequestPlanner::ON_CHANGE, TION_4S_TURBO_REFRESH_INTERVAL);
 }
 
 void Tion4sApi::enable_native_boost_support() { this->traits_.supports_boost = true; }
@@ -405,6 +400,10 @@ void Tion4sApi::update_dev_info_(const tion::tion_dev_info_t &dev_info) {
 }
 
 void Tion4sApi::update_state_(const tion4s_state_t &state) {
+  if (this->state_.fan_speed != state.fan_speed) {
+    this->planner_.invalidate(REQUEST_TURBO);
+  }
+
   this->state_.initialized = true;
 
   this->state_.power_state = state.power_state;
@@ -474,6 +473,7 @@ void Tion4sApi::enable_boost(uint16_t boost_time, tion::TionStateCall *call) {
   if (this->traits_.supports_boost) {
     TION_LOGD(TAG, "Enable native boost: %s", ONOFF(boost_time > 0));
     this->set_turbo(boost_time, ++this->request_id_);
+    this->planner_.invalidate(REQUEST_TURBO);
   } else {
     tion::TionApiBase::enable_boost(boost_time, call);
   }
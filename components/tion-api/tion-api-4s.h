@@ -9,6 +9,7 @@ namespace dentra {
 namespace tion_4s {
 
 class Tion4sApi : public tion::TionApiBase, public tion::TionApiWriter {
+  friend struct tion4s_frame_handlers_t<Tion4sApi>;
   /// Callback listener for response to request_turbo command request.
   using on_turbo_type = std::function<void(const tion4s_turbo_t &turbo, uint32_t request_id)>;
 #ifdef TION_ENABLE_SCHEDULER
@@ -23,14 +24,19 @@ class Tion4sApi : public tion::TionApiBase, public tion::TionApiWriter {
  public:
   Tion4sApi();
 
-  void read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
+  /// Sub-requests sent with the state request, see set_request_policy.
+  enum PlannedRequest : uint8_t { REQUEST_DEV_INFO, REQUEST_TURBO };
+
+  /// @return true if frame was passed to its handler.
+  bool read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
 
   uint16_t get_state_type() const;
+  static tion::TionCommandClass get_command_class(uint16_t frame_type);
 
-  bool write_state(const tion::TionState &state, uint32_t request_id) const;
-  bool reset_filter(const tion::TionState &state, uint32_t request_id = 1) const;
-  bool factory_reset(const tion::TionState &state, uint32_t request_id = 1) const;
-  bool reset_errors(const tion::TionState &state, uint32_t request_id = 1) const;
+  bool write_state(const tion::TionState &state, uint32_t request_id);
+  bool reset_filter(const tion::TionState &state, uint32_t request_id = 1);
+  bool factory_reset(const tion::TionState &state, uint32_t request_id = 1);
+  bool reset_errors(const tion::TionState &state, uint32_t request_id = 1);
 
   /// Callback listener for response to request_turbo command request.
   void set_on_turbo(on_turbo_type &&cb) { this->on_turbo_ = std::move(cb); }
@@ -76,7 +82,11 @@ class Tion4sApi : public tion::TionApiBase, public tion::TionApiWriter {
   void enable_native_boost_support();
   void request_state() override;
   void write_state(tion::TionStateCall *call) override {
-    this->write_state(this->make_write_state_(call), ++this->request_id_);
+    const auto state = this->make_write_state_(call);
+    const auto request_id = ++this->request_id_;
+    if (this->write_state(state, request_id)) {
+      this->track_write_(request_id, state);
+    }
   }
   void reset_filter() override { this->reset_filter(this->state_, ++this->request_id_); }
 
@@ -97,10 +107,31 @@ class Tion4sApi : public tion::TionApiBase, public tion::TionApiWriter {
   bool request_dev_info_() const;
   bool request_state_() const;
 
+  bool resend_state_(const tion::TionState &state, uint32_t request_id) override {
+    return this->write_state(state, request_id);
+  }
+  void restore_dev_info_() override { this->planner_.complete(REQUEST_DEV_INFO); }
+
   void dump_state_(const tion4s_state_t &state) const;
   void update_state_(const tion4s_state_t &state);
   void update_dev_info_(const tion::tion_dev_info_t &dev_info);
   void update_turbo_(const tion4s_turbo_t &turbo);
+
+  void handle_state_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_dev_info_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_turbo_rsp_(const void *frame_data, size_t frame_data_size);
+#ifdef TION_ENABLE_HEARTBEAT
+  void handle_heartbeat_rsp_(const void *frame_data, size_t frame_data_size);
+#endif
+#ifdef TION_ENABLE_SCHEDULER
+  void handle_time_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_timer_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_timers_state_rsp_(const void *frame_data, size_t frame_data_size);
+#endif
+#ifdef TION_ENABLE_DIAGNOSTIC
+  void handle_err_cnt_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_test_rsp_(const void *frame_data, size_t frame_data_size);
+#endif
 };
 
 }  // namespace tion_4s
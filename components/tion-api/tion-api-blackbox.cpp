@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include "log.h"
+#include "utils.h"
+#include "tion-api-blackbox.h"
+
+namespace dentra {
+namespace tion {
+
+// prefix of the record line in the log
+static constexpr char LINE_PREFIX[] = "bb ";
+static constexpr size_t LINE_PREFIX_SIZE = sizeof(LINE_PREFIX) - 1;
+
+const char *TionBlackBoxRecord::get_model_name(Model model) {
+  switch (model) {
+    case MODEL_3S:
+      return "3s";
+    case MODEL_4S:
+      return "4s";
+    case MODEL_LT:
+      return "lt";
+    case MODEL_O2:
+      return "o2";
+    default:
+      return "unknown";
+  }
+}
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+bool TionBlackBoxRecord::parse(const char *line, TionBlackBoxRecord *record, uint8_t *data) {
+  const char *hex = std::strstr(line, LINE_PREFIX);
+  if (hex == nullptr) {
+    return false;
+  }
+  hex += LINE_PREFIX_SIZE;
+  uint8_t buf[sizeof(TionBlackBoxRecord) + DATA_MAX_SIZE];
+  size_t size = 0;
+  for (; size < sizeof(buf); size++) {
+    const int hi = hex_value(hex[size * 2]);
+    const int lo = hi < 0 ? -1 : hex_value(hex[size * 2 + 1]);
+    if (lo < 0) {
+      break;
+    }
+    buf[size] = (hi << 4) | lo;
+  }
+  if (size < sizeof(TionBlackBoxRecord)) {
+    return false;
+  }
+  std::memcpy(record, buf, sizeof(TionBlackBoxRecord));
+  if (record->size > DATA_MAX_SIZE || size != sizeof(TionBlackBoxRecord) + record->size) {
+    return false;
+  }
+  std::memcpy(data, buf + sizeof(TionBlackBoxRecord), record->size);
+  return true;
+}
+
+#ifdef TION_ENABLE_BLACKBOX
+
+TionBlackBox &TionBlackBox::get() {
+  static TionBlackBox blackbox;
+  return blackbox;
+}
+
+void TionBlackBox::record(uint8_t source, bool tx, uint16_t type, const void *data, size_t size) {
+  if (size > TionBlackBoxRecord::DATA_MAX_SIZE) {
+    size = TionBlackBoxRecord::DATA_MAX_SIZE;
+  }
+  const TionBlackBoxRecord record{
+      .time = tion::millis(),
+      .source = static_cast<uint8_t>(tx ? source | TionBlackBoxRecord::SOURCE_TX : source),
+      .type = type,
+      .size = static_cast<uint8_t>(size),
+  };
+  while (SIZE - this->used_ < sizeof(record) + size) {
+    this->drop_();
+  }
+  this->write_(&record, sizeof(record));
+  this->write_(data, size);
+  this->records_++;
+}
+
+void TionBlackBox::write_(const void *data, size_t size) {
+  const size_t first = std::min<size_t>(size, SIZE - this->tail_);
+  std::memcpy(this->buf_ + this->tail_, data, first);
+  std::memcpy(this->buf_, static_cast<const uint8_t *>(data) + first, size - first);
+  this->tail_ = (this->tail_ + size) % SIZE;
+  this->used_ += size;
+}
+
+void TionBlackBox::read_(uint16_t pos, void *data, size_t size) const {
+  const size_t first = std::min<size_t>(size, SIZE - pos);
+  std::memcpy(data, this->buf_ + pos, first);
+  std::memcpy(static_cast<uint8_t *>(data) + first, this->buf_, size - first);
+}
+
+void TionBlackBox::drop_() {
+  TionBlackBoxRecord record;
+  this->read_(this->head_, &record, sizeof(record));
+  const size_t size = sizeof(record) + record.size;
+  this->head_ = (this->head_ + size) % SIZE;
+  this->used_ -= size;
+  this->records_--;
+  this->lost_++;
+}
+
+void TionBlackBox::for_each_line(const line_fn &fn) const {
+  static const char *const HEX = "0123456789ABCDEF";
+  uint8_t buf[sizeof(TionBlackBoxRecord) + TionBlackBoxRecord::DATA_MAX_SIZE];
+  char line[LINE_PREFIX_SIZE + sizeof(buf) * 2 + 1];
+  std::memcpy(line, LINE_PREFIX, LINE_PREFIX_SIZE);
+  uint16_t pos = this->head_;
+  for (uint32_t i = 0; i < this->records_; i++) {
+    auto *record = reinterpret_cast<TionBlackBoxRecord *>(buf);
+    this->read_(pos, record, sizeof(*record));
+    const size_t size = sizeof(*record) + record->size;
+    this->read_(pos, buf, size);
+    pos = (pos + size) % SIZE;
+    char *p = line + LINE_PREFIX_SIZE;
+    for (size_t j = 0; j < size; j++) {
+      *p++ = HEX[buf[j] >> 4];
+      *p++ = HEX[buf[j] & 0x0F];
+    }
+    *p = 0;
+    fn(line);
+  }
+}
+
+void TionBlackBox::dump(const char *tag) const {
+  TION_LOGI(tag, "Black box: %" PRIu32 " records, %" PRIu32 " lost, now %" PRIu32 " ms", this->records_, this->lost_,
+            tion::millis());
+  this->for_each_line([tag](const char *line) { TION_LOGI(tag, "%s", line); });
+}
+
+void TionBlackBox::clear() {
+  this->head_ = 0;
+  this->tail_ = 0;
+  this->used_ = 0;
+  this->records_ = 0;
+  this->lost_ = 0;
+}
+
+#endif  // TION_ENABLE_BLACKBOX
+
+}  // namespace tion
+}  // namespace dentra
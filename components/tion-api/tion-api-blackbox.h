@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Black box of the last frames: compact binary ring buffer of decoded frames sent to and received from breezers.
+// Enabled with TION_ENABLE_BLACKBOX, otherwise probes expand to nothing. Records are dumped to the log as hex lines
+// and decoded on the host with blackbox_decode tool, see tests/blackbox.
+#ifdef TION_ENABLE_BLACKBOX
+#define TION_BLACKBOX_RX(source, type, data, size) \
+  dentra::tion::TionBlackBox::get().record(source, false, type, data, size)
+#define TION_BLACKBOX_TX(source, type, data, size) \
+  dentra::tion::TionBlackBox::get().record(source, true, type, data, size)
+#else
+#define TION_BLACKBOX_RX(source, type, data, size)
+#define TION_BLACKBOX_TX(source, type, data, size)
+#endif
+
+#ifndef TION_BLACKBOX_SIZE
+#define TION_BLACKBOX_SIZE 4096
+#endif
+
+namespace dentra {
+namespace tion {
+
+/// Record of the black box, followed by size bytes of frame data.
+struct TionBlackBoxRecord {
+  enum : uint8_t {
+    // source: 0bDVVVMMMM, D - direction, V - vport type, M - model
+    SOURCE_TX = 0x80,
+    SOURCE_VPORT_SHIFT = 4,
+    SOURCE_VPORT_MASK = 0x07,
+    SOURCE_MODEL_MASK = 0x0F,
+  };
+  // larger frames are truncated, so hex line of the record fits into the log line
+  enum { DATA_MAX_SIZE = 120 };
+  enum Model : uint8_t { MODEL_UNKNOWN = 0, MODEL_3S, MODEL_4S, MODEL_LT, MODEL_O2 };
+
+  // millis of the record
+  uint32_t time;
+  uint8_t source;
+  uint16_t type;
+  // size of the stored frame data
+  uint8_t size;
+
+  bool is_tx() const { return (this->source & SOURCE_TX) != 0; }
+  uint8_t get_vport() const { return (this->source >> SOURCE_VPORT_SHIFT) & SOURCE_VPORT_MASK; }
+  Model get_model() const { return static_cast<Model>(this->source & SOURCE_MODEL_MASK); }
+
+  static uint8_t make_source(uint8_t vport, Model model) {
+    return ((vport & SOURCE_VPORT_MASK) << SOURCE_VPORT_SHIFT) | (model & SOURCE_MODEL_MASK);
+  }
+  static const char *get_model_name(Model model);
+
+  /// Parses hex line of the dump into the record and data of at least DATA_MAX_SIZE bytes.
+  /// @return false if line is not a record of the dump.
+  static bool parse(const char *line, TionBlackBoxRecord *record, uint8_t *data);
+} __attribute__((__packed__));
+
+#ifdef TION_ENABLE_BLACKBOX
+/// Ring buffer of records, the oldest records are overwritten. Frames are recorded from the main loop only.
+class TionBlackBox {
+ public:
+  static constexpr size_t SIZE = TION_BLACKBOX_SIZE;
+  static_assert(SIZE >= sizeof(TionBlackBoxRecord) + TionBlackBoxRecord::DATA_MAX_SIZE && SIZE <= UINT16_MAX,
+                "invalid TION_BLACKBOX_SIZE");
+
+  static TionBlackBox &get();
+
+  /// Copies frame into the buffer, no formatting or allocation is made here.
+  void record(uint8_t source, bool tx, uint16_t type, const void *data, size_t size);
+
+  using line_fn = std::function<void(const char *line)>;
+  /// Calls fn with hex line of every record from the oldest one.
+  void for_each_line(const line_fn &fn) const;
+  /// Logs all records, the log is decoded with blackbox_decode tool.
+  void dump(const char *tag) const;
+
+  void clear();
+
+  uint32_t get_records() const { return this->records_; }
+  /// Number of overwritten records.
+  uint32_t get_lost() const { return this->lost_; }
+
+ protected:
+  uint8_t buf_[SIZE];
+  // offset of the oldest record and the next one to write
+  uint16_t head_{};
+  uint16_t tail_{};
+  uint16_t used_{};
+  uint32_t records_{};
+  uint32_t lost_{};
+
+  void write_(const void *data, size_t size);
+  void read_(uint16_t pos, void *data, size_t size) const;
+  void drop_();
+};
+#endif  // TION_ENABLE_BLACKBOX
+
+}  // namespace tion
+}  // namespace dentra
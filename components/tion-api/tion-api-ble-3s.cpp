@@ -41,16 +41,20 @@ bool Tion3sBleProtocol::read_data(const uint8_t *data, size_t size) {
     TION_LOGW(TAG, "Empty frame data");
     return false;
   }
+  this->stats_.rx_bytes += size;
+  // errors are reported by periodic link summary, see TionLinkStats
   if (size != sizeof(Tion3sRawBleFrame)) {
-    TION_LOGW(TAG, "Invalid frame size %zu", size);
+    TION_LOGV(TAG, "Invalid frame size %zu", size);
+    this->stats_.oversize++;
     return false;
   }
   const auto *frame = reinterpret_cast<const Tion3sRawBleFrame *>(data);
   if (frame->magic != Tion3sRawBleFrame::FRAME_MAGIC) {
-    TION_LOGW(TAG, "Invalid frame magic %02X", frame->magic);
+    TION_LOGV(TAG, "Invalid frame magic %02X", frame->magic);
+    this->stats_.bad_magic++;
     return false;
   }
-  this->reader_(*reinterpret_cast<const tion_any_frame_t *>(&frame->data), sizeof(frame->data));
+  this->read_frame_data_(*reinterpret_cast<const tion_any_frame_t *>(&frame->data), sizeof(frame->data));
   return true;
 }
 
@@ -63,7 +67,7 @@ bool Tion3sBleProtocol::write_frame(uint16_t frame_type, const void *frame_data,
   if (frame_data_size <= sizeof(frame.data.data)) {
     std::memcpy(frame.data.data, frame_data, frame_data_size);
   }
-  return this->writer_(reinterpret_cast<const uint8_t *>(&frame), sizeof(frame));
+  return this->write_frame_data_(reinterpret_cast<const uint8_t *>(&frame), sizeof(frame));
 }
 
 }  // namespace tion
@@ -39,6 +39,9 @@ struct TionLtRawBleFrame {
 };
 #pragma pack(pop)
 
+static_assert(sizeof(TionLtRawBleFrame) + TionLtBleProtocol::FRAME_DATA_MAX_SIZE == TionLtBleProtocol::FRAME_MAX_SIZE,
+              "FRAME_MAX_SIZE must match raw frame layout");
+
 const char *TionLtBleProtocol::get_ble_service() const { return "98f00001-3788-83ea-453e-f52244709ddb"; }
 const char *TionLtBleProtocol::get_ble_char_tx() const { return "98f00002-3788-83ea-453e-f52244709ddb"; };
 const char *TionLtBleProtocol::get_ble_char_rx() const { return "98f00003-3788-83ea-453e-f52244709ddb"; }
@@ -49,68 +52,103 @@ bool TionLtBleProtocol::read_data(const uint8_t *data, size_t size) {
     TION_LOGW(TAG, "Packet is empty");
     return false;
   }
+  this->stats_.rx_bytes += size;
 
   auto *pkt = reinterpret_cast<const TionLtRawBlePacket *>(data);
   auto data_size = size - sizeof(pkt->type);
 
   if (pkt->type == TionLtRawBlePacket::TYPE_LONE) {
     TION_LOGV(TAG, "Packet LONE");
-    this->read_frame_(pkt->data, data_size);
+    const uint16_t crc = this->rx_crc_ ? crc16_ccitt_false_ffff(pkt->data, data_size) : 0;
+    this->read_frame_(pkt->data, data_size, crc);
     return true;
   }
 
   if (pkt->type == TionLtRawBlePacket::TYPE_FRST) {
     TION_LOGV(TAG, "Packet FRST");
-    this->rx_buf_.clear();
-    this->rx_buf_.insert(this->rx_buf_.end(), pkt->data, pkt->data + data_size);
-    return true;
-  }
-
-  if (pkt->type == TionLtRawBlePacket::TYPE_CURR) {
-    TION_LOGV(TAG, "Packet CURR");
-    this->rx_buf_.insert(this->rx_buf_.end(), pkt->data, pkt->data + data_size);
-    return true;
+    if (this->rx_size_ != 0) {
+      // errors are reported by periodic link summary, see TionLinkStats
+      TION_LOGV(TAG, "Incomplete frame dropped: %zu bytes", this->rx_size_);
+      this->stats_.resyncs++;
+    }
+    this->rx_size_ = 0;
+    this->rx_crc_state_ = 0xFFFF;
+    return this->rx_append_(pkt->data, data_size);
   }
 
-  if (pkt->type == TionLtRawBlePacket::TYPE_LAST) {
-    TION_LOGV(TAG, "Packet LAST");
-    this->rx_buf_.insert(rx_buf_.end(), pkt->data, pkt->data + data_size);
-    this->read_frame_(this->rx_buf_.data(), this->rx_buf_.size());
-    this->rx_buf_.clear();
-    this->rx_buf_.shrink_to_fit();
+  if (pkt->type == TionLtRawBlePacket::TYPE_CURR || pkt->type == TionLtRawBlePacket::TYPE_LAST) {
+    const bool last = pkt->type == TionLtRawBlePacket::TYPE_LAST;
+    TION_LOGV(TAG, "Packet %s", last ? "LAST" : "CURR");
+    if (this->rx_size_ == 0) {
+      TION_LOGV(TAG, "Unexpected packet 0x%02X without FRST", pkt->type);
+      this->stats_.resyncs++;
+      return false;
+    }
+    if (!this->rx_append_(pkt->data, data_size)) {
+      return false;
+    }
+    if (last) {
+      this->read_frame_(this->rx_buf_, this->rx_size_, this->rx_crc_state_);
+      this->rx_size_ = 0;
+    }
     return true;
   }
 
-  TION_LOGW(TAG, "Unknown packet type 0x%02X", pkt->type);
+  TION_LOGV(TAG, "Unknown packet type 0x%02X", pkt->type);
+  this->stats_.bad_magic++;
   return false;
 }
 
+bool TionLtBleProtocol::rx_append_(const uint8_t *data, size_t size) {
+  if (this->rx_size_ + size > sizeof(this->rx_buf_)) {
+    TION_LOGV(TAG, "Frame is too large: %zu", this->rx_size_ + size);
+    this->stats_.oversize++;
+    this->rx_size_ = 0;
+    return false;
+  }
+  std::memcpy(this->rx_buf_ + this->rx_size_, data, size);
+  this->rx_size_ += size;
+  if (this->rx_crc_) {
+    this->rx_crc_state_ = crc16_update(this->rx_crc_state_, data, size);
+  }
+  return true;
+}
+
 // TODO remove return type
-bool TionLtBleProtocol::read_frame_(const void *data, uint32_t size) {
+bool TionLtBleProtocol::read_frame_(const void *data, uint32_t size, uint16_t crc) {
   TION_LOGV(TAG, "Read frame: %s", hex_cstr(data, size));
   if (!this->reader_) {
     TION_LOGE(TAG, "Reader is not configured");
     return false;
   }
 
+  if (size < sizeof(TionLtRawBleFrame)) {
+    TION_LOGV(TAG, "Frame is too short: %" PRIu32, size);
+    this->stats_.oversize++;
+    return false;
+  }
+
   const TionLtRawBleFrame *frame = static_cast<const TionLtRawBleFrame *>(data);
   if (frame->magic != TionLtRawBleFrame::FRAME_MAGIC) {
-    TION_LOGW(TAG, "Invalid frame magic: 0x%02X", frame->magic);
+    TION_LOGV(TAG, "Invalid frame magic: 0x%02X", frame->magic);
+    this->stats_.bad_magic++;
     return false;
   }
   if (frame->size != size) {
-    TION_LOGW(TAG, "Invalid frame size: %u", frame->size);
+    TION_LOGV(TAG, "Invalid frame size: %u", frame->size);
+    this->stats_.oversize++;
     return false;
   }
   if (this->rx_crc_) {
-    const uint16_t crc = crc16_ccitt_false_ffff(frame, size);
+    // crc over the whole frame including its crc must be zero
     if (crc != 0) {
-      TION_LOGW(TAG, "Invalid frame crc: %04X", crc);
+      TION_LOGV(TAG, "Invalid frame crc: %04X", crc);
+      this->stats_.crc_errors++;
       return false;
     }
   }
-  this->reader_(*reinterpret_cast<const tion_any_ble_frame_t *>(&frame->data),
-                frame->size - sizeof(TionLtRawBleFrame) + sizeof(tion_any_ble_frame_t));
+  this->read_frame_data_(*reinterpret_cast<const tion_any_ble_frame_t *>(&frame->data),
+                         frame->size - sizeof(TionLtRawBleFrame) + sizeof(tion_any_ble_frame_t));
   return true;
 }
 
@@ -130,6 +168,9 @@ bool TionLtBleProtocol::write_frame(uint16_t frame_type, const void *frame_data,
   uint16_t crc = __builtin_bswap16(crc16_ccitt_false_ffff(tx_frame, sizeof(tx_buf) - sizeof(crc)));
   std::memcpy(&tx_frame->data.data[frame_data_size], &crc, sizeof(crc));
 
+  // frame is split into several packets, so it is counted here instead of the writer
+  this->stats_.tx_frames++;
+  this->stats_.tx_bytes += sizeof(tx_buf);
   return this->write_packet_(tx_frame, sizeof(tx_buf));
 }
 
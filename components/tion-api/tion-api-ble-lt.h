@@ -17,12 +17,25 @@ class TionLtBleProtocol : public TionProtocol<tion_any_ble_frame_t> {
   const char *get_ble_char_tx() const;
   const char *get_ble_char_rx() const;
 
+  enum {
+    // Largest known frame data size, 4S TEST response.
+    FRAME_DATA_MAX_SIZE = 440,
+    // Frame size, magic, random and crc around tion_any_ble_frame_t head.
+    FRAME_MAX_SIZE = sizeof(uint16_t) + sizeof(uint8_t) * 2 + tion_any_ble_frame_t::head_size() +
+                     FRAME_DATA_MAX_SIZE + sizeof(uint16_t),
+  };
+
  protected:
   bool rx_crc_;
-  std::vector<uint8_t> rx_buf_;
+  // Reassembly buffer for FRST/CURR/LAST packets, rx_size_ is 0 when no frame is in progress.
+  uint8_t rx_buf_[FRAME_MAX_SIZE];
+  size_t rx_size_{};
+  // CRC state of received data, updated with every packet.
+  uint16_t rx_crc_state_{};
 
   bool write_packet_(const void *data, uint16_t size) const;
-  bool read_frame_(const void *data, uint32_t size);
+  bool read_frame_(const void *data, uint32_t size, uint16_t crc);
+  bool rx_append_(const uint8_t *data, size_t size);
 };
 
 }  // namespace tion
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace dentra {
+namespace tion {
+
+/// Class of the command frame, lower value means higher priority.
+enum class TionCommandClass : uint8_t {
+  /// Changes state of the breezer, never coalesced.
+  CONTROL = 0,
+  /// Requests state, repeated request replaces the queued one.
+  STATE = 1,
+  /// Keeps the link or display alive, repeated frame replaces the queued one.
+  KEEPALIVE = 2,
+  /// Requests additional data, repeated request with the same data is coalesced.
+  DIAGNOSTIC = 3,
+};
+
+/// Bounded queue of command frames waiting for transmission. Frames are sent by strict priority of their class
+/// and in order within the class. On overflow the newest frame of the lowest class is evicted if it is lower than
+/// the incoming one, otherwise the incoming frame is dropped.
+template<size_t capacity, size_t data_max_size> class TionCommandQueue {
+ public:
+  enum { CAPACITY = capacity, CLASSES = 4 };
+
+  struct Command {
+    uint16_t type;
+    TionCommandClass cls;
+    uint8_t size;
+    // 0 means free slot, otherwise order of the push.
+    uint32_t seq;
+    uint8_t data[data_max_size];
+  };
+
+  bool empty() const { return this->size_ == 0; }
+  size_t size() const { return this->size_; }
+
+  /// Maximum number of queued frames.
+  size_t get_high_water() const { return this->high_water_; }
+  /// Maximum number of queued frames of the class.
+  size_t get_high_water(TionCommandClass cls) const { return this->class_high_water_[static_cast<size_t>(cls)]; }
+  /// Number of dropped or evicted frames.
+  uint32_t get_dropped() const { return this->dropped_; }
+  /// Number of frames replaced by the newer ones in place.
+  uint32_t get_coalesced() const { return this->coalesced_; }
+
+  /// @return false if the frame is dropped.
+  bool push(uint16_t type, TionCommandClass cls, const void *data, size_t size) {
+    if (size > data_max_size) {
+      return false;
+    }
+    Command *free{}, *victim{};
+    for (auto &cmd : this->commands_) {
+      if (cmd.seq == 0) {
+        free = free ? free : &cmd;
+        continue;
+      }
+      if (cmd.type == type && is_coalesced_(cmd, cls, data, size)) {
+        this->set_data_(cmd, data, size);
+        this->coalesced_++;
+        return true;
+      }
+      if (cmd.cls > cls && (victim == nullptr || cmd.cls > victim->cls ||
+                            (cmd.cls == victim->cls && int32_t(cmd.seq - victim->seq) > 0))) {
+        victim = &cmd;
+      }
+    }
+    if (free == nullptr) {
+      this->dropped_++;
+      if (victim == nullptr) {
+        return false;
+      }
+      this->remove_(*victim);
+      free = victim;
+    }
+    // 0 is reserved for free slot
+    if (++this->seq_ == 0) {
+      ++this->seq_;
+    }
+    free->type = type;
+    free->cls = cls;
+    free->seq = this->seq_;
+    this->set_data_(*free, data, size);
+    this->add_(cls);
+    return true;
+  }
+
+  /// @return command with the highest priority, queue must not be empty.
+  const Command &front() const {
+    const Command *res{};
+    for (auto &cmd : this->commands_) {
+      if (cmd.seq != 0 &&
+          (res == nullptr || cmd.cls < res->cls || (cmd.cls == res->cls && int32_t(cmd.seq - res->seq) < 0))) {
+        res = &cmd;
+      }
+    }
+    return *res;
+  }
+
+  void pop() {
+    if (this->size_ != 0) {
+      this->remove_(const_cast<Command &>(this->front()));
+    }
+  }
+
+ protected:
+  Command commands_[capacity]{};
+  size_t size_{};
+  size_t class_size_[CLASSES]{};
+  size_t high_water_{};
+  size_t class_high_water_[CLASSES]{};
+  uint32_t seq_{};
+  uint32_t dropped_{};
+  uint32_t coalesced_{};
+
+  static bool is_coalesced_(const Command &cmd, TionCommandClass cls, const void *data, size_t size) {
+    switch (cls) {
+      case TionCommandClass::STATE:
+      case TionCommandClass::KEEPALIVE:
+        return true;
+      case TionCommandClass::DIAGNOSTIC:
+        return cmd.size == size && (size == 0 || std::memcmp(cmd.data, data, size) == 0);
+      default:
+        return false;
+    }
+  }
+
+  static void set_data_(Command &cmd, const void *data, size_t size) {
+    cmd.size = size;
+    if (size > 0) {
+      std::memcpy(cmd.data, data, size);
+    }
+  }
+
+  void add_(TionCommandClass cls) {
+    const auto idx = static_cast<size_t>(cls);
+    this->size_++;
+    this->class_size_[idx]++;
+    if (this->size_ > this->high_water_) {
+      this->high_water_ = this->size_;
+    }
+    if (this->class_size_[idx] > this->class_high_water_[idx]) {
+      this->class_high_water_[idx] = this->class_size_[idx];
+    }
+  }
+
+  void remove_(Command &cmd) {
+    this->size_--;
+    this->class_size_[static_cast<size_t>(cmd.cls)]--;
+    cmd.seq = 0;
+  }
+};
+
+}  // namespace tion
+}  // namespace dentra
@@ -26,6 +26,37 @@
 #define TION_MIN_TEMPERATURE TION_DEFAULT_MIN_TEMPERATURE
 #endif
 
+// Максимальное количество запросов записи ожидающих подтверждения.
+#ifndef TION_MAX_PENDING_REQUESTS
+#define TION_MAX_PENDING_REQUESTS 4
+#endif
+
+// Размер очереди команд, ожидающих отправки бризеру.
+#ifndef TION_COMMAND_QUEUE_SIZE
+#define TION_COMMAND_QUEUE_SIZE 8
+#endif
+
+// Время после загрузки (мс), в течение которого отсутствие ответа бризера не сбрасывает
+// сохраненное состояние.
+#ifndef TION_SNAPSHOT_TIMEOUT
+#define TION_SNAPSHOT_TIMEOUT (30 * 1000)
+#endif
+
+// Максимальное количество дополнительных запросов, отправляемых вместе с запросом состояния.
+#ifndef TION_MAX_PLANNED_REQUESTS
+#define TION_MAX_PLANNED_REQUESTS 4
+#endif
+
+// Период обновления состояния турбо режима 4s, когда он не активен (мс).
+#ifndef TION_4S_TURBO_REFRESH_INTERVAL
+#define TION_4S_TURBO_REFRESH_INTERVAL (10 * 60 * 1000)
+#endif
+
+// Период обновления режима управления O2, если состояние не меняется (мс).
+#ifndef TION_O2_DEV_MODE_REFRESH_INTERVAL
+#define TION_O2_DEV_MODE_REFRESH_INTERVAL (5 * 60 * 1000)
+#endif
+
 #define TION__HEAT_POWER_TO_CONST(x) (x / 10u)
 #define TION__HEAT_CONST_TO_POWER(x) (x * 10u)
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>  // std::memcpy
+#include <new>
+#include <utility>
+
+namespace dentra {
+namespace tion {
+
+/// Transmit frame buffer with room reserved before frame data.
+/// Frame data is serialized in place once, then transport head is added before it without moving data.
+template<size_t head_room, size_t data_max_size> class TionFrameBuilder {
+ public:
+  enum { HEAD_ROOM = head_room, DATA_MAX_SIZE = data_max_size };
+
+  uint8_t *data() { return this->buf_ + HEAD_ROOM; }
+  const uint8_t *data() const { return this->buf_ + HEAD_ROOM; }
+  size_t data_size() const { return this->data_size_; }
+
+  /// Returns true if ptr points to the frame data of this builder.
+  bool is_data(const void *ptr) const { return ptr == this->data(); }
+
+  /// Constructs frame data struct in place and drops previously added head.
+  template<class T, class... Args> T &emplace(Args &&...args) {
+    static_assert(sizeof(T) <= DATA_MAX_SIZE, "frame data is too large for the builder");
+    this->reset_(sizeof(T));
+    return *new (this->data()) T(std::forward<Args>(args)...);
+  }
+
+  /// Sets frame data, copies it only if it is not already in place.
+  bool set_data(const void *data, size_t size) {
+    if (size > DATA_MAX_SIZE) {
+      return false;
+    }
+    if (size > 0 && !this->is_data(data)) {
+      std::memcpy(this->data(), data, size);
+    }
+    this->reset_(size);
+    return true;
+  }
+
+  /// Reserves size bytes right before the frame (data or previously pushed head).
+  /// @return pointer to the reserved head or nullptr if there is no room.
+  uint8_t *push_head(size_t size) {
+    if (this->head_size_ + size > HEAD_ROOM) {
+      return nullptr;
+    }
+    this->head_size_ += size;
+    return this->frame_();
+  }
+
+  /// Whole frame: pushed head and data.
+  const uint8_t *frame() const { return this->data() - this->head_size_; }
+  size_t frame_size() const { return this->head_size_ + this->data_size_; }
+
+ protected:
+  uint8_t buf_[HEAD_ROOM + DATA_MAX_SIZE];
+  size_t data_size_{};
+  size_t head_size_{};
+
+  uint8_t *frame_() { return this->data() - this->head_size_; }
+  void reset_(size_t data_size) {
+    this->data_size_ = data_size;
+    this->head_size_ = 0;
+  }
+};
+
+}  // namespace tion
+}  // namespace dentra
@@ -72,5 +72,48 @@ template<size_t _AK> struct tion_state_counters_t {
 
 #pragma pack(pop)
 
+/// Frame dispatch table entry.
+// NOLINTNEXTLINE(readability-identifier-naming)
+template<class api_t> struct tion_frame_handler_t {
+  using handler_type = void (api_t::*)(const void *frame_data, size_t frame_data_size);
+  enum : uint16_t { ANY_SIZE = 0xFFFF };
+  /// Frame type.
+  uint16_t type;
+  /// Expected frame data size or ANY_SIZE.
+  uint16_t size;
+  /// Frame name used in logs.
+  const char *name;
+  handler_type handler;
+
+  bool check_size(size_t frame_data_size) const { return this->size == ANY_SIZE || this->size == frame_data_size; }
+};
+
+/// Checks at compile time that frame handlers are sorted by type and types are unique.
+template<class handler_t, size_t N> constexpr bool is_frame_handlers_sorted(const handler_t (&handlers)[N]) {
+  for (size_t i = 1; i < N; i++) {
+    if (handlers[i - 1].type >= handlers[i].type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Binary search of frame handler in the sorted table.
+/// @return frame handler or nullptr if frame type is not supported.
+template<class handler_t, size_t N>
+const handler_t *find_frame_handler(const handler_t (&handlers)[N], uint16_t frame_type) {
+  size_t lo = 0;
+  size_t hi = N;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    if (handlers[mid].type < frame_type) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < N && handlers[lo].type == frame_type ? &handlers[lo] : nullptr;
+}
+
 }  // namespace tion
 }  // namespace dentra
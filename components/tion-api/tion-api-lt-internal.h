@@ -197,5 +197,17 @@ struct tionlt_state_set_req_t {
 
 #pragma pack(pop)
 
+/// Response frame handlers of TionLtApi sorted by frame type.
+// NOLINTNEXTLINE(readability-identifier-naming)
+template<class api_t> struct tionlt_frame_handlers_t {
+  using handler_type = tion::tion_frame_handler_t<api_t>;
+  static constexpr handler_type HANDLERS[] = {
+      {FRAME_TYPE_STATE_RSP, sizeof(tionlt_state_get_req_t), "state", &api_t::handle_state_rsp_},
+      {FRAME_TYPE_AUTOKIV_PARAM_RSP, handler_type::ANY_SIZE, "auto kiv param", &api_t::handle_autokiv_param_rsp_},
+      {FRAME_TYPE_DEV_INFO_RSP, sizeof(tion::tion_dev_info_t), "device info", &api_t::handle_dev_info_rsp_},
+  };
+  static_assert(tion::is_frame_handlers_sorted(HANDLERS), "lt frame handlers must be sorted by type");
+};
+
 }  // namespace tion_lt
 }  // namespace dentra
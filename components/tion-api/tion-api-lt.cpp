@@ -91,37 +91,48 @@ static const uint8_t PROD[] = {0, TION_LT_AUTO_PROD};
 
 uint16_t TionLtApi::get_state_type() const { return FRAME_TYPE_STATE_RSP; }
 
-void TionLtApi::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
-  // do not use switch statement with non-contiguous values, as this will generate a lookup table with wasted space.
-  if (frame_type == FRAME_TYPE_STATE_RSP) {
-    // NOLINTNEXTLINE(readability-identifier-naming)
-    if (frame_data_size != sizeof(tionlt_state_get_req_t)) {
-      TION_LOGW(TAG, "Incorrect state response data size: %zu", frame_data_size);
-    } else {
-      const auto *frame = static_cast<const tionlt_state_get_req_t *>(frame_data);
-      TION_LOGD(TAG, "Response[%" PRIu32 "] State", frame->request_id);
-      this->update_state_(frame->state);
-      this->notify_state_(frame->request_id);
-    }
-    return;
+TionCommandClass TionLtApi::get_command_class(uint16_t frame_type) {
+  switch (frame_type) {
+    case FRAME_TYPE_STATE_REQ:
+    case FRAME_TYPE_DEV_INFO_REQ:
+      return TionCommandClass::STATE;
+    case FRAME_TYPE_AUTOKIV_PARAM_REQ:
+    case FRAME_TYPE_TEST_REQ:
+      return TionCommandClass::DIAGNOSTIC;
+    default:
+      return TionCommandClass::CONTROL;
   }
+}
 
-  if (frame_type == FRAME_TYPE_DEV_INFO_RSP) {
-    if (frame_data_size != sizeof(tion_dev_info_t)) {
-      TION_LOGW(TAG, "Incorrect device info response data: %s", hex_cstr(frame_data, frame_data_size));
-    } else {
-      TION_LOGD(TAG, "Response Device info");
-      this->update_dev_info_(*static_cast<const tion_dev_info_t *>(frame_data));
-    }
-    return;
+bool TionLtApi::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
+  const auto *handler = find_frame_handler(tionlt_frame_handlers_t<TionLtApi>::HANDLERS, frame_type);
+  if (handler == nullptr) {
+    TION_LOGW(TAG, "Unsupported frame type 0x%04X: %s", frame_type, hex_cstr(frame_data, frame_data_size));
+    return false;
   }
-
-  if (frame_type == FRAME_TYPE_AUTOKIV_PARAM_RSP) {
-    TION_LOGD(TAG, "auto kiv param response: %s", hex_cstr(frame_data, frame_data_size));
-    return;
+  if (!handler->check_size(frame_data_size)) {
+    TION_LOGW(TAG, "Incorrect %s response data: %s", handler->name, hex_cstr(frame_data, frame_data_size));
+    return false;
   }
+  (this->*handler->handler)(frame_data, frame_data_size);
+  return true;
+}
 
-  TION_LOGW(TAG, "Unsupported frame type 0x%04X: %s", frame_type, hex_cstr(frame_data, frame_data_size));
+void TionLtApi::handle_state_rsp_(const void *frame_data, size_t frame_data_size) {
+  const auto *frame = static_cast<const tionlt_state_get_req_t *>(frame_data);
+  TION_LOGD(TAG, "Response[%" PRIu32 "] State", frame->request_id);
+  this->update_state_(frame->state);
+  this->notify_state_(frame->request_id);
+}
+
+void TionLtApi::handle_dev_info_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "Response Device info");
+  this->update_dev_info_(*static_cast<const tion_dev_info_t *>(frame_data));
+  this->planner_.complete(REQUEST_DEV_INFO);
+}
+
+void TionLtApi::handle_autokiv_param_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "auto kiv param response: %s", hex_cstr(frame_data, frame_data_size));
 }
 
 bool TionLtApi::request_dev_info_() const {
@@ -134,13 +145,13 @@ bool TionLtApi::request_state_() const {
   return this->write_frame(FRAME_TYPE_STATE_REQ);
 }
 
-bool TionLtApi::write_state(const TionState &state, uint32_t request_id) const {
+bool TionLtApi::write_state(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Write state", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tionlt_state_set_req_t st_set(state, this->button_presets_, request_id);
+  auto &st_set = this->make_frame_data_<tionlt_state_set_req_t>(state, this->button_presets_, request_id);
   this->fix_st_set_(&st_set);
   TION_DUMP(TAG, "req  : %" PRIu32, st_set.request_id);
   TION_DUMP(TAG, "power: %s", ONOFF(st_set.data.power_state));
@@ -158,38 +169,38 @@ bool TionLtApi::write_state(const TionState &state, uint32_t request_id) const {
   return this->write_frame(FRAME_TYPE_STATE_SET, st_set);
 }
 
-bool TionLtApi::reset_filter(const TionState &state, uint32_t request_id) const {
+bool TionLtApi::reset_filter(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Reset filter", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tionlt_state_set_req_t st_set(state, this->button_presets_, request_id);
+  auto &st_set = this->make_frame_data_<tionlt_state_set_req_t>(state, this->button_presets_, request_id);
   st_set.data.filter_reset = true;
   st_set.data.filter_time = 181;
   this->fix_st_set_(&st_set);
   return this->write_frame(FRAME_TYPE_STATE_SET, st_set);
 }
 
-bool TionLtApi::factory_reset(const TionState &state, uint32_t request_id) const {
+bool TionLtApi::factory_reset(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Factory reset", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tionlt_state_set_req_t st_set(state, this->button_presets_, request_id);
+  auto &st_set = this->make_frame_data_<tionlt_state_set_req_t>(state, this->button_presets_, request_id);
   st_set.data.factory_reset = true;
   this->fix_st_set_(&st_set);
   return this->write_frame(FRAME_TYPE_STATE_SET, st_set);
 }
 
-bool TionLtApi::reset_errors(const TionState &state, uint32_t request_id) const {
+bool TionLtApi::reset_errors(const TionState &state, uint32_t request_id) {
   TION_LOGD(TAG, "Request[%" PRIu32 "] Error reset", request_id);
   if (!state.is_initialized()) {
     TION_LOGW(TAG, "State was not initialized");
     return false;
   }
-  tionlt_state_set_req_t st_set(state, this->button_presets_, request_id);
+  auto &st_set = this->make_frame_data_<tionlt_state_set_req_t>(state, this->button_presets_, request_id);
   st_set.data.error_reset = true;
   this->fix_st_set_(&st_set);
   return this->write_frame(FRAME_TYPE_STATE_SET, st_set);
@@ -202,7 +213,7 @@ void TionLtApi::fix_st_set_(tionlt_state_set_req_t *set) const {
 }
 
 void TionLtApi::request_state() {
-  if (this->state_.firmware_version == 0) {
+  if (this->planner_.plan(REQUEST_DEV_INFO, tion::millis())) {
     this->request_dev_info_();
   }
   this->request_state_();
@@ -236,6 +247,8 @@ TionLtApi::TionLtApi() {
 #ifdef TION_ENABLE_PI_CONTROLLER
   this->traits_.auto_prod = PROD;
 #endif
+
+  this->planner_.set_policy(REQUEST_DEV_INFO, RequestPlanner::ONCE);
 }
 
 void TionLtApi::update_dev_info_(const tion::tion_dev_info_t &dev_info) {
@@ -10,21 +10,32 @@ namespace dentra {
 namespace tion {
 
 class TionLtApi : public TionApiBase, public tion::TionApiWriter {
+  friend struct tion_lt::tionlt_frame_handlers_t<TionLtApi>;
+
  public:
   TionLtApi();
 
-  void read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
+  /// Sub-requests sent with the state request, see set_request_policy.
+  enum PlannedRequest : uint8_t { REQUEST_DEV_INFO };
+
+  /// @return true if frame was passed to its handler.
+  bool read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
 
   uint16_t get_state_type() const;
+  static TionCommandClass get_command_class(uint16_t frame_type);
 
-  bool write_state(const TionState &state, uint32_t request_id) const;
-  bool reset_filter(const TionState &state, uint32_t request_id = 1) const;
-  bool factory_reset(const TionState &state, uint32_t request_id = 1) const;
-  bool reset_errors(const TionState &state, uint32_t request_id = 1) const;
+  bool write_state(const TionState &state, uint32_t request_id);
+  bool reset_filter(const TionState &state, uint32_t request_id = 1);
+  bool factory_reset(const TionState &state, uint32_t request_id = 1);
+  bool reset_errors(const TionState &state, uint32_t request_id = 1);
 
   void request_state() override;
   void write_state(TionStateCall *call) override {
-    this->write_state(this->make_write_state_(call), ++this->request_id_);
+    const auto state = this->make_write_state_(call);
+    const auto request_id = ++this->request_id_;
+    if (this->write_state(state, request_id)) {
+      this->track_write_(request_id, state);
+    }
   }
   void reset_filter() override { this->reset_filter(this->state_, ++this->request_id_); }
 
@@ -55,11 +66,20 @@ class TionLtApi : public TionApiBase, public tion::TionApiWriter {
   bool request_dev_info_() const;
   bool request_state_() const;
 
+  bool resend_state_(const TionState &state, uint32_t request_id) override {
+    return this->write_state(state, request_id);
+  }
+  void restore_dev_info_() override { this->planner_.complete(REQUEST_DEV_INFO); }
+
   void dump_state_(const tion_lt::tionlt_state_t &state) const;
   void update_state_(const tion_lt::tionlt_state_t &state);
   void update_dev_info_(const tion::tion_dev_info_t &dev_info);
 
   void fix_st_set_(tion_lt::tionlt_state_set_req_t *set) const;
+
+  void handle_state_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_dev_info_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_autokiv_param_rsp_(const void *frame_data, size_t frame_data_size);
 };
 
 }  // namespace tion
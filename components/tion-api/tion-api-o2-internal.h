@@ -176,5 +176,20 @@ struct WorkModeFlags {
 
 #pragma pack(pop)
 
+/// Response frame handlers of TionO2Api sorted by frame type.
+// NOLINTNEXTLINE(readability-identifier-naming)
+template<class api_t> struct tiono2_frame_handlers_t {
+  using handler_type = tion::tion_frame_handler_t<api_t>;
+  static constexpr handler_type HANDLERS[] = {
+      {FRAME_TYPE_CONNECT_RSP, 4, "connect", &api_t::handle_connect_rsp_},
+      {FRAME_TYPE_STATE_GET_RSP, sizeof(tiono2_state_t), "state", &api_t::handle_state_rsp_},
+      {FRAME_TYPE_DEV_MODE_RSP, sizeof(DevModeFlags), "dev mode", &api_t::handle_dev_mode_rsp_},
+      {FRAME_TYPE_TIME_GET_RSP, sizeof(tiono2_time_t), "time", &api_t::handle_time_rsp_},
+      {FRAME_TYPE_DEV_INFO_RSP, sizeof(tiono2_dev_info_t), "device info", &api_t::handle_dev_info_rsp_},
+      {FRAME_TYPE_SET_WORK_MODE_RSP, 0, "work mode", &api_t::handle_work_mode_rsp_},
+  };
+  static_assert(tion::is_frame_handlers_sorted(HANDLERS), "o2 frame handlers must be sorted by type");
+};
+
 }  // namespace tion_o2
 }  // namespace dentra
@@ -168,56 +168,80 @@ size_t get_rsp_frame_size(uint8_t frame_type) {
   return 0;
 }
 
-void TionO2Api::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
-  if (frame_type == FRAME_TYPE_STATE_GET_RSP) {
-    TION_LOGD(TAG, "Response State Get");
-    auto *frame = static_cast<const tiono2_state_t *>(frame_data);
-    this->update_state_(*frame);
-    this->notify_state_(0);
-    return;
+TionCommandClass TionO2Api::get_command_class(uint16_t frame_type) {
+  switch (frame_type) {
+    case FRAME_TYPE_STATE_GET_REQ:
+    case FRAME_TYPE_DEV_MODE_REQ:
+    case FRAME_TYPE_DEV_INFO_REQ:
+      return TionCommandClass::STATE;
+    // work mode is repeated to keep the display mode
+    case FRAME_TYPE_SET_WORK_MODE_REQ:
+      return TionCommandClass::KEEPALIVE;
+    case FRAME_TYPE_TIME_GET_REQ:
+      return TionCommandClass::DIAGNOSTIC;
+    default:
+      return TionCommandClass::CONTROL;
   }
+}
 
-  if (frame_type == FRAME_TYPE_DEV_MODE_RSP) {
-    // 13 00 EC
-    struct RawDevModeFrame {
-      union {
-        DevModeFlags dev_mode;
-        uint8_t data;
-      };
-    } PACKED;
-    auto *frame = static_cast<const RawDevModeFrame *>(frame_data);
-    TION_LOGD(TAG, "Response Dev mode: %s", tion::get_flag_bits(frame->data));
-    this->update_dev_mode_(frame->dev_mode);
-    return;
+bool TionO2Api::read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
+  const auto *handler = find_frame_handler(tiono2_frame_handlers_t<TionO2Api>::HANDLERS, frame_type);
+  if (handler == nullptr) {
+    TION_LOGW(TAG, "Unsupported frame %02X: %s", frame_type, hex_cstr(frame_data, frame_data_size));
+    return false;
   }
-
-  if (frame_type == FRAME_TYPE_SET_WORK_MODE_RSP) {
-    // 55 AA
-    TION_LOGV(TAG, "Response Work Mode");
-    return;
+  if (!handler->check_size(frame_data_size)) {
+    TION_LOGW(TAG, "Incorrect %s response data size: %zu", handler->name, frame_data_size);
+    return false;
   }
+  (this->*handler->handler)(frame_data, frame_data_size);
+  return true;
+}
 
-  if (frame_type == FRAME_TYPE_DEV_INFO_RSP) {
-    // 17 04 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 08 61 0E 13 04 10 EC 19 79
-    TION_LOGD(TAG, "Response Device info: %s", hex_cstr(frame_data, frame_data_size));
-    this->update_dev_info_(*static_cast<const tiono2_dev_info_t *>(frame_data));
-    return;
-  }
+void TionO2Api::handle_state_rsp_(const void *frame_data, size_t frame_data_size) {
+  TION_LOGD(TAG, "Response State Get");
+  auto *frame = static_cast<const tiono2_state_t *>(frame_data);
+  this->update_state_(*frame);
+  this->notify_state_(0);
+}
 
-  if (frame_type == FRAME_TYPE_CONNECT_RSP) {
-    // 10 04 10 01 00 FA
-    TION_LOGD(TAG, "Response Connect: %s", hex_cstr(frame_data, frame_data_size));
-    return;
-  }
+void TionO2Api::handle_dev_mode_rsp_(const void *frame_data, size_t frame_data_size) {
+  // 13 00 EC
+  struct RawDevModeFrame {
+    union {
+      DevModeFlags dev_mode;
+      uint8_t data;
+    };
+  } PACKED;
+  auto *frame = static_cast<const RawDevModeFrame *>(frame_data);
+  TION_LOGD(TAG, "Response Dev mode: %s", tion::get_flag_bits(frame->data));
+  this->update_dev_mode_(frame->dev_mode);
+  this->planner_.complete(REQUEST_DEV_MODE);
+}
 
-  if (frame_type == FRAME_TYPE_TIME_GET_RSP) {
-    // 15 0B 09 1A F2
-    auto *data = static_cast<const tiono2_time_t *>(frame_data);
-    TION_LOGD(TAG, "Response Time: %02u:%02u:%02u", data->hours, data->minutes, data->seconds);
-    return;
-  }
+void TionO2Api::handle_work_mode_rsp_(const void *frame_data, size_t frame_data_size) {
+  // 55 AA
+  TION_LOGV(TAG, "Response Work Mode");
+}
 
-  TION_LOGW(TAG, "Unsupported frame %02X: %s", frame_type, hex_cstr(frame_data, frame_data_size));
+void TionO2Api::handle_dev_info_rsp_(const void *frame_data, size_t frame_data_size) {
+  // 17 04 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 08 61 0E 13 04 10 EC 19 79
+  TION_LOGD(TAG, "Response Device info: %s", hex_cstr(frame_data, frame_data_size));
+  this->update_dev_info_(*static_cast<const tiono2_dev_info_t *>(frame_data));
+  // connect is needed only to get device info
+  this->planner_.complete(REQUEST_CONNECT);
+  this->planner_.complete(REQUEST_DEV_INFO);
+}
+
+void TionO2Api::handle_connect_rsp_(const void *frame_data, size_t frame_data_size) {
+  // 10 04 10 01 00 FA
+  TION_LOGD(TAG, "Response Connect: %s", hex_cstr(frame_data, frame_data_size));
+}
+
+void TionO2Api::handle_time_rsp_(const void *frame_data, size_t frame_data_size) {
+  // 15 0B 09 1A F2
+  auto *data = static_cast<const tiono2_time_t *>(frame_data);
+  TION_LOGD(TAG, "Response Time: %02u:%02u:%02u", data->hours, data->minutes, data->seconds);
 }
 
 bool TionO2Api::request_connect_() const {
@@ -268,13 +292,14 @@ void TionO2Api::write_state(TionStateCall *call) {
     });
   }
 
-  tiono2_state_set_t req(st);
+  auto &req = this->make_frame_data_<tiono2_state_set_t>(st);
   TION_DUMP(TAG, "fan  : %u", req.fan_speed);
   TION_DUMP(TAG, "temp : %u", req.target_temperature);
   TION_DUMP(TAG, "power: %s", ONOFF(req.power_state));
   TION_DUMP(TAG, "heat : %s", ONOFF(req.heater_state));
   TION_DUMP(TAG, "comm : %s", req.comm_source == tion::CommSource::AUTO ? "AUTO" : "USER");
   this->write_frame(FRAME_TYPE_STATE_SET_REQ, req);
+  this->planner_.invalidate(REQUEST_DEV_MODE);
 
   if (!st.auto_state && st.sound_state) {
     this->update_work_mode();
@@ -300,11 +325,16 @@ bool TionO2Api::reset_filter(const tion::TionState &state, uint32_t request_id)
 }
 
 void TionO2Api::request_state() {
-  if (this->state_.firmware_version == 0) {
+  const auto now = tion::millis();
+  if (this->planner_.plan(REQUEST_CONNECT, now)) {
     this->request_connect_();
+  }
+  if (this->planner_.plan(REQUEST_DEV_INFO, now)) {
     this->request_dev_info_();
   }
-  this->request_dev_mode_();
+  if (this->planner_.plan(REQUEST_DEV_MODE, now)) {
+    this->request_dev_mode_();
+  }
   this->request_state_();
 }
 
@@ -331,6 +361,11 @@ TionO2Api::TionO2Api() : TionApiBase() {
 #ifdef TION_ENABLE_PI_CONTROLLER
   this->traits_.auto_prod = PROD;
 #endif
+
+  this->planner_.set_policy(REQUEST_CONNECT, RequestPlanner::ONCE);
+  this->planner_.set_policy(REQUEST_DEV_INFO, RequestPlanner::ONCE);
+  // control source changes only with the state, e.g. by the breezer buttons, so it is checked on the state change
+  this->planner_.set_policy(REQUEST_DEV_MODE, RequestPlanner::ON_CHANGE, TION_O2_DEV_MODE_REFRESH_INTERVAL);
 }
 
 void TionO2Api::update_dev_mode_(const DevModeFlags &dev_mode) {
@@ -351,6 +386,11 @@ void TionO2Api::update_dev_info_(const tiono2_dev_info_t &dev_info) {
 }
 
 void TionO2Api::update_state_(const tiono2_state_t &state) {
+  if (this->state_.power_state != state.power_state || this->state_.heater_state != state.heater_state ||
+      this->state_.fan_speed != state.fan_speed) {
+    this->planner_.invalidate(REQUEST_DEV_MODE);
+  }
+
   this->state_.initialized = true;
 
   this->state_.power_state = state.power_state;
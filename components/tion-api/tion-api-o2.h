@@ -15,12 +15,19 @@ size_t get_req_frame_size(uint8_t frame_type);
 size_t get_rsp_frame_size(uint8_t frame_type);
 
 class TionO2Api : public tion::TionApiBase, public tion::TionApiWriter {
+  friend struct tiono2_frame_handlers_t<TionO2Api>;
+
  public:
   TionO2Api();
 
-  void read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
+  /// Sub-requests sent with the state request, see set_request_policy.
+  enum PlannedRequest : uint8_t { REQUEST_CONNECT, REQUEST_DEV_INFO, REQUEST_DEV_MODE };
+
+  /// @return true if frame was passed to its handler.
+  bool read_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size);
 
   uint16_t get_state_type() const;
+  static tion::TionCommandClass get_command_class(uint16_t frame_type);
 
   bool reset_filter(const tion::TionState &state, uint32_t request_id = 1) const;
   bool factory_reset(const tion::TionState &state, uint32_t request_id = 1) const;
@@ -45,6 +52,13 @@ class TionO2Api : public tion::TionApiBase, public tion::TionApiWriter {
   void update_state_(const tiono2_state_t &state);
   void update_dev_info_(const tiono2_dev_info_t &dev_info);
   void update_dev_mode_(const DevModeFlags &dev_mode);
+
+  void handle_connect_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_state_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_dev_mode_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_time_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_dev_info_rsp_(const void *frame_data, size_t frame_data_size);
+  void handle_work_mode_rsp_(const void *frame_data, size_t frame_data_size);
 };
 
 }  // namespace tion_o2
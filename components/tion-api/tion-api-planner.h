@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dentra {
+namespace tion {
+
+/// Plan of the sub-requests sent along with the state request on every poll.
+/// Each sub-request has a freshness policy and is sent only when it is stale. Requests out of capacity are ignored.
+template<size_t capacity> class TionRequestPlanner {
+ public:
+  enum { CAPACITY = capacity };
+
+  enum Policy : uint8_t {
+    /// Sent on every poll.
+    ALWAYS,
+    /// Sent until the response is received.
+    ONCE,
+    /// Sent after invalidate() until the response is received. If period is set, also sent every period ms.
+    ON_CHANGE,
+    /// Sent every period polls.
+    EVERY_POLLS,
+    /// Sent every period ms.
+    EVERY_MILLIS,
+  };
+
+  void set_policy(size_t request, Policy policy, uint32_t period = 0) {
+    if (request >= capacity) {
+      return;
+    }
+    auto &entry = this->entries_[request];
+    entry.policy = policy;
+    entry.period = period;
+    entry.stale = true;
+  }
+
+  Policy get_policy(size_t request) const { return request < capacity ? this->entries_[request].policy : ALWAYS; }
+
+  /// Marks request as stale, it will be sent on the next poll.
+  void invalidate(size_t request) {
+    if (request < capacity) {
+      this->entries_[request].stale = true;
+    }
+  }
+
+  /// Marks request as fresh on its response.
+  void complete(size_t request) {
+    if (request >= capacity) {
+      return;
+    }
+    auto &entry = this->entries_[request];
+    if (entry.policy == ONCE || entry.policy == ON_CHANGE) {
+      entry.stale = false;
+    }
+  }
+
+  bool is_stale(size_t request) const { return request < capacity && this->entries_[request].stale; }
+
+  /// Must be called once per poll for every request.
+  /// @return true if request should be sent now, it is accounted as sent then.
+  bool plan(size_t request, uint32_t now) {
+    if (request >= capacity) {
+      return false;
+    }
+    auto &entry = this->entries_[request];
+    bool send = entry.stale;
+    switch (entry.policy) {
+      case ALWAYS:
+        send = true;
+        break;
+      case ONCE:
+        break;
+      case ON_CHANGE:
+        send = send || (entry.period != 0 && now - entry.last_time >= entry.period);
+        break;
+      case EVERY_POLLS:
+        send = send || ++entry.polls >= entry.period;
+        break;
+      case EVERY_MILLIS:
+        send = send || now - entry.last_time >= entry.period;
+        break;
+    }
+    if (send) {
+      entry.last_time = now;
+      entry.polls = 0;
+      if (entry.policy == EVERY_POLLS || entry.policy == EVERY_MILLIS) {
+        entry.stale = false;
+      }
+    }
+    return send;
+  }
+
+ protected:
+  struct Entry {
+    Policy policy{ALWAYS};
+    bool stale{true};
+    uint16_t polls{};
+    uint32_t period{};
+    // time of the last send
+    uint32_t last_time{};
+  } entries_[capacity]{};
+};
+
+}  // namespace tion
+}  // namespace dentra
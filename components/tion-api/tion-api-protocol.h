@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cinttypes>
 #include <functional>
 
@@ -24,6 +25,55 @@ template<class data_type> struct tion_ble_frame_t {
 
 using tion_any_ble_frame_t = tion_ble_frame_t<uint8_t[0]>;
 
+/// Counter of the link, incremented by the I/O task and read from the main loop. Only the value itself is shared,
+/// so relaxed ordering is enough.
+class TionLinkCounter {
+ public:
+  TionLinkCounter() = default;
+  TionLinkCounter(const TionLinkCounter &other) : value_(other.load()) {}
+  TionLinkCounter &operator=(const TionLinkCounter &other) { return *this = other.load(); }
+  TionLinkCounter &operator=(uint32_t value) {
+    this->value_.store(value, std::memory_order_relaxed);
+    return *this;
+  }
+
+  uint32_t load() const { return this->value_.load(std::memory_order_relaxed); }
+
+  void operator++(int) { this->value_.fetch_add(1, std::memory_order_relaxed); }
+  void operator+=(uint32_t value) { this->value_.fetch_add(value, std::memory_order_relaxed); }
+
+ protected:
+  std::atomic<uint32_t> value_{};
+};
+
+/// Link level counters of the connection. Protocols count frames and errors, vports count dropped frames and
+/// components count state timeouts. Counters are never reset and wrap around.
+struct TionLinkStats {
+  // valid frames passed to the reader
+  TionLinkCounter rx_frames;
+  // all received bytes, including the invalid ones
+  TionLinkCounter rx_bytes;
+  TionLinkCounter tx_frames;
+  TionLinkCounter tx_bytes;
+  // frames with invalid checksum
+  TionLinkCounter crc_errors;
+  // frames with invalid magic or of unknown type
+  TionLinkCounter bad_magic;
+  // frames with invalid size or larger than the buffer
+  TionLinkCounter oversize;
+  // times bytes were skipped to find the next frame head
+  TionLinkCounter resyncs;
+  // frames dropped by full queues
+  TionLinkCounter drops;
+  // states not received in time
+  TionLinkCounter timeouts;
+
+  /// @return number of errors of all kinds.
+  uint32_t errors() const {
+    return crc_errors.load() + bad_magic.load() + oversize.load() + resyncs.load() + drops.load() + timeouts.load();
+  }
+};
+
 template<class frame_spec_t> class TionProtocol {
  public:
   using frame_spec_type = frame_spec_t;
@@ -34,9 +84,26 @@ template<class frame_spec_t> class TionProtocol {
   using writer_type = std::function<bool(const uint8_t *data, size_t size)>;
   void set_protocol_writer(writer_type &&writer) { this->writer_ = std::move(writer); }
 
+  TionLinkStats &get_link_stats() { return this->stats_; }
+  const TionLinkStats &get_link_stats() const { return this->stats_; }
+
  protected:
   reader_type reader_{};
   writer_type writer_{};
+  TionLinkStats stats_{};
+
+  /// Passes valid frame to the reader.
+  void read_frame_data_(const frame_spec_t &frame, size_t size) {
+    this->stats_.rx_frames++;
+    this->reader_(frame, size);
+  }
+
+  /// Passes encoded frame to the writer.
+  bool write_frame_data_(const uint8_t *data, size_t size) {
+    this->stats_.tx_frames++;
+    this->stats_.tx_bytes += size;
+    return this->writer_(data, size);
+  }
 };
 
 }  // namespace tion
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dentra {
+namespace tion {
+
+/// Fixed size table of requests waiting for the response with the same request id.
+/// Expired requests are resent with the same request id and doubled timeout until retries are exhausted.
+template<class data_type, size_t capacity> class TionRequests {
+ public:
+  enum { CAPACITY = capacity };
+
+  struct Request {
+    // 0 means free slot.
+    uint32_t request_id;
+    // time of the first send, round trip time is counted from it.
+    uint32_t start_time;
+    uint32_t deadline;
+    uint8_t retries;
+    // superseded requests are not resent, but may still be confirmed by late response.
+    bool superseded;
+    data_type data;
+  };
+
+  void set_timeout(uint32_t timeout) { this->timeout_ = timeout; }
+  uint32_t get_timeout() const { return this->timeout_; }
+  void set_max_retries(uint8_t max_retries) { this->max_retries_ = max_retries; }
+  uint8_t get_max_retries() const { return this->max_retries_; }
+
+  bool empty() const { return this->size_ == 0; }
+  size_t size() const { return this->size_; }
+
+  /// Adds request, all previous requests are marked as superseded.
+  /// If the table is full, the oldest request is dropped and returned to on_drop.
+  template<class on_drop_t> void add(uint32_t request_id, const data_type &data, uint32_t now, on_drop_t &&on_drop) {
+    Request *free{}, *oldest{};
+    for (auto &req : this->requests_) {
+      if (req.request_id == 0) {
+        free = free ? free : &req;
+        continue;
+      }
+      req.superseded = true;
+      if (oldest == nullptr || int32_t(req.start_time - oldest->start_time) < 0) {
+        oldest = &req;
+      }
+    }
+    if (free == nullptr) {
+      on_drop(*oldest);
+      free = oldest;
+      this->size_--;
+    }
+    *free = Request{request_id, now, now + this->timeout_, 0, false, data};
+    this->size_++;
+  }
+
+  /// Removes request with the given id and passes it to on_complete.
+  /// @return false for unknown request id, e.g. duplicated or too late response.
+  template<class on_complete_t> bool complete(uint32_t request_id, on_complete_t &&on_complete) {
+    if (request_id == 0 || this->size_ == 0) {
+      return false;
+    }
+    for (auto &req : this->requests_) {
+      if (req.request_id == request_id) {
+        on_complete(req);
+        req.request_id = 0;
+        this->size_--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Checks deadlines. Expired requests with retries left are passed to on_retry, others are removed and passed to
+  /// on_expire.
+  template<class on_retry_t, class on_expire_t>
+  void check(uint32_t now, on_retry_t &&on_retry, on_expire_t &&on_expire) {
+    if (this->size_ == 0) {
+      return;
+    }
+    for (auto &req : this->requests_) {
+      if (req.request_id == 0 || int32_t(now - req.deadline) < 0) {
+        continue;
+      }
+      if (!req.superseded && req.retries < this->max_retries_) {
+        req.retries++;
+        req.deadline = now + (this->timeout_ << req.retries);
+        on_retry(req);
+        continue;
+      }
+      on_expire(req);
+      req.request_id = 0;
+      this->size_--;
+    }
+  }
+
+ protected:
+  Request requests_[capacity]{};
+  size_t size_{};
+  uint32_t timeout_{1000};
+  uint8_t max_retries_{2};
+};
+
+}  // namespace tion
+}  // namespace dentra
@@ -0,0 +1,101 @@
+#include <cinttypes>
+#include <cstring>
+
+#include "log.h"
+#include "tion-api-trace.h"
+
+namespace dentra {
+namespace tion {
+
+void TionTraceHistogram::reset() {
+  std::memset(this->buckets_, 0, sizeof(this->buckets_));
+  this->count_ = 0;
+  this->max_ = 0;
+}
+
+uint32_t TionTraceHistogram::get_percentile(uint8_t percentile) const {
+  if (this->count_ == 0) {
+    return 0;
+  }
+  const uint32_t rank = (uint64_t(this->count_) * percentile + 99) / 100;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < BUCKETS; i++) {
+    sum += this->buckets_[i];
+    if (sum >= rank && sum > 0) {
+      const uint32_t upper = i == 0 ? 0 : uint32_t(1) << i;
+      return i == BUCKETS - 1 || upper > this->max_ ? this->max_ : upper;
+    }
+  }
+  return this->max_;
+}
+
+#ifdef TION_ENABLE_TRACE
+
+uint32_t TionTrace::rx_time_{};
+uint32_t TionTrace::frame_time_{};
+bool TionTrace::rx_pending_{};
+bool TionTrace::frame_pending_{};
+
+void TionTrace::publish() {
+  if (!this->active_) {
+    return;
+  }
+  this->active_ = false;
+  const uint32_t now = tion::micros();
+  for (uint8_t stage = 0; stage < STAGE_TOTAL; stage++) {
+    const uint32_t end = stage + 1 < STAGE_TOTAL ? this->marks_[stage + 1] : now;
+    this->histograms_[stage].add(end - this->marks_[stage]);
+  }
+  this->histograms_[STAGE_TOTAL].add(now - this->marks_[STAGE_RX]);
+}
+
+const char *TionTrace::get_stage_name(Stage stage) {
+  switch (stage) {
+    case STAGE_RX:
+      return "rx";
+    case STAGE_DISPATCH:
+      return "dispatch";
+    case STAGE_DEFER:
+      return "defer";
+    case STAGE_PUBLISH:
+      return "publish";
+    case STAGE_TOTAL:
+      return "total";
+    default:
+      return "unknown";
+  }
+}
+
+void TionTrace::reset() {
+  for (auto &histogram : this->histograms_) {
+    histogram.reset();
+  }
+}
+
+std::string TionTrace::to_string() const {
+  std::string res;
+  for (uint8_t stage = 0; stage < STAGES; stage++) {
+    const auto &histogram = this->histograms_[stage];
+    if (!res.empty()) {
+      res += ' ';
+    }
+    res += str_sprintf("%s %" PRIu32 "/%" PRIu32 "/%" PRIu32, get_stage_name(Stage(stage)),
+                       histogram.get_percentile(50), histogram.get_percentile(95), histogram.get_max());
+  }
+  return res;
+}
+
+void TionTrace::dump(const char *tag) const {
+  TION_LOGC(tag, "  Latency trace, us (p50/p95/max):");
+  for (uint8_t stage = 0; stage < STAGES; stage++) {
+    const auto &histogram = this->histograms_[stage];
+    TION_LOGC(tag, "    %-8s: %" PRIu32 "/%" PRIu32 "/%" PRIu32 ", count %" PRIu32, get_stage_name(Stage(stage)),
+              histogram.get_percentile(50), histogram.get_percentile(95), histogram.get_max(),
+              histogram.get_count());
+  }
+}
+
+#endif  // TION_ENABLE_TRACE
+
+}  // namespace tion
+}  // namespace dentra
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "utils.h"
+
+// Latency trace of the received state: first received byte -> decoded frame -> notified state -> deferred
+// component callback -> published entities. Enabled with TION_ENABLE_TRACE, otherwise probes expand to nothing.
+#ifdef TION_ENABLE_TRACE
+/// Data is available in the receive buffer.
+#define TION_TRACE_RX(has_data) \
+  do { \
+    if (has_data) \
+      dentra::tion::TionTrace::rx(); \
+  } while (0)
+/// Decoded frame is passed to the api.
+#define TION_TRACE_FRAME() dentra::tion::TionTrace::frame()
+#define TION_TRACE_STATE(trace) (trace).state()
+#define TION_TRACE_DEFER(trace) (trace).defer()
+#define TION_TRACE_PUBLISH(trace) (trace).publish()
+#else
+#define TION_TRACE_RX(has_data)
+#define TION_TRACE_FRAME()
+#define TION_TRACE_STATE(trace)
+#define TION_TRACE_DEFER(trace)
+#define TION_TRACE_PUBLISH(trace)
+#endif
+
+namespace dentra {
+namespace tion {
+
+/// Histogram with log2 buckets of microseconds: bucket 0 counts zero durations, bucket i counts [2^(i-1), 2^i).
+class TionTraceHistogram {
+ public:
+  enum { BUCKETS = 32 };
+
+  void add(uint32_t us) {
+    uint32_t idx = us == 0 ? 0 : 32 - __builtin_clz(us);
+    if (idx >= BUCKETS) {
+      idx = BUCKETS - 1;
+    }
+    this->buckets_[idx]++;
+    this->count_++;
+    if (us > this->max_) {
+      this->max_ = us;
+    }
+  }
+
+  void reset();
+
+  uint32_t get_count() const { return this->count_; }
+  uint32_t get_max() const { return this->max_; }
+
+  /// @return upper bound of the bucket containing the percentile, but not more than maximum duration.
+  uint32_t get_percentile(uint8_t percentile) const;
+
+ protected:
+  uint32_t buckets_[BUCKETS]{};
+  uint32_t count_{};
+  uint32_t max_{};
+};
+
+#ifdef TION_ENABLE_TRACE
+/// Stage durations of received states of one api instance, so every model has its own histograms.
+/// Receive marks are shared by all instances and are taken from the main loop only.
+class TionTrace {
+ public:
+  enum Stage : uint8_t {
+    // first received byte -> decoded frame
+    STAGE_RX,
+    // decoded frame -> parsed and notified state
+    STAGE_DISPATCH,
+    // notified state -> deferred component callback
+    STAGE_DEFER,
+    // deferred component callback -> published entities and state callbacks
+    STAGE_PUBLISH,
+    // first received byte -> published entities
+    STAGE_TOTAL,
+    STAGES,
+  };
+
+  /// Marks received data, the first mark after decoded frame starts the next one.
+  static void rx() {
+    if (!rx_pending_) {
+      rx_pending_ = true;
+      rx_time_ = tion::micros();
+    }
+  }
+
+  /// Marks decoded frame. Frames without rx mark (e.g. several frames received at once) start here.
+  static void frame() {
+    frame_time_ = tion::micros();
+    if (!rx_pending_) {
+      rx_time_ = frame_time_;
+    }
+    rx_pending_ = false;
+    frame_pending_ = true;
+  }
+
+  /// Marks notified state. States which are not received (predicted or restored) are not traced.
+  void state() {
+    this->active_ = frame_pending_;
+    frame_pending_ = false;
+    if (this->active_) {
+      this->marks_[STAGE_RX] = rx_time_;
+      this->marks_[STAGE_DISPATCH] = frame_time_;
+      this->marks_[STAGE_DEFER] = tion::micros();
+      this->marks_[STAGE_PUBLISH] = this->marks_[STAGE_DEFER];
+    }
+  }
+
+  /// Marks start of deferred component callback, only the last of several notified states is traced.
+  void defer() {
+    if (this->active_) {
+      this->marks_[STAGE_PUBLISH] = tion::micros();
+    }
+  }
+
+  /// Marks published entities and completes the trace.
+  void publish();
+
+  const TionTraceHistogram &get_histogram(Stage stage) const { return this->histograms_[stage]; }
+  static const char *get_stage_name(Stage stage);
+
+  void reset();
+
+  /// @return p50/p95/max of every stage in microseconds, e.g. "rx 512/1024/1650 dispatch 64/64/97 ...".
+  std::string to_string() const;
+  /// Logs p50/p95/max of every stage.
+  void dump(const char *tag) const;
+
+ protected:
+  static uint32_t rx_time_;
+  static uint32_t frame_time_;
+  static bool rx_pending_;
+  static bool frame_pending_;
+
+  // start time of every stage
+  uint32_t marks_[STAGE_TOTAL]{};
+  bool active_{};
+  TionTraceHistogram histograms_[STAGES];
+};
+#endif  // TION_ENABLE_TRACE
+
+}  // namespace tion
+}  // namespace dentra
@@ -1,5 +1,4 @@
 #include <cstring>
-#include <cinttypes>
 
 #include "log.h"
 #include "utils.h"
@@ -33,70 +32,43 @@ void Tion3sUartProtocol::read_uart_data(TionUartReader *io) {
     return;
   }
 
-  while (io->available() > 0) {
-    if (this->read_frame_(io) == READ_NEXT_LOOP) {
-      break;
-    }
+  while (this->buf_fill_(io)) {
+    this->read_frames_();
     tion::yield();
   }
 }
 
-Tion3sUartProtocol::read_frame_result_t Tion3sUartProtocol::read_frame_(TionUartReader *io) {
-  auto *frame = reinterpret_cast<Tion3sRawUartFrame *>(this->buf_);
-
-  if (frame->rx.head != this->head_type_) {
-    if (io->available() < sizeof(frame->rx.head)) {
-      // do not flood log while waiting magic
-      // TION_LOGV(TAG, "Waiting frame magic");
-      return READ_NEXT_LOOP;
-    }
-    if (!io->read_array(&frame->rx.head, sizeof(frame->rx.head))) {
-      TION_LOGW(TAG, "Failed read frame head");
-      return READ_THIS_LOOP;
-    }
-    if (frame->rx.head != this->head_type_) {
-      TION_LOGW(TAG, "Unexpected byte: 0x%02X", frame->rx.head);
-      return READ_THIS_LOOP;
-    }
-  }
-
-  if (frame->rx.type == 0) {
-    if (io->available() < sizeof(frame->rx.type)) {
-      TION_LOGV(TAG, "Waiting frame type");
-      return READ_NEXT_LOOP;
-    }
-    if (!io->read_array(&frame->rx.type, sizeof(frame->rx.type))) {
-      TION_LOGW(TAG, "Failed read frame type");
-      this->reset_buf_();
-      return READ_THIS_LOOP;
-    }
-  }
-
-  constexpr uint32_t tail_size = sizeof(frame->rx.data) + sizeof(frame->magic);
-  if (io->available() < tail_size) {
-    TION_LOGV(TAG, "Waiting frame data %i of %" PRIu32, io->available(), tail_size);
-    return READ_NEXT_LOOP;
-  }
-
-  if (!io->read_array(&frame->rx.data, tail_size)) {
-    TION_LOGW(TAG, "Failed read frame data");
-    this->reset_buf_();
-    return READ_THIS_LOOP;
-  }
-
-  TION_LOGV(TAG, "RX: %s", hex_cstr(&frame->data, sizeof(frame->data)));
-
-  if (frame->magic != FRAME_MAGIC_END) {
-    TION_LOGW(TAG, "Invalid frame magic %02X", frame->magic);
-    this->reset_buf_();
-    return READ_THIS_LOOP;
-  }
-
-  tion::yield();
-  this->reader_(*reinterpret_cast<const tion_any_frame_t *>(&frame->data), sizeof(frame->data));
-  this->reset_buf_();
-
-  return READ_NEXT_LOOP;
+void Tion3sUartProtocol::read_frames_() {
+  this->scan_frames_(
+      [this](uint8_t byte) {
+        if (byte == this->head_type_) {
+          return true;
+        }
+        // errors are reported by periodic link summary, see TionLinkStats
+        TION_LOGV(TAG, "Unexpected byte: 0x%02X", byte);
+        return false;
+      },
+      [this](const uint8_t *data, size_t size) -> int {
+        if (size < sizeof(Tion3sRawUartFrame)) {
+          TION_LOGV(TAG, "Waiting frame data %zu of %zu", size, sizeof(Tion3sRawUartFrame));
+          return FRAME_INCOMPLETE;
+        }
+
+        const auto *frame = reinterpret_cast<const Tion3sRawUartFrame *>(data);
+        TION_LOGV(TAG, "RX: %s", hex_cstr(&frame->data, sizeof(frame->data)));
+
+        if (frame->magic != FRAME_MAGIC_END) {
+          TION_LOGV(TAG, "Invalid frame magic %02X", frame->magic);
+          this->stats_.bad_magic++;
+          return FRAME_INVALID;
+        }
+
+        return sizeof(Tion3sRawUartFrame);
+      },
+      [this](const uint8_t *data, size_t size) {
+        const auto *frame = reinterpret_cast<const Tion3sRawUartFrame *>(data);
+        this->read_frame_data_(*reinterpret_cast<const tion_any_frame_t *>(&frame->data), sizeof(frame->data));
+      });
 }
 
 bool Tion3sUartProtocol::write_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
@@ -112,7 +84,7 @@ bool Tion3sUartProtocol::write_frame(uint16_t frame_type, const void *frame_data
 
   TION_LOGV(TAG, "TX: %s", tion::hex_cstr(reinterpret_cast<uint8_t *>(&frame), sizeof(frame)));
 
-  return this->writer_(reinterpret_cast<uint8_t *>(&frame), sizeof(frame));
+  return this->write_frame_data_(reinterpret_cast<uint8_t *>(&frame), sizeof(frame));
 }
 
 }  // namespace tion
@@ -5,8 +5,8 @@
 namespace dentra {
 namespace tion {
 
-// 20 = sizeof(tion3s_frame_t)
-class Tion3sUartProtocol : public TionUartProtocolBase<20> {
+// 20 = sizeof(tion3s_frame_t), rx buffer holds two frames.
+class Tion3sUartProtocol : public TionUartProtocolBase<20, 20 * 2> {
  public:
   Tion3sUartProtocol(const Tion3sUartProtocol &) = delete;             // non construction-copyable
   Tion3sUartProtocol &operator=(const Tion3sUartProtocol &) = delete;  // non copyable
@@ -20,8 +20,8 @@ class Tion3sUartProtocol : public TionUartProtocolBase<20> {
  protected:
   const uint8_t head_type_;
 
-  /// Reads a frame starting with size for hw uart or continue reading for sw uart
-  read_frame_result_t read_frame_(TionUartReader *io);
+  /// Scans received data in place and dispatches all complete frames.
+  void read_frames_();
 };
 
 }  // namespace tion
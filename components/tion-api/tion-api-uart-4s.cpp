@@ -22,96 +22,64 @@ struct Tion4sRawUartFrame {
 };
 #pragma pack(pop)
 
-Tion4sUartProtocol::Tion4sUartProtocol()
-#ifdef TION_LOG_FLOOD_GUARD
-    : prev_magic_(Tion4sRawUartFrame::FRAME_MAGIC)
-#endif
-{
-}
-
 void Tion4sUartProtocol::read_uart_data(TionUartReader *io) {
   if (!this->reader_) {
     TION_LOGE(TAG, "Reader is not configured");
     return;
   }
 
-  while (io->available() > 0) {
-    if (this->read_frame_(io) == READ_NEXT_LOOP) {
-      break;
-    }
+  while (this->buf_fill_(io)) {
+    this->read_frames_();
     tion::yield();
   }
 }
 
-Tion4sUartProtocol::read_frame_result_t Tion4sUartProtocol::read_frame_(TionUartReader *io) {
-  auto *frame = reinterpret_cast<Tion4sRawUartFrame *>(this->buf_);
-  if (frame->magic != Tion4sRawUartFrame::FRAME_MAGIC) {
-    if (io->available() < sizeof(frame->magic)) {
-      // do not flood log while waiting magic
-      // TION_LOGV(TAG, "Waiting frame magic");
-      return READ_NEXT_LOOP;
-    }
-    if (!io->read_array(&frame->magic, sizeof(frame->magic))) {
-      TION_LOGW(TAG, "Failed read frame magic");
-      return READ_THIS_LOOP;
-    }
-    if (frame->magic != Tion4sRawUartFrame::FRAME_MAGIC) {
-#ifdef TION_LOG_FLOOD_GUARD
-      // защита от флуда, очень актуально при подключении в USB ПК
-      if (this->prev_magic_ != frame->magic) {
-        TION_LOGW(TAG, "Unexpected byte: 0x%02X", frame->magic);
-      }
-      this->prev_magic_ = frame->magic;
-#endif
-      return READ_THIS_LOOP;
-    }
-  }
-
-  if (frame->size == 0) {
-    constexpr size_t frame_size_size = sizeof(frame->size);
-    if (io->available() < frame_size_size) {
-      TION_LOGV(TAG, "Waiting frame size %i of %zu", io->available(), frame_size_size);
-      return READ_NEXT_LOOP;
-    }
-    if (!io->read_array(&frame->size, frame_size_size)) {
-      TION_LOGW(TAG, "Failed read frame size");
-      this->reset_buf_();
-      return READ_THIS_LOOP;  // FIXME возможно лучше использовать READ_NEXT_LOOP
-    }
-  }
-
-  if (frame->size < sizeof(Tion4sRawUartFrame) || frame->size > FRAME_MAX_SIZE) {
-    TION_LOGW(TAG, "Invalid frame size %u", frame->size);
-    this->reset_buf_();
-    return READ_THIS_LOOP;
-  }
-
-  auto tail_size = frame->size - sizeof(frame->size) - sizeof(frame->magic);
-  if (io->available() < tail_size) {
-    TION_LOGV(TAG, "Waiting frame data %i of %zu", io->available(), tail_size);
-    return READ_NEXT_LOOP;
-  }
-  if (!io->read_array(&frame->data.type, tail_size)) {
-    TION_LOGW(TAG, "Failed read frame data");
-    this->reset_buf_();
-    return READ_THIS_LOOP;
-  }
-
-  TION_LOGV(TAG, "RX: %s", hex_cstr(frame, frame->size));
-
-  auto crc = dentra::tion::crc16_ccitt_false_ffff(frame, frame->size);
-  if (crc != 0) {
-    TION_LOGW(TAG, "Invalid CRC %04X for frame %s", crc, hex_cstr(frame, frame->size));
-    this->reset_buf_();
-    return READ_NEXT_LOOP;
-  }
-
-  tion::yield();
-  auto frame_data_size = frame->size - sizeof(Tion4sRawUartFrame) + sizeof(tion_any_frame_t);
-  this->reader_(*reinterpret_cast<const tion_any_frame_t *>(&frame->data), frame_data_size);
-  this->reset_buf_();
-
-  return READ_NEXT_LOOP;
+void Tion4sUartProtocol::read_frames_() {
+  this->scan_frames_(
+      [](uint8_t byte) {
+        if (byte == Tion4sRawUartFrame::FRAME_MAGIC) {
+          return true;
+        }
+        // errors are reported by periodic link summary, see TionLinkStats
+        TION_LOGV(TAG, "Unexpected byte: 0x%02X", byte);
+        return false;
+      },
+      [this](const uint8_t *data, size_t size) -> int {
+        const auto *frame = reinterpret_cast<const Tion4sRawUartFrame *>(data);
+        constexpr size_t frame_head_size = sizeof(frame->magic) + sizeof(frame->size);
+        if (size < frame_head_size) {
+          TION_LOGV(TAG, "Waiting frame size %zu of %zu", size, frame_head_size);
+          return FRAME_INCOMPLETE;
+        }
+
+        const size_t frame_size = frame->size;
+        if (frame_size < sizeof(Tion4sRawUartFrame) || frame_size > FRAME_MAX_SIZE) {
+          TION_LOGV(TAG, "Invalid frame size %zu", frame_size);
+          this->stats_.oversize++;
+          return FRAME_INVALID;
+        }
+
+        if (size < frame_size) {
+          TION_LOGV(TAG, "Waiting frame data %zu of %zu", size, frame_size);
+          return FRAME_INCOMPLETE;
+        }
+
+        TION_LOGV(TAG, "RX: %s", hex_cstr(frame, frame_size));
+
+        auto crc = dentra::tion::crc16_ccitt_false_ffff(frame, frame_size);
+        if (crc != 0) {
+          TION_LOGV(TAG, "Invalid CRC %04X for frame %s", crc, hex_cstr(frame, frame_size));
+          this->stats_.crc_errors++;
+          return FRAME_INVALID;
+        }
+
+        return frame_size;
+      },
+      [this](const uint8_t *data, size_t size) {
+        const auto *frame = reinterpret_cast<const Tion4sRawUartFrame *>(data);
+        auto frame_data_size = size - sizeof(Tion4sRawUartFrame) + sizeof(tion_any_frame_t);
+        this->read_frame_data_(*reinterpret_cast<const tion_any_frame_t *>(&frame->data), frame_data_size);
+      });
 }
 
 bool Tion4sUartProtocol::write_frame(uint16_t type, const void *data, size_t size) {
@@ -138,7 +106,7 @@ bool Tion4sUartProtocol::write_frame(uint16_t type, const void *data, size_t siz
 
   TION_LOGV(TAG, "TX: %s", tion::hex_cstr(frame_buf, frame_size));
 
-  return this->writer_(frame_buf, frame_size);
+  return this->write_frame_data_(frame_buf, frame_size);
 }
 
 }  // namespace tion
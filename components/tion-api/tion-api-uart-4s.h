@@ -5,19 +5,16 @@
 namespace dentra {
 namespace tion {
 
-class Tion4sUartProtocol : public TionUartProtocolBase<0x2A> {
+// rx buffer holds up to two max sized frames, so most of the time whole response is read at once.
+class Tion4sUartProtocol : public TionUartProtocolBase<0x2A, 0x2A * 2> {
  public:
-  Tion4sUartProtocol();
   void read_uart_data(TionUartReader *io);
 
   bool write_frame(uint16_t type, const void *data, size_t size);
 
  protected:
-  /// Reads a frame starting with size for hw uart or continue reading for sw uart
-  read_frame_result_t read_frame_(TionUartReader *io);
-#ifdef TION_LOG_FLOOD_GUARD
-  uint8_t prev_magic_;
-#endif
+  /// Scans received data in place and dispatches all complete frames.
+  void read_frames_();
 };
 
 }  // namespace tion
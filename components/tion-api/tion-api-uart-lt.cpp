@@ -140,46 +140,39 @@ void TionLtUartProtocol::read_uart_data(tion::TionUartReader *io) {
     return;
   }
 
-  while (io->available() > 0) {
-    if (this->read_frame_(io) == READ_NEXT_LOOP) {
-      break;
-    }
+  while (this->buf_fill_(io)) {
+    this->read_lines_();
     tion::yield();
   }
 }
 
-TionLtUartProtocol::read_frame_result_t TionLtUartProtocol::read_frame_(tion::TionUartReader *io) {
-  auto *buf = this->buf_;
-  auto *end = this->buf_ + sizeof(this->buf_) - 1;
-  while (buf < end) {
-    if (!io->read_array(buf, 1)) {
-      TION_LOGW(TAG, "Failed read message");
-      this->reset_buf_();
-      return READ_NEXT_LOOP;
-    }
-    if (*buf == '\n') {
-      if (buf > this->buf_ && *(buf - 1) == '\r') {
-        *(buf - 1) = 0;
-      } else {
-        *buf = 0;
+void TionLtUartProtocol::read_lines_() {
+  while (this->buf_size_() > 0) {
+    auto *line = reinterpret_cast<char *>(this->buf_ + this->buf_head_);
+    const size_t size = this->buf_size_();
+    auto *eol = static_cast<char *>(std::memchr(line, '\n', size));
+    if (eol == nullptr) {
+      if (size >= FRAME_MAX_SIZE) {
+        // errors are reported by periodic link summary, see TionLinkStats
+        TION_LOGV(TAG, "Message is too long: %.*s", static_cast<int>(size), line);
+        this->stats_.oversize++;
+        this->buf_consume_(size);
       }
-      break;
+      return;
     }
-    buf++;
-  }
-
-  if (buf == end) {
-    TION_LOGW(TAG, "Message is too long: %s", this->buf_);
-    this->reset_buf_();
-    return READ_NEXT_LOOP;
-  }
-
-  if (*this->buf_ == 0) {
-    this->reset_buf_();
-    return READ_NEXT_LOOP;
+    const size_t line_size = eol - line + 1;
+    *eol = 0;
+    if (eol > line && *(eol - 1) == '\r') {
+      *(eol - 1) = 0;
+    }
+    if (*line != 0) {
+      this->read_line_(line);
+    }
+    this->buf_consume_(line_size);
   }
+}
 
-  auto *str = reinterpret_cast<const char *>(this->buf_);
+void TionLtUartProtocol::read_line_(const char *str) {
   TION_LT_TRACE(TAG, "RX: %s", str);
   if (this->busy_ > 0) {
     TION_LT_TRACE(TAG, "write command in progress: %" PRIu32, this->busy_);
@@ -261,7 +254,7 @@ TionLtUartProtocol::read_frame_result_t TionLtUartProtocol::read_frame_(tion::Ti
     frame.data.state.ma_auto = t_data.auto_sate;
     frame.data.state.comm_source = t_data.comm_source;
 
-    this->reader_(*reinterpret_cast<const tion::tion_any_frame_t *>(&frame), sizeof(frame));
+    this->read_frame_data_(*reinterpret_cast<const tion::tion_any_frame_t *>(&frame), sizeof(frame));
   } else if (std::strncmp(str, ST_FIRM, sizeof(ST_FIRM) - 1) == 0) {
     str = str + sizeof(ST_FIRM) - 1;
     tion::tion_frame_t<tion::tion_dev_info_t> frame{
@@ -275,17 +268,14 @@ TionLtUartProtocol::read_frame_result_t TionLtUartProtocol::read_frame_(tion::Ti
         },
     };
     TION_LT_DUMP(TAG, "Got frm : %04X", frame.data.firmware_version);
-    this->reader_(*reinterpret_cast<const tion::tion_any_frame_t *>(&frame), sizeof(frame));
+    this->read_frame_data_(*reinterpret_cast<const tion::tion_any_frame_t *>(&frame), sizeof(frame));
   } else if (std::strncmp(str, ST_MAC, sizeof(ST_MAC) - 1) == 0) {
     // just do nothings, we don't need MAC address now
   } else if (std::strncmp(str, ST_SW_MODE, sizeof(ST_SW_MODE) - 1) == 0) {
     // just do nothings, skip "Switching Mode" string
   } else {
-    TION_LOGW(TAG, "Unsupported: %s", this->buf_);
+    TION_LOGW(TAG, "Unsupported: %s", str);
   }
-
-  this->reset_buf_();
-  return READ_NEXT_LOOP;
 }
 
 bool TionLtUartProtocol::write_frame(uint16_t type, const void *data, size_t size) {
@@ -373,19 +363,19 @@ bool TionLtUartProtocol::write_frame(uint16_t type, const void *data, size_t siz
 
 bool TionLtUartProtocol::write_cmd_(const char *cmd) {
   TION_LT_TRACE(TAG, "TX: %s", cmd);
-  return this->writer_(reinterpret_cast<const uint8_t *>(cmd), strlen(cmd));
+  return this->write_frame_data_(reinterpret_cast<const uint8_t *>(cmd), strlen(cmd));
 }
 
 bool TionLtUartProtocol::write_cmd_(const char *cmd, int8_t param) {
   const auto data = tion::str_sprintf(cmd, param);
   TION_LT_TRACE(TAG, "TX: %s", data.c_str());
-  return this->writer_(reinterpret_cast<const uint8_t *>(data.c_str()), data.length());
+  return this->write_frame_data_(reinterpret_cast<const uint8_t *>(data.c_str()), data.length());
 }
 
 bool TionLtUartProtocol::write_cmd_(const char *cmd, uint32_t param) {
   const auto data = tion::str_sprintf(cmd, param);
   TION_LT_TRACE(TAG, "TX: %s", data.c_str());
-  return this->writer_(reinterpret_cast<const uint8_t *>(data.c_str()), data.length());
+  return this->write_frame_data_(reinterpret_cast<const uint8_t *>(data.c_str()), data.length());
 }
 
 }  // namespace tion_lt
@@ -6,7 +6,8 @@
 namespace dentra {
 namespace tion_lt {
 
-class TionLtUartProtocol : public tion::TionUartProtocolBase<45> {
+// rx buffer holds a few console lines, so whole state response is read with a couple of reads.
+class TionLtUartProtocol : public tion::TionUartProtocolBase<45, 45 * 3> {
  public:
   void read_uart_data(tion::TionUartReader *io);
 
@@ -36,8 +37,10 @@ class TionLtUartProtocol : public tion::TionUartProtocolBase<45> {
 
   uint32_t busy_{};
 
-  /// Reads a frame starting with size for hw uart or continue reading for sw uart
-  read_frame_result_t read_frame_(tion::TionUartReader *io);
+  /// Reads all complete lines from the rx window.
+  void read_lines_();
+  /// Parses single console line without line ending.
+  void read_line_(const char *str);
 
   bool write_cmd_(const char *cmd);
   bool write_cmd_(const char *cmd, int8_t param);
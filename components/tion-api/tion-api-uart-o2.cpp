@@ -20,65 +20,56 @@ void TionO2UartProtocol::read_uart_data(tion::TionUartReader *io) {
     TION_LOGE(TAG, "Reader is not configured");
     return;
   }
-  while (io->available() > 0) {
-    if (this->read_frame_(io) == READ_NEXT_LOOP) {
-      break;
-    }
+  while (this->buf_fill_(io)) {
+    this->read_frames_();
     tion::yield();
   }
 }
 
-void TionO2UartProtocol::skip_uart_data_(tion::TionUartReader *io) {
-  uint8_t buf[1];
-  // read out all uart data, so we can start from a new command from some delay
-  while (io->available()) {
-    io->read_array(buf, 1);
-    TION_LOGV(TAG, "Skipped %02X", *buf);
-  }
-  this->frame_size_ = 0;
-}
-
-int TionO2UartProtocol::read_frame_(tion::TionUartReader *io) {
-  auto *frame = reinterpret_cast<tion::tion_any_frame_t *>(this->buf_);
-
-  if (this->frame_size_ == 0) {
-    if (!io->read_array(&frame->type, 1)) {
-      TION_LOGW(TAG, "Failed read frame type");
-      return READ_NEXT_LOOP;
-    }
-
-    this->frame_size_ = this->get_frame_size(frame->type);
-    if (this->frame_size_ == 0) {
-      TION_LOGW(TAG, "Unknown frame type [%02X]", frame->type);
-      this->skip_uart_data_(io);
-      return READ_NEXT_LOOP;
-    }
-  }
-
-  if (io->available() < this->frame_size_) {
-    TION_LOGD(TAG, "Waiting frame [%02X] data %i of %zu", frame->type, io->available(), this->frame_size_);
-    return READ_NEXT_LOOP;
-  }
-  if (!io->read_array(frame->data, this->frame_size_)) {
-    TION_LOGW(TAG, "Failed read frame [%02X] data", frame->type);
-    this->skip_uart_data_(io);
-    return READ_NEXT_LOOP;
-  }
-
-  auto data_size = this->frame_size_ - 1;  // 1 is crc at tail
-
-  uint8_t crc = this->crc(this->crc(&frame->type, 1), frame->data, this->frame_size_);
-  if (crc != 0) {
-    TION_LOGW(TAG, "Invalid CRC %02x for frame [%02X] data %s", crc, frame->type,
-              tion::hex_cstr(frame->data, data_size));
-    this->skip_uart_data_(io);
-    return READ_NEXT_LOOP;
-  }
-
-  TION_LOGV(TAG, "RX: [%02X]:%s", frame->type, tion::hex_cstr(frame->data, data_size));
-  this->reader_(*frame, data_size + frame->head_size());
-  this->frame_size_ = 0;
-  return READ_NEXT_LOOP;
+void TionO2UartProtocol::read_frames_() {
+  this->scan_frames_(
+      [this](uint8_t byte) {
+        if (this->get_frame_size(byte) != 0) {
+          return true;
+        }
+        TION_LOGV(TAG, "Skipped %02X", byte);
+        return false;
+      },
+      [this](const uint8_t *data, size_t size) -> int {
+        const uint8_t type = *data;
+        // frame size includes crc and excludes type
+        const size_t frame_size = this->get_frame_size(type);
+        if (sizeof(type) + frame_size > FRAME_MAX_SIZE) {
+          // errors are reported by periodic link summary, see TionLinkStats
+          TION_LOGV(TAG, "Invalid frame [%02X] size %zu", type, frame_size);
+          this->stats_.oversize++;
+          return FRAME_INVALID;
+        }
+        if (size < sizeof(type) + frame_size) {
+          TION_LOGD(TAG, "Waiting frame [%02X] data %zu of %zu", type, size - sizeof(type), frame_size);
+          return FRAME_INCOMPLETE;
+        }
+
+        uint8_t crc = this->crc(data, sizeof(type) + frame_size);
+        if (crc != 0) {
+          TION_LOGV(TAG, "Invalid CRC %02x for frame [%02X] data %s", crc, type,
+                    tion::hex_cstr(data + sizeof(type), frame_size - 1));
+          this->stats_.crc_errors++;
+          return FRAME_INVALID;
+        }
+
+        return sizeof(type) + frame_size;
+      },
+      [this](const uint8_t *data, size_t size) {
+        // frame in rx buffer has 8-bit type, so copy it to the frame with 16-bit type
+        uint8_t frame_buf[sizeof(tion::tion_any_frame_t) + FRAME_MAX_SIZE];
+        auto *frame = reinterpret_cast<tion::tion_any_frame_t *>(frame_buf);
+        frame->type = *data;
+        auto data_size = size - 2;  // 1 is type at head and 1 is crc at tail
+        std::memcpy(frame->data, data + 1, data_size);
+        TION_LOGV(TAG, "RX: [%02X]:%s", frame->type, tion::hex_cstr(frame->data, data_size));
+        this->read_frame_data_(*frame, data_size + frame->head_size());
+      });
 }
 
 bool TionO2UartProtocol::write_frame(uint16_t frame_type, const void *frame_data, size_t frame_data_size) {
@@ -109,7 +100,7 @@ bool TionO2UartProtocol::write_frame(uint16_t frame_type, const void *frame_data
 
   TION_LOGV(TAG, "TX: %s", tion::hex_cstr(frame_buf, frame_size));
 
-  return this->writer_(frame_buf, frame_size);
+  return this->write_frame_data_(frame_buf, frame_size);
 }
 
 uint8_t TionO2UartProtocol::crc(uint8_t init, const void *data, size_t size) const {
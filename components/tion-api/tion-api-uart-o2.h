@@ -6,8 +6,8 @@
 namespace dentra {
 namespace tion_o2 {
 
-// 20 = sizeof(tiono2_frame_t)+type+crc+1
-class TionO2UartProtocol : public tion::TionUartProtocolBase<32> {
+// 20 = sizeof(tiono2_frame_t)+type+crc+1, rx buffer holds two frames.
+class TionO2UartProtocol : public tion::TionUartProtocolBase<32, 32 * 2> {
  public:
   TionO2UartProtocol(const TionO2UartProtocol &) = delete;             // non construction-copyable
   TionO2UartProtocol &operator=(const TionO2UartProtocol &) = delete;  // non copyable
@@ -24,11 +24,8 @@ class TionO2UartProtocol : public tion::TionUartProtocolBase<32> {
   uint8_t crc(uint8_t init, const void *data, size_t size) const;
   uint8_t crc(const void *data, size_t size) const { return this->crc(0xFF, data, size); }
 
-  size_t frame_size_{};
-
-  /// Reads a frame starting with size for hw uart or continue reading for sw uart
-  int read_frame_(tion::TionUartReader *io);
-  void skip_uart_data_(tion::TionUartReader *io);
+  /// Scans received data in place and dispatches all complete frames.
+  void read_frames_();
 };
 
 }  // namespace tion_o2
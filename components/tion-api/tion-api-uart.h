@@ -1,6 +1,7 @@
 #pragma once
 
-#include <cstring>  // std::memset
+#include <cstdint>
+#include <cstring>  // std::memset, std::memmove
 
 #include "tion-api-protocol.h"
 
@@ -13,9 +14,67 @@ class TionUartReader {
   virtual bool read_array(void *data, size_t size) = 0;
 };
 
-template<size_t frame_max_size_value> class TionUartProtocolBase : public TionProtocol<tion_any_frame_t> {
+/// Bounded queue of frames waiting for transmission. Frames are stored back to back with one byte size prefix,
+/// so front frame is always contiguous and may be passed to uart as is.
+template<size_t capacity_value> class TionUartTxQueue {
+ public:
+  enum { CAPACITY = capacity_value };
+
+  /// @return false if there is no room for the frame.
+  bool push(const uint8_t *data, size_t size) {
+    if (size == 0 || size > UINT8_MAX) {
+      return false;
+    }
+    if (this->tail_ + 1 + size > CAPACITY) {
+      if (this->tail_ - this->head_ + 1 + size > CAPACITY) {
+        return false;
+      }
+      // move queued frames to the beginning
+      std::memmove(this->buf_, this->buf_ + this->head_, this->tail_ - this->head_);
+      this->tail_ -= this->head_;
+      this->head_ = 0;
+    }
+    this->buf_[this->tail_] = size;
+    std::memcpy(this->buf_ + this->tail_ + 1, data, size);
+    this->tail_ += 1 + size;
+    this->frames_++;
+    return true;
+  }
+
+  bool empty() const { return this->frames_ == 0; }
+  size_t frames() const { return this->frames_; }
+
+  const uint8_t *front_data() const { return this->buf_ + this->head_ + 1; }
+  size_t front_size() const { return this->buf_[this->head_]; }
+
+  void pop() {
+    if (this->frames_ == 0) {
+      return;
+    }
+    this->head_ += 1 + this->buf_[this->head_];
+    if (--this->frames_ == 0) {
+      this->head_ = 0;
+      this->tail_ = 0;
+    }
+  }
+
  protected:
-  enum { FRAME_MAX_SIZE = frame_max_size_value };
+  uint8_t buf_[CAPACITY];
+  size_t head_{};
+  size_t tail_{};
+  size_t frames_{};
+};
+
+template<size_t frame_max_size_value, size_t rx_buf_size_value = frame_max_size_value>
+class TionUartProtocolBase : public TionProtocol<tion_any_frame_t> {
+  static_assert(rx_buf_size_value >= frame_max_size_value, "rx buffer must fit at least one frame");
+
+ public:
+  /// Maximum size of the raw frame, decoded frame passed to the reader is never larger.
+  static constexpr size_t frame_max_size() { return frame_max_size_value; }
+
+ protected:
+  enum { FRAME_MAX_SIZE = frame_max_size_value, RX_BUF_SIZE = rx_buf_size_value };
   // NOLINTNEXTLINE(readability-identifier-naming)
   enum read_frame_result_t {
     // let perform read next frame on next loop
@@ -23,8 +82,92 @@ template<size_t frame_max_size_value> class TionUartProtocolBase : public TionPr
     // stay read frame in current loop
     READ_THIS_LOOP = 1,
   };
-  uint8_t buf_[FRAME_MAX_SIZE]{};
+  uint8_t buf_[RX_BUF_SIZE]{};
   void reset_buf_() { std::memset(this->buf_, 0, sizeof(this->buf_)); }
+
+  // Bulk receive window over buf_: [buf_head_, buf_tail_) holds received but not yet consumed bytes.
+  size_t buf_head_{};
+  size_t buf_tail_{};
+
+  const uint8_t *buf_data_() const { return this->buf_ + this->buf_head_; }
+  size_t buf_size_() const { return this->buf_tail_ - this->buf_head_; }
+
+  /// Drops consumed bytes from the head of the receive window.
+  void buf_consume_(size_t size) {
+    this->buf_head_ += size;
+    if (this->buf_head_ >= this->buf_tail_) {
+      this->buf_head_ = 0;
+      this->buf_tail_ = 0;
+    }
+  }
+
+  /// Reads all available data (limited by free space) with single read_array call.
+  /// @return true if any new data was read.
+  bool buf_fill_(TionUartReader *io) {
+    const int available = io->available();
+    if (available <= 0) {
+      return false;
+    }
+    if (this->buf_head_ > 0) {
+      // move unconsumed tail to the beginning, so frame is always contiguous
+      std::memmove(this->buf_, this->buf_ + this->buf_head_, this->buf_size_());
+      this->buf_tail_ -= this->buf_head_;
+      this->buf_head_ = 0;
+    }
+    const size_t free_size = sizeof(this->buf_) - this->buf_tail_;
+    const size_t read_size = static_cast<size_t>(available) < free_size ? available : free_size;
+    if (read_size == 0 || !io->read_array(this->buf_ + this->buf_tail_, read_size)) {
+      return false;
+    }
+    this->buf_tail_ += read_size;
+    this->stats_.rx_bytes += read_size;
+    return true;
+  }
+
+  // Frame candidate check results, positive value is a size of the valid frame.
+  enum { FRAME_INVALID = -1, FRAME_INCOMPLETE = 0 };
+
+  /// Scans the rx window for frames without reading uart again.
+  /// @param is_head returns true if byte may start a frame.
+  /// @param check_frame returns size of the valid frame at data, FRAME_INCOMPLETE or FRAME_INVALID, and counts the
+  /// error of the invalid one.
+  /// @param on_frame called for every valid frame.
+  /// On invalid candidate (bad CRC, size or end magic) only its first byte is dropped and the search of the next
+  /// header continues in already received data, so frames received behind the garbage are not lost.
+  template<class is_head_t, class check_frame_t, class on_frame_t>
+  void scan_frames_(is_head_t &&is_head, check_frame_t &&check_frame, on_frame_t &&on_frame) {
+    while (this->buf_size_() > 0) {
+      const uint8_t *data = this->buf_data_();
+      const size_t size = this->buf_size_();
+
+      size_t skip = 0;
+      while (skip < size && !is_head(data[skip])) {
+        skip++;
+      }
+      if (skip > 0) {
+        this->stats_.resyncs++;
+        this->buf_consume_(skip);
+        continue;
+      }
+
+      const int frame_size = check_frame(data, size);
+      if (frame_size == FRAME_INCOMPLETE && size < sizeof(this->buf_)) {
+        return;
+      }
+      if (frame_size <= FRAME_INCOMPLETE) {
+        if (frame_size == FRAME_INCOMPLETE) {
+          // frame does not fit into the buffer
+          this->stats_.oversize++;
+        }
+        // resync from the next byte
+        this->buf_consume_(1);
+        continue;
+      }
+
+      on_frame(data, static_cast<size_t>(frame_size));
+      this->buf_consume_(frame_size);
+    }
+  }
 };
 
 }  // namespace tion
@@ -1,10 +1,13 @@
 #pragma once
 
-#pragma once
-
+#include <algorithm>
 #include <cinttypes>
 #include <functional>
 
+#include "tion-api-command-queue.h"
+#include "tion-api-frame.h"
+#include "tion-api-protocol.h"
+
 namespace dentra {
 namespace tion {
 
@@ -20,11 +23,31 @@ class TionApiWriter {
   /// Write a frame data struct.
   template<class T, std::enable_if_t<std::is_class_v<T>, bool> = true>
   bool write_frame(uint16_t type, const T &data) const {
+    static_assert(sizeof(T) <= TX_DATA_MAX_SIZE, "frame data does not fit into TX buffer");
     return this->write_frame(type, &data, sizeof(data));
   }
 
+  // Room for the largest frame head of the transport, see tion_any_frame_t and tion_any_ble_frame_t.
+  // Data size is the limit for frames passed through by proxies, known frames are checked at compile time.
+  enum {
+    TX_HEAD_ROOM = std::max(tion_any_frame_t::head_size(), tion_any_ble_frame_t::head_size()),
+    TX_DATA_MAX_SIZE = 64,
+  };
+  using tx_frame_type = TionFrameBuilder<TX_HEAD_ROOM, TX_DATA_MAX_SIZE>;
+
+  /// Class of the frame for the transport command queue. Unknown frames are never coalesced.
+  static TionCommandClass get_command_class(uint16_t type) { return TionCommandClass::CONTROL; }
+
  protected:
   writer_type writer_{};
+  // Frame data built with make_frame_data_ is passed to the writer in place,
+  // so the writer may put the transport head before it without copying.
+  tx_frame_type tx_frame_{};
+
+  /// Constructs frame data struct directly in the transmit buffer, so methods using it are not const.
+  template<class T, class... Args> T &make_frame_data_(Args &&...args) {
+    return this->tx_frame_.template emplace<T>(std::forward<Args>(args)...);
+  }
 };
 
 }  // namespace tion
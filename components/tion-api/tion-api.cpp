@@ -119,6 +119,73 @@ void TionState::dump(const char *TAG, const TionTraits &traits) const {
   TION_DUMP(TAG, "errors      : 0x%08" PRIX32, this->errors);
 }
 
+TionStateChangeMask TionState::diff(const TionState &prev) const {
+  TionStateChangeMask res = 0;
+  const auto set = [&res](bool changed, Field field) {
+    if (changed) {
+      res |= field;
+    }
+  };
+  set(this->power_state != prev.power_state, POWER_STATE);
+  set(this->heater_state != prev.heater_state, HEATER_STATE);
+  set(this->sound_state != prev.sound_state, SOUND_STATE);
+  set(this->led_state != prev.led_state, LED_STATE);
+  set(this->auto_state != prev.auto_state, AUTO_STATE);
+  set(this->filter_state != prev.filter_state, FILTER_STATE);
+  set(this->gate_error_state != prev.gate_error_state, GATE_ERROR_STATE);
+  set(this->comm_source != prev.comm_source, COMM_SOURCE);
+  set(this->initialized != prev.initialized, INITIALIZED);
+  set(this->fan_speed != prev.fan_speed, FAN_SPEED);
+  set(this->gate_position != prev.gate_position, GATE_POSITION);
+  set(this->outdoor_temperature != prev.outdoor_temperature, OUTDOOR_TEMPERATURE);
+  set(this->current_temperature != prev.current_temperature, CURRENT_TEMPERATURE);
+  set(this->target_temperature != prev.target_temperature, TARGET_TEMPERATURE);
+  set(this->productivity != prev.productivity, PRODUCTIVITY);
+  set(this->heater_var != prev.heater_var, HEATER_VAR);
+  set(this->work_time != prev.work_time, WORK_TIME);
+  set(this->fan_time != prev.fan_time, FAN_TIME);
+  set(this->filter_time_left != prev.filter_time_left, FILTER_TIME_LEFT);
+  set(this->airflow_counter != prev.airflow_counter, AIRFLOW_COUNTER);
+  set(this->airflow_m3 != prev.airflow_m3, AIRFLOW_M3);
+  set(this->boost_time_left != prev.boost_time_left, BOOST_TIME_LEFT);
+  set(this->firmware_version != prev.firmware_version, FIRMWARE_VERSION);
+  set(this->hardware_version != prev.hardware_version, HARDWARE_VERSION);
+  set(this->pcb_ctl_temperature != prev.pcb_ctl_temperature, PCB_CTL_TEMPERATURE);
+  set(this->pcb_pwr_temperature != prev.pcb_pwr_temperature, PCB_PWR_TEMPERATURE);
+  set(this->errors != prev.errors, ERRORS);
+  return res;
+}
+
+void TionState::assign(const TionState &src, TionStateChangeMask fields) {
+  if (fields & POWER_STATE) {
+    this->power_state = src.power_state;
+  }
+  if (fields & HEATER_STATE) {
+    this->heater_state = src.heater_state;
+  }
+  if (fields & SOUND_STATE) {
+    this->sound_state = src.sound_state;
+  }
+  if (fields & LED_STATE) {
+    this->led_state = src.led_state;
+  }
+  if (fields & AUTO_STATE) {
+    this->auto_state = src.auto_state;
+  }
+  if (fields & COMM_SOURCE) {
+    this->comm_source = src.comm_source;
+  }
+  if (fields & FAN_SPEED) {
+    this->fan_speed = src.fan_speed;
+  }
+  if (fields & GATE_POSITION) {
+    this->gate_position = src.gate_position;
+  }
+  if (fields & TARGET_TEMPERATURE) {
+    this->target_temperature = src.target_temperature;
+  }
+}
+
 float TionState::get_heater_power(const TionTraits &traits) const {
   if (traits.supports_heater_var) {
     return (traits.max_heater_power * this->heater_var) * 0.1f;
@@ -340,33 +407,54 @@ TionState TionApiBase::make_write_state_(TionStateCall *call) const {
 
 void TionStateCall::dump() const {
   TION_DUMP(TAG, "TionStateCall:");
-  if (this->fan_speed_.has_value()) {
-    TION_DUMP(TAG, "  fan     : %u", *this->fan_speed_);
+  if (this->has_changed(FAN_SPEED)) {
+    TION_DUMP(TAG, "  fan     : %u", this->fan_speed_);
+  }
+  if (this->has_changed(TARGET_TEMPERATURE)) {
+    TION_DUMP(TAG, "  target T: %d", this->target_temperature_);
+  }
+  if (this->has_changed(GATE_POSITION)) {
+    TION_DUMP(TAG, "  gate pos: %u", static_cast<uint8_t>(this->gate_position_));
+  }
+  if (this->has_changed(POWER_STATE)) {
+    TION_DUMP(TAG, "  power   : %s", ONOFF(this->flags_ & POWER_STATE));
   }
-  if (this->target_temperature_.has_value()) {
-    TION_DUMP(TAG, "  target T: %d", *this->target_temperature_);
+  if (this->has_changed(HEATER_STATE)) {
+    TION_DUMP(TAG, "  heater  : %s", ONOFF(this->flags_ & HEATER_STATE));
   }
-  if (this->gate_position_.has_value()) {
-    TION_DUMP(TAG, "  gate pos: %u", static_cast<uint8_t>(*this->gate_position_));
+  if (this->has_changed(AUTO_STATE)) {
+    TION_DUMP(TAG, "  auto    : %s", ONOFF(this->flags_ & AUTO_STATE));
   }
-  if (this->power_state_.has_value()) {
-    TION_DUMP(TAG, "  power   : %s", ONOFF(*this->power_state_));
+  if (this->has_changed(SOUND_STATE)) {
+    TION_DUMP(TAG, "  sound   : %s", ONOFF(this->flags_ & SOUND_STATE));
   }
-  if (this->heater_state_.has_value()) {
-    TION_DUMP(TAG, "  heater  : %s", ONOFF(*this->heater_state_));
+  if (this->has_changed(LED_STATE)) {
+    TION_DUMP(TAG, "  led     : %s", ONOFF(this->flags_ & LED_STATE));
   }
-  if (this->auto_state_.has_value()) {
-    TION_DUMP(TAG, "  auto    : %s", ONOFF(*this->auto_state_));
+}
+
+void TionStateCall::merge(const TionStateCall &other) {
+  if (other.has_changed(FAN_SPEED)) {
+    this->fan_speed_ = other.fan_speed_;
   }
-  if (this->sound_state_.has_value()) {
-    TION_DUMP(TAG, "  sound   : %s", ONOFF(*this->sound_state_));
+  if (other.has_changed(TARGET_TEMPERATURE)) {
+    this->target_temperature_ = other.target_temperature_;
   }
-  if (this->led_state_.has_value()) {
-    TION_DUMP(TAG, "  led     : %s", ONOFF(*this->led_state_));
+  if (other.has_changed(GATE_POSITION)) {
+    this->gate_position_ = other.gate_position_;
   }
+  this->flags_ = (this->flags_ & ~other.changed_) | (other.flags_ & other.changed_);
+  this->changed_ |= other.changed_;
 }
 
 void TionStateCall::perform() {
+  if (this->api_->is_state_stale()) {
+    // cached state may be outdated, so it is not used as base of the changes until the state is received
+    TION_LOGD(TAG, "State was not received yet, changes are held");
+    this->api_->hold_call(*this);
+    this->reset();
+    return;
+  }
   if (this->has_changes()) {
     this->dump();
     this->api_->write_state(this);
@@ -376,29 +464,6 @@ void TionStateCall::perform() {
   }
 }
 
-bool TionStateCall::has_changes() const {
-  return this->fan_speed_.has_value()              //-//
-         || this->power_state_.has_value()         //-//
-         || this->heater_state_.has_value()        //-//
-         || this->target_temperature_.has_value()  //-//
-         || this->sound_state_.has_value()         //-//
-         || this->led_state_.has_value()           //-//
-         || this->gate_position_.has_value()       //-//
-         || this->auto_state_.has_value()          //-//
-      ;
-}
-
-void TionStateCall::reset() {
-  this->fan_speed_.reset();
-  this->power_state_.reset();
-  this->heater_state_.reset();
-  this->target_temperature_.reset();
-  this->sound_state_.reset();
-  this->led_state_.reset();
-  this->gate_position_.reset();
-  this->auto_state_.reset();
-}
-
 TionApiBase::TionApiBase()
 #ifdef TION_ENABLE_PI_CONTROLLER
     : auto_pi_(TION_AUTO_KP, TION_AUTO_TI, TION_AUTO_DB)
@@ -419,7 +484,21 @@ TionApiBase::TionApiBase()
 }
 
 void TionApiBase::notify_state_(uint32_t request_id) {
-  TionStateCall *call = nullptr;
+  TION_TRACE_STATE(this->trace_);
+  this->reconcile_state_(request_id);
+
+  // received state replaces the stale one before any call is performed, stale state holds writes
+  const bool stale = this->state_stale_;
+  this->state_stale_ = false;
+
+  // call lives on the stack, so periodic state polling does not touch the heap
+  TionStateCall call(this);
+
+  if (this->held_call_.has_changes()) {
+    // changes held while state was stale are applied over the received one
+    call.merge(this->held_call_);
+    this->held_call_.reset();
+  }
 
   if (this->is_boost_running()) {
     // если изменили скорость вентиляции или выключили бризер
@@ -427,18 +506,12 @@ void TionApiBase::notify_state_(uint32_t request_id) {
       TION_LOGD(TAG, "Boost canceled by user action");
       // пересохраняем изменившиеся данные, для восстановления
       this->boost_save_state_();
-      if (call == nullptr) {
-        call = new TionStateCall(this);
-      }
-      this->boost_cancel_(call);  // TODO убедиться что пресет сбросится далее
+      this->boost_cancel_(&call);  // TODO убедиться что пресет сбросится далее
     } else {
       auto time_left = this->get_boost_time_left();
       // только если натив буст не поддерживается
       if (!this->traits_.supports_boost && time_left == 0) {
-        if (call == nullptr) {
-          call = new TionStateCall(this);
-        }
-        this->boost_cancel_(call);  // TODO убедиться что пресет сбросится далее
+        this->boost_cancel_(&call);  // TODO убедиться что пресет сбросится далее
       }
       TION_DUMP(TAG, "Boost time left %d s", time_left);
     }
@@ -459,21 +532,128 @@ void TionApiBase::notify_state_(uint32_t request_id) {
     const auto &cs = this->state_;
     if (cs.power_state && !cs.heater_state && cs.outdoor_temperature < 0) {
       TION_LOGW(TAG, "Antifreeze protection has worked, heater now enabled");
-      if (call == nullptr) {
-        call = new TionStateCall(this);
-      }
-      call->set_heater_state(true);
+      call.set_heater_state(true);
+    }
+  }
+
+  if (call.has_changes()) {
+    call.perform();
+  }
+
+  this->complete_write_(request_id);
+
+  // diff against notified state, so fields updated outside of update_state_ (e.g. dev info) are not lost
+  auto changes = this->state_.diff(this->notified_state_);
+  this->notified_state_ = this->state_;
+  if (stale || this->traits_.is_limits_changed(this->notified_traits_)) {
+    // stale state is replaced completely, entities depending on traits are republished with the new ones
+    changes = TionState::ALL_FIELDS;
+  }
+  this->notified_traits_ = this->traits_;
+  if (this->on_state_) {
+    this->on_state_(this->state_, request_id, changes);
+  }
+}
+
+bool TionApiBase::restore_snapshot(const Snapshot &snapshot) {
+  if (this->state_.is_initialized() || !snapshot.state.is_initialized()) {
+    return false;
+  }
+  TION_LOGD(TAG, "Restore state snapshot, firmware %04X, hardware %04X", snapshot.state.firmware_version,
+            snapshot.state.hardware_version);
+  this->state_ = snapshot.state;
+  this->notified_state_ = this->state_;
+  this->traits_.max_fan_speed = snapshot.max_fan_speed;
+  this->traits_.max_heater_power = snapshot.max_heater_power;
+  this->notified_traits_ = this->traits_;
+  this->state_stale_ = true;
+  if (this->state_.firmware_version != 0) {
+    this->restore_dev_info_();
+  }
+  if (this->on_state_) {
+    this->on_state_(this->state_, 0, TionState::ALL_FIELDS);
+  }
+  return true;
+}
+
+void TionApiBase::track_write_(uint32_t request_id, const TionState &state) {
+  this->requests_.add(request_id, state, tion::millis(), [this](const auto &req) {
+    TION_LOGW(TAG, "Request[%" PRIu32 "] dropped, too many pending requests", req.request_id);
+    if (this->on_write_complete_) {
+      this->on_write_complete_(req.request_id, false, 0);
     }
+  });
+  if (this->optimistic_) {
+    this->predict_state_(request_id, state);
   }
+}
 
-  if (call) {
-    call->perform();
-    delete call;
+void TionApiBase::predict_state_(uint32_t request_id, const TionState &state) {
+  const auto fields = state.diff(this->state_) & TionState::CALL_FIELDS;
+  if (fields == 0) {
+    return;
   }
+  TION_LOGD(TAG, "Request[%" PRIu32 "] predicted fields: 0x%08" PRIX32, request_id, fields);
+  this->predicted_.state = state;
+  this->predicted_.fields |= fields;
+  this->predicted_.request_id = request_id;
+  this->state_.assign(state, fields);
 
+  const auto changes = this->state_.diff(this->notified_state_);
+  this->notified_state_ = this->state_;
   if (this->on_state_) {
-    this->on_state_(this->state_, request_id);
+    this->predicted_.notifying = true;
+    this->on_state_(this->state_, request_id, changes);
+    this->predicted_.notifying = false;
+  }
+}
+
+void TionApiBase::reconcile_state_(uint32_t request_id) {
+  if (this->predicted_.fields == 0) {
+    return;
+  }
+  if (request_id != this->predicted_.request_id) {
+    // responses to regular or older requests do not revert predicted values
+    this->state_.assign(this->predicted_.state, this->predicted_.fields);
+    return;
+  }
+  const auto rejected = this->state_.diff(this->predicted_.state) & this->predicted_.fields;
+  if (rejected != 0) {
+    TION_LOGW(TAG, "Request[%" PRIu32 "] was not applied as predicted, rolled back fields: 0x%08" PRIX32, request_id,
+              rejected);
   }
+  this->predicted_.fields = 0;
+}
+
+void TionApiBase::complete_write_(uint32_t request_id) {
+  this->requests_.complete(request_id, [this](const auto &req) {
+    this->last_rtt_ = tion::millis() - req.start_time;
+    TION_LOGD(TAG, "Request[%" PRIu32 "] confirmed in %" PRIu32 " ms, retries %u", req.request_id, this->last_rtt_,
+              req.retries);
+    if (this->on_write_complete_) {
+      this->on_write_complete_(req.request_id, true, this->last_rtt_);
+    }
+  });
+}
+
+void TionApiBase::check_requests() {
+  this->requests_.check(
+      tion::millis(),
+      [this](const auto &req) {
+        TION_LOGD(TAG, "Request[%" PRIu32 "] retry %u", req.request_id, req.retries);
+        this->resend_state_(req.data, req.request_id);
+      },
+      [this](const auto &req) {
+        TION_LOGW(TAG, "Request[%" PRIu32 "] was not confirmed", req.request_id);
+        if (this->on_write_complete_) {
+          this->on_write_complete_(req.request_id, false, tion::millis() - req.start_time);
+        }
+        if (this->predicted_.fields != 0 && req.request_id == this->predicted_.request_id) {
+          // actual state will roll predicted values back
+          this->predicted_.fields = 0;
+          this->request_state();
+        }
+      });
 }
 
 void TionApiBase::set_boost_time(uint16_t boost_time) {
@@ -802,7 +982,7 @@ void TionApiBase::auto_reset() {
             this->auto_max_fan_speed_, this->auto_setpoint_);
   // сначала уведомим все сущности об изменениях
   if (this->on_state_) {
-    this->on_state_(this->state_, 0);
+    this->on_state_(this->state_, 0, TionState::ALL_FIELDS);
   }
   // потом уведомим авто-режим
   // здесь не проверяем auto_state, чтобы когда он включиться все уже было готово
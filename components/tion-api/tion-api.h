@@ -6,6 +6,9 @@
 #include <functional>
 
 #include "tion-api-defines.h"
+#include "tion-api-planner.h"
+#include "tion-api-requests.h"
+#include "tion-api-trace.h"
 #include "utils.h"
 
 #ifdef TION_ENABLE_PI_CONTROLLER
@@ -66,6 +69,13 @@ struct TionTraits {
   uint16_t get_max_heater_power() const { return TION__HEAT_CONST_TO_POWER(this->max_heater_power); }
   float get_max_fan_power(size_t fan_speed) const { return TION__FAN_CONST_TO_POWER(this->max_fan_power[fan_speed]); }
 
+  /// Returns true if limits reported by the breezer differ from prev ones. Support flags are set up once.
+  bool is_limits_changed(const TionTraits &prev) const {
+    return this->max_fan_speed != prev.max_fan_speed || this->max_heater_power != prev.max_heater_power ||
+           this->min_target_temperature != prev.min_target_temperature ||
+           this->max_target_temperature != prev.max_target_temperature;
+  }
+
 #ifdef TION_ENABLE_PI_CONTROLLER
   /// Массив производительностей бризера для каждой скорости, включая 0.
   const uint8_t *auto_prod;
@@ -82,8 +92,47 @@ enum class TionGatePosition : uint8_t {
   NONE = UNKNOWN,
 };
 
+/// Bitmask of TionState::Field changed by the last state update.
+using TionStateChangeMask = uint32_t;
+
 class TionState {
  public:
+  /// Bits of state fields for TionStateChangeMask.
+  enum Field : TionStateChangeMask {
+    POWER_STATE = 1 << 0,
+    HEATER_STATE = 1 << 1,
+    SOUND_STATE = 1 << 2,
+    LED_STATE = 1 << 3,
+    AUTO_STATE = 1 << 4,
+    FILTER_STATE = 1 << 5,
+    GATE_ERROR_STATE = 1 << 6,
+    COMM_SOURCE = 1 << 7,
+    INITIALIZED = 1 << 8,
+    FAN_SPEED = 1 << 9,
+    GATE_POSITION = 1 << 10,
+    OUTDOOR_TEMPERATURE = 1 << 11,
+    CURRENT_TEMPERATURE = 1 << 12,
+    TARGET_TEMPERATURE = 1 << 13,
+    PRODUCTIVITY = 1 << 14,
+    HEATER_VAR = 1 << 15,
+    WORK_TIME = 1 << 16,
+    FAN_TIME = 1 << 17,
+    FILTER_TIME_LEFT = 1 << 18,
+    AIRFLOW_COUNTER = 1 << 19,
+    AIRFLOW_M3 = 1 << 20,
+    BOOST_TIME_LEFT = 1 << 21,
+    FIRMWARE_VERSION = 1 << 22,
+    HARDWARE_VERSION = 1 << 23,
+    PCB_CTL_TEMPERATURE = 1 << 24,
+    PCB_PWR_TEMPERATURE = 1 << 25,
+    ERRORS = 1 << 26,
+    // everything should be treated as changed, e.g. settings or traits were changed.
+    ALL_FIELDS = 0xFFFFFFFF,
+    // fields changed by TionStateCall.
+    CALL_FIELDS = POWER_STATE | HEATER_STATE | SOUND_STATE | LED_STATE | AUTO_STATE | COMM_SOURCE | FAN_SPEED |
+                  GATE_POSITION | TARGET_TEMPERATURE,
+  };
+
   struct {
     // Состояние вкл/выкл.
     bool power_state : 1;
@@ -167,6 +216,11 @@ class TionState {
   // Потребляет ли сейчас обогреватель энергию.
   bool is_heating(const TionTraits &traits) const;
 
+  // Возвращает маску полей отличающихся от предыдущего состояния.
+  TionStateChangeMask diff(const TionState &prev) const;
+  // Копирует поля из src по маске, поддерживаются только поля CALL_FIELDS.
+  void assign(const TionState &src, TionStateChangeMask fields);
+
   // backward compatibility methods
   bool is_initialized() const { return this->initialized || this->fan_speed > 0; }
   const char *get_gate_position_str(const TionTraits &traits) const;
@@ -176,49 +230,86 @@ class TionState {
 class TionApiBase;
 class TionStateCall {
  public:
+  /// Bits of changed fields.
+  enum ChangedField : uint8_t {
+    FAN_SPEED = 1 << 0,
+    POWER_STATE = 1 << 1,
+    HEATER_STATE = 1 << 2,
+    TARGET_TEMPERATURE = 1 << 3,
+    SOUND_STATE = 1 << 4,
+    LED_STATE = 1 << 5,
+    GATE_POSITION = 1 << 6,
+    AUTO_STATE = 1 << 7,
+  };
+
   TionStateCall(TionApiBase *api) : api_(api) {}
   virtual ~TionStateCall() {}
 
-  void set_fan_speed(uint8_t fan_speed) { this->fan_speed_ = fan_speed; }
-  void set_target_temperature(int8_t target_temperature) { this->target_temperature_ = target_temperature; }
-  void set_power_state(bool power_state) { this->power_state_ = power_state; }
-  void set_heater_state(bool heater_state) { this->heater_state_ = heater_state; }
-  void set_led_state(bool led_state) { this->led_state_ = led_state; }
-  void set_sound_state(bool sound_state) { this->sound_state_ = sound_state; }
-  void set_gate_position(TionGatePosition gate_position) { this->gate_position_ = gate_position; }
-  void set_auto_state(bool auto_state) { this->auto_state_ = auto_state; }
-
-  const optional<uint8_t> &get_fan_speed() const { return this->fan_speed_; }
-  const optional<bool> &get_power_state() const { return this->power_state_; }
-  const optional<bool> &get_heater_state() const { return this->heater_state_; }
-  const optional<int8_t> &get_target_temperature() const { return this->target_temperature_; }
-  const optional<bool> &get_sound_state() const { return this->sound_state_; }
-  const optional<bool> &get_led_state() const { return this->led_state_; }
-  const optional<TionGatePosition> &get_gate_position() const { return this->gate_position_; }
-  const optional<bool> &get_auto_state() const { return this->auto_state_; }
+  void set_fan_speed(uint8_t fan_speed) {
+    this->fan_speed_ = fan_speed;
+    this->changed_ |= FAN_SPEED;
+  }
+  void set_target_temperature(int8_t target_temperature) {
+    this->target_temperature_ = target_temperature;
+    this->changed_ |= TARGET_TEMPERATURE;
+  }
+  void set_power_state(bool power_state) { this->set_flag_(POWER_STATE, power_state); }
+  void set_heater_state(bool heater_state) { this->set_flag_(HEATER_STATE, heater_state); }
+  void set_led_state(bool led_state) { this->set_flag_(LED_STATE, led_state); }
+  void set_sound_state(bool sound_state) { this->set_flag_(SOUND_STATE, sound_state); }
+  void set_gate_position(TionGatePosition gate_position) {
+    this->gate_position_ = gate_position;
+    this->changed_ |= GATE_POSITION;
+  }
+  void set_auto_state(bool auto_state) { this->set_flag_(AUTO_STATE, auto_state); }
+
+  optional<uint8_t> get_fan_speed() const { return this->get_(FAN_SPEED, this->fan_speed_); }
+  optional<bool> get_power_state() const { return this->get_flag_(POWER_STATE); }
+  optional<bool> get_heater_state() const { return this->get_flag_(HEATER_STATE); }
+  optional<int8_t> get_target_temperature() const { return this->get_(TARGET_TEMPERATURE, this->target_temperature_); }
+  optional<bool> get_sound_state() const { return this->get_flag_(SOUND_STATE); }
+  optional<bool> get_led_state() const { return this->get_flag_(LED_STATE); }
+  optional<TionGatePosition> get_gate_position() const { return this->get_(GATE_POSITION, this->gate_position_); }
+  optional<bool> get_auto_state() const { return this->get_flag_(AUTO_STATE); }
+
+  /// Bitmask of ChangedField.
+  uint8_t get_changed() const { return this->changed_; }
+  bool has_changed(ChangedField field) const { return (this->changed_ & field) != 0; }
 
   // additional helper.
   void set_gate_state(bool gate_state) {
-    this->gate_position_ = gate_state ? TionGatePosition::OPENED : TionGatePosition::CLOSED;
+    this->set_gate_position(gate_state ? TionGatePosition::OPENED : TionGatePosition::CLOSED);
   }
 
   virtual void perform();
 
-  bool has_changes() const;
-  void reset();
+  bool has_changes() const { return this->changed_ != 0; }
+  void reset() { this->changed_ = 0; }
+  /// Applies changes of the other call over changes of this one.
+  void merge(const TionStateCall &other);
 
   void dump() const;
 
  protected:
   TionApiBase *api_;
-  optional<uint8_t> fan_speed_;
-  optional<bool> power_state_;
-  optional<bool> heater_state_;
-  optional<int8_t> target_temperature_;
-  optional<bool> sound_state_;
-  optional<bool> led_state_;
-  optional<TionGatePosition> gate_position_;
-  optional<bool> auto_state_;
+  // changed fields
+  uint8_t changed_{};
+  // values of bool fields, same bits as in changed_
+  uint8_t flags_{};
+  uint8_t fan_speed_{};
+  int8_t target_temperature_{};
+  TionGatePosition gate_position_{};
+
+  void set_flag_(ChangedField field, bool value) {
+    this->flags_ = value ? (this->flags_ | field) : (this->flags_ & ~field);
+    this->changed_ |= field;
+  }
+  optional<bool> get_flag_(ChangedField field) const {
+    return this->has_changed(field) ? optional<bool>((this->flags_ & field) != 0) : optional<bool>();
+  }
+  template<class T> optional<T> get_(ChangedField field, T value) const {
+    return this->has_changed(field) ? optional<T>(value) : optional<T>();
+  }
 };
 
 #define TION_REPORT_EC(tag, code, msg) TION_LOGW(tag, "EC%02u: %s", err, msg);
@@ -277,9 +368,51 @@ class TionApiBase {
   void set_on_ready(on_ready_type &&on_ready) { this->on_ready_ = std::move(on_ready); }
 
   /// Callback listener for response to request_state command request.
-  using on_state_type = std::function<void(const TionState &state, uint32_t request_id)>;
+  /// changes is a mask of fields changed since the previous state.
+  using on_state_type =
+      std::function<void(const TionState &state, uint32_t request_id, TionStateChangeMask changes)>;
   void set_on_state(on_state_type &&on_state) { this->on_state_ = std::move(on_state); }
 
+  /// Callback listener for completion of write state request.
+  /// confirmed is true if state response with the same request_id was received,
+  /// rtt is the time in ms since the request was sent first time.
+  using on_write_complete_type = std::function<void(uint32_t request_id, bool confirmed, uint32_t rtt)>;
+  void set_on_write_complete(on_write_complete_type &&on_write_complete) {
+    this->on_write_complete_ = std::move(on_write_complete);
+  }
+
+  /// Sets timeout in ms to wait for the write state confirmation and number of retries.
+  /// Each retry doubles the timeout.
+  void set_write_retry(uint32_t timeout, uint8_t max_retries) {
+    this->requests_.set_timeout(timeout);
+    this->requests_.set_max_retries(max_retries);
+  }
+  /// Resends or expires not confirmed write state requests. Must be called periodically.
+  virtual void check_requests();
+  /// Number of write state requests waiting for confirmation.
+  size_t get_pending_requests() const { return this->requests_.size(); }
+  /// Round trip time in ms of the last confirmed write state request.
+  uint32_t get_last_rtt() const { return this->last_rtt_; }
+#ifdef TION_ENABLE_TRACE
+  TionTrace &get_trace() { return this->trace_; }
+#endif
+
+  /// Publishes state predicted by write state request at once, without waiting for the breezer response.
+  /// Predicted fields are kept until the response with the same request_id, then values of the breezer win.
+  /// Works only for models tracking write state requests.
+  void set_optimistic(bool optimistic) { this->optimistic_ = optimistic; }
+  bool get_optimistic() const { return this->optimistic_; }
+  /// Returns true while state has predicted fields not confirmed by the breezer.
+  bool is_state_pending() const { return this->predicted_.fields != 0; }
+  /// Returns true only while on_state is called with predicted state.
+  bool is_state_predicted() const { return this->predicted_.notifying; }
+
+  using RequestPlanner = TionRequestPlanner<TION_MAX_PLANNED_REQUESTS>;
+  /// Changes freshness policy of the sub-request sent with the state request. Requests are model specific.
+  void set_request_policy(size_t request, RequestPlanner::Policy policy, uint32_t period = 0) {
+    this->planner_.set_policy(request, policy, period);
+  }
+
 #ifdef TION_ENABLE_HEARTBEAT
   /// Callback listener for response to send_heartbeat command request.
   using on_heartbeat_type = std::function<void(uint8_t work_mode)>;
@@ -290,6 +423,30 @@ class TionApiBase {
   const TionState &get_state() const { return this->state_; }
   const TionTraits &get_traits() const { return this->traits_; }
 
+  /// Last known state with traits reported by the breezer, allows to publish state at startup before the first
+  /// response.
+  struct Snapshot {
+    TionState state;
+    uint8_t max_fan_speed;
+    uint8_t max_heater_power;
+  };
+  Snapshot make_snapshot() const {
+    // zero initialized padding allows to compare snapshots with memcmp
+    Snapshot snapshot{};
+    snapshot.state = this->state_;
+    snapshot.max_fan_speed = this->traits_.max_fan_speed;
+    snapshot.max_heater_power = this->traits_.max_heater_power;
+    return snapshot;
+  }
+  /// Restores state from the snapshot and notifies it with all fields changed. The first received state is notified
+  /// with all fields changed too.
+  /// @return false if state is already received or snapshot is empty.
+  bool restore_snapshot(const Snapshot &snapshot);
+  /// Returns true while state is restored from the snapshot and not received from the breezer yet.
+  bool is_state_stale() const { return this->state_stale_; }
+  /// Holds changes of the call performed while state is stale, they are sent over the first received state.
+  void hold_call(const TionStateCall &call) { this->held_call_.merge(call); }
+
   virtual void request_state() = 0;
   virtual void write_state(TionStateCall *call) = 0;
   virtual void reset_filter() = 0;
@@ -333,7 +490,34 @@ class TionApiBase {
  protected:
   TionTraits traits_{};
   TionState state_{};
-  uint32_t request_id_{};
+  // 1 is used by the breezer for responses to regular state requests, so tracked ids start from 2.
+  uint32_t request_id_{1};
+
+  TionRequests<TionState, TION_MAX_PENDING_REQUESTS> requests_;
+  /// Sub-requests of the state request, indexes are defined by the model.
+  RequestPlanner planner_;
+  uint32_t last_rtt_{};
+  on_write_complete_type on_write_complete_{};
+  /// Tracks write state request until the state response with the same request_id is received.
+  void track_write_(uint32_t request_id, const TionState &state);
+  void complete_write_(uint32_t request_id);
+  /// Sends state again with the same request_id. Models without request_id do not track writes.
+  virtual bool resend_state_(const TionState &state, uint32_t request_id) { return false; }
+  /// Called when device info is restored from the snapshot, models complete their device info request here.
+  virtual void restore_dev_info_() {}
+
+  bool optimistic_{};
+  struct {
+    // state of the last write.
+    TionState state;
+    // fields predicted by writes and not confirmed yet.
+    TionStateChangeMask fields;
+    // request_id of the last write, its response confirms predicted fields.
+    uint32_t request_id;
+    bool notifying;
+  } predicted_{};
+  void predict_state_(uint32_t request_id, const TionState &state);
+  void reconcile_state_(uint32_t request_id);
 
   TionState make_write_state_(TionStateCall *call) const;
 
@@ -364,6 +548,16 @@ class TionApiBase {
   on_heartbeat_type on_heartbeat_{};
 #endif
 
+  // last state passed to on_state_, changes are calculated against it.
+  TionState notified_state_{};
+  // traits at the last on_state_, entities depending on them are republished when they change.
+  TionTraits notified_traits_{};
+  bool state_stale_{};
+  // changes performed while state is stale.
+  TionStateCall held_call_{this};
+#ifdef TION_ENABLE_TRACE
+  TionTrace trace_;
+#endif
   void notify_state_(uint32_t request_id);
 
   void boost_enable_(uint16_t boost_time, TionStateCall *call);
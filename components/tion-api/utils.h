@@ -18,6 +18,7 @@ inline std::string tion_hexencode(const void *data, uint32_t size) {
 }
 inline void yield() { esphome::yield(); }
 inline uint32_t millis() { return esphome::millis(); }
+inline uint32_t micros() { return esphome::micros(); }
 using esphome::optional;
 using esphome::str_sprintf;
 #else
@@ -13,6 +13,7 @@ from esphome.const import (
     CONF_ID,
     CONF_LAMBDA,
     CONF_ON_STATE,
+    CONF_OPTIMISTIC,
     CONF_POWER,
     CONF_RESTORE_STATE,
     CONF_TEMPERATURE,
@@ -44,6 +45,17 @@ CONF_WORK_TIME = "work_time"
 CONF_STATE_TIMEOUT = "state_timeout"
 CONF_STATE_WARNOUT = "state_warnout"
 CONF_BATCH_TIMEOUT = "batch_timeout"
+CONF_BATCH_MAX_LATENCY = "batch_max_latency"
+CONF_RESPONSE_TIMEOUT = "response_timeout"
+CONF_FAST_BOOT = "fast_boot"
+CONF_SAVE_INTERVAL = "save_interval"
+CONF_IO_TASK = "io_task"
+
+CONF_ADAPTIVE_POLLING = "adaptive_polling"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_MAX_INTERVAL = "max_interval"
+CONF_BACKOFF = "backoff"
+CONF_FAST_WINDOW = "fast_window"
 
 CONF_AUTO_CO2 = CONF_CO2
 CONF_AUTO_SETPOINT = "setpoint"
@@ -59,9 +71,13 @@ dentra_tion_ns = cg.global_ns.namespace("dentra").namespace("tion")
 
 TionVPortApi = tion_ns.class_("TionVPortApi")
 TionApiComponent = tion_ns.class_("TionApiComponent", cg.Component)
+TionVPortUARTComponent = tion_ns.class_(
+    "TionVPortUARTComponent", cg.Component, vport.VPort
+)
 
 TionStateRef = dentra_tion_ns.namespace("TionState").operator("ref").operator("const")
 TionGatePosition = dentra_tion_ns.namespace("TionGatePosition")
+TionBlackBoxRecord = dentra_tion_ns.namespace("TionBlackBoxRecord")
 
 StateTrigger = tion_ns.class_("StateTrigger", automation.Trigger.template(TionStateRef))
 
@@ -136,6 +152,35 @@ AUTO_SCHEMA = cv.Schema(
 )
 
 
+def _validate_adaptive_polling(config: dict):
+    if config[CONF_MAX_INTERVAL] < config[CONF_MIN_INTERVAL]:
+        raise cv.Invalid(f"{CONF_MAX_INTERVAL} must be not less than {CONF_MIN_INTERVAL}")
+    return config
+
+
+ADAPTIVE_POLLING_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_MIN_INTERVAL, default="1s"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(milliseconds=100)),
+            ),
+            cv.Optional(CONF_MAX_INTERVAL, default="5min"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(milliseconds=100)),
+            ),
+            cv.Optional(CONF_BACKOFF, default=2.0): cv.float_range(
+                min=1.0, min_included=False, max=10.0
+            ),
+            cv.Optional(
+                CONF_FAST_WINDOW, default="30s"
+            ): cv.positive_time_period_milliseconds,
+        }
+    ),
+    _validate_adaptive_polling,
+)
+
+
 def check_type(key, typ, required: bool = False):
     return cgp.validate_type(key, typ, required)
 
@@ -152,12 +197,25 @@ CONFIG_SCHEMA = cv.All(
                 cv.Optional(
                     CONF_BATCH_TIMEOUT, default="200ms"
                 ): cv.positive_time_period_milliseconds,
+                cv.Optional(
+                    CONF_BATCH_MAX_LATENCY, default="1s"
+                ): cv.positive_time_period_milliseconds,
+                cv.Optional(
+                    CONF_RESPONSE_TIMEOUT, default="250ms"
+                ): cv.positive_time_period_milliseconds,
                 cv.Optional(CONF_FORCE_UPDATE): cv.boolean,
+                cv.Optional(CONF_OPTIMISTIC): cv.boolean,
+                cv.Optional(CONF_ADAPTIVE_POLLING): ADAPTIVE_POLLING_SCHEMA,
                 cv.Optional(CONF_PRESETS): cv.Schema({cv.string_strict: PRESET_SCHEMA}),
                 cv.Optional(CONF_ON_STATE): cgp.automation_schema(StateTrigger),
                 cv.Optional(CONF_AUTO): AUTO_SCHEMA,
                 cv.Optional(CONF_RESTORE_STATE, default=False): cv.boolean,
+                cv.Optional(CONF_FAST_BOOT, default=False): cv.boolean,
+                cv.Optional(
+                    CONF_SAVE_INTERVAL, default="10min"
+                ): cv.positive_time_period_milliseconds,
                 cv.Optional(CONF_ENABLE_KIV, default=False): cv.boolean,
+                cv.Optional(CONF_IO_TASK): cv.All(cv.only_on_esp32, cv.boolean),
             }
         )
         .extend(vport.VPORT_CLIENT_SCHEMA)
@@ -187,12 +245,24 @@ async def _setup_tion_api(config: dict):
 
     prt, api = await new_vport_api_wrapper(config, component_class)
     cg.add(prt.set_api(api))
+    cg.add(api.set_response_timeout(config[CONF_RESPONSE_TIMEOUT]))
+    cg.add(api.set_link_stats(prt.get_link_stats()))
+    cg.add(
+        api.set_blackbox_source(
+            prt.get_type(),
+            getattr(TionBlackBoxRecord, f"MODEL_{config[CONF_TYPE].upper()}"),
+        )
+    )
 
     component_id: ID = config[CONF_ID]
     component_id.type = component_class
     var = cg.new_Pvariable(config[CONF_ID], api, prt.get_type())
     await cg.register_component(var, config)
 
+    if vport.vport_find(config).type.inherits_from(TionVPortUARTComponent):
+        cg.add(var.set_keepalive(prt.get_keepalive()))
+    cg.add(var.set_link_stats(prt.get_link_stats()))
+
     component_source = f"tion[type={config[CONF_TYPE]}]"
 
     if cv.Version.parse(ESPHOME_VERSION) >= cv.Version.parse("2025.9.0"):
@@ -207,7 +277,19 @@ async def _setup_tion_api(config: dict):
 
     cg.add(var.set_state_timeout(config[CONF_STATE_TIMEOUT]))
     cg.add(var.set_batch_timeout(config[CONF_BATCH_TIMEOUT]))
+    cg.add(var.set_batch_max_latency(config[CONF_BATCH_MAX_LATENCY]))
     cgp.setup_value(config, CONF_FORCE_UPDATE, var.set_force_update)
+    cgp.setup_value(config, CONF_OPTIMISTIC, var.set_optimistic)
+    if CONF_ADAPTIVE_POLLING in config:
+        polling = config[CONF_ADAPTIVE_POLLING]
+        cg.add(
+            var.set_adaptive_polling(
+                polling[CONF_MIN_INTERVAL],
+                polling[CONF_MAX_INTERVAL],
+                polling[CONF_BACKOFF],
+                polling[CONF_FAST_WINDOW],
+            )
+        )
 
     return var
 
@@ -313,11 +395,22 @@ async def to_code(config: dict):
         await cgp.setup_automation(conf, CONF_ON_STATE, var, (TionStateRef, "x"))
         if CONF_AUTO in conf:
             await _setup_auto(conf[CONF_AUTO], var)
+        if conf[CONF_RESTORE_STATE] or conf[CONF_FAST_BOOT]:
+            cg.add(var.set_save_interval(conf[CONF_SAVE_INTERVAL]))
         if conf[CONF_RESTORE_STATE]:
             cg.add_define("USE_TION_RESTORE_STATE")
             cg.add(var.set_rtc_key(f"{conf[CONF_ID].id}-v2"))
+        if conf[CONF_FAST_BOOT]:
+            cg.add_define("USE_TION_FAST_BOOT")
+            cg.add(
+                var.set_snapshot_key(
+                    f"{conf[CONF_ID].id}-{conf[CONF_TYPE]}-snapshot-v1"
+                )
+            )
         if CONF_ENABLE_KIV:
             cg.add_build_flag("-DTION_ENABLE_KIV")
+        if conf.get(CONF_IO_TASK, False):
+            cg.add_define("USE_TION_IO_TASK")
 
 
 def new_pc(pc_cfg: dict[str, str | dict[str, Any]]):
@@ -39,17 +39,20 @@ class TionBinarySensor : public binary_sensor::BinarySensor, public Component, p
     if (!PC::is_supported(this)) {
       return;
     }
-    this->parent_->add_on_state_callback([this](const TionState *state) {
-      if (!PC::publish_state(this, state)) {
-        this->set_has_state(false);
+    this->parent_->add_on_state_entity(this, PC::changes(), [](void *entity, const TionState *state) {
+      auto *sens = static_cast<TionBinarySensor *>(entity);
+      if (!PC::publish_state(sens, state)) {
+        sens->set_has_state(false);
 #if ESPHOME_VERSION_CODE < VERSION_CODE(2025, 7, 0)
-        this->state_callback_.call(false);
+        sens->state_callback_.call(false);
 #elif ESPHOME_VERSION_CODE < VERSION_CODE(2025, 11, 5)
-        this->set_state_({});
+        sens->set_state_({});
 #else
-        this->set_new_state({});
+        sens->set_new_state({});
 #endif
+        return false;
       }
+      return true;
     });
   }
 };
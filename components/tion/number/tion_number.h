@@ -69,10 +69,13 @@ template<class C> class TionNumber : public number::Number, public Component, pu
       }
     }
 
-    this->parent_->add_on_state_callback([this](const TionState *state) {
-      if (!PC::publish_state(this, state)) {
-        this->set_has_state(false);
+    this->parent_->add_on_state_entity(this, PC::changes(), [](void *entity, const TionState *state) {
+      auto *num = static_cast<TionNumber *>(entity);
+      if (!PC::publish_state(num, state)) {
+        num->set_has_state(false);
+        return false;
       }
+      return true;
     });
   }
 
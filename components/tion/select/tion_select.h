@@ -46,16 +46,18 @@ template<class C> class TionSelect : public select::Select, public Component, pu
     for (auto &&opt : options) {
       ESP_LOGD(TAG, "  '%s'", opt);
     }
-    this->parent_->add_on_state_callback([this](const TionState *state) {
+    this->parent_->add_on_state_entity(this, PC::changes(), [](void *entity, const TionState *state) {
+      auto *sel = static_cast<TionSelect *>(entity);
       if (state) {
         if constexpr (PC::checker().has_api_get()) {
-          this->internal_publish_state_(C::get(this->parent_));
+          sel->internal_publish_state_(C::get(sel->parent_));
         } else {
-          this->internal_publish_state_(C::get(*state, this->traits.get_options()));
+          sel->internal_publish_state_(C::get(*state, sel->traits.get_options()));
         }
       } else {
-        this->set_has_state(false);
+        sel->set_has_state(false);
       }
+      return sel->has_state();
     });
   }
 
@@ -18,6 +18,7 @@ from esphome.const import (
     UNIT_CUBIC_METER,
     UNIT_CUBIC_METER_PER_HOUR,
     UNIT_KILOWATT,
+    UNIT_MILLISECOND,
     UNIT_PERCENT,
     UNIT_SECOND,
     UNIT_WATT,
@@ -28,6 +29,34 @@ from .. import cgp, new_pc, tion_ns
 TionSensor = tion_ns.class_("TionSensor", sensor.Sensor, cg.Component)
 
 UNIT_DAYS = "d"
+UNIT_PER_MINUTE = "1/min"
+UNIT_BYTES_PER_MINUTE = "B/min"
+
+KEEPALIVE_SENSOR = {
+    CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+    CONF_STATE_CLASS: STATE_CLASS_MEASUREMENT,
+    CONF_ICON: "mdi:timer-outline",
+    CONF_UNIT_OF_MEASUREMENT: UNIT_MILLISECOND,
+    CONF_ACCURACY_DECIMALS: 0,
+}
+
+LINK_SENSOR = {
+    CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+    CONF_STATE_CLASS: STATE_CLASS_MEASUREMENT,
+    CONF_ICON: "mdi:swap-horizontal",
+    CONF_UNIT_OF_MEASUREMENT: UNIT_PER_MINUTE,
+    CONF_ACCURACY_DECIMALS: 0,
+}
+
+LINK_BYTES_SENSOR = {
+    **LINK_SENSOR,
+    CONF_UNIT_OF_MEASUREMENT: UNIT_BYTES_PER_MINUTE,
+}
+
+LINK_ERRORS_SENSOR = {
+    **LINK_SENSOR,
+    CONF_ICON: "mdi:alert-circle-outline",
+}
 
 PC = new_pc(
     {
@@ -163,6 +192,25 @@ PC = new_pc(
             CONF_UNIT_OF_MEASUREMENT: UNIT_SECOND,
             CONF_ACCURACY_DECIMALS: 0,
         },
+        "flash_writes": {
+            CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+            CONF_STATE_CLASS: STATE_CLASS_TOTAL_INCREASING,
+            CONF_ICON: "mdi:content-save",
+            CONF_ACCURACY_DECIMALS: 0,
+        },
+        "keepalive_p50": KEEPALIVE_SENSOR,
+        "keepalive_p99": KEEPALIVE_SENSOR,
+        "keepalive_max": KEEPALIVE_SENSOR,
+        "link_rx_frames": LINK_SENSOR,
+        "link_rx_bytes": LINK_BYTES_SENSOR,
+        "link_tx_frames": LINK_SENSOR,
+        "link_tx_bytes": LINK_BYTES_SENSOR,
+        "link_crc_errors": LINK_ERRORS_SENSOR,
+        "link_bad_magic": LINK_ERRORS_SENSOR,
+        "link_oversize": LINK_ERRORS_SENSOR,
+        "link_resyncs": LINK_ERRORS_SENSOR,
+        "link_drops": LINK_ERRORS_SENSOR,
+        "link_timeouts": LINK_ERRORS_SENSOR,
         # aliases
         "fan": "fan_speed",
         "speed": "fan_speed",
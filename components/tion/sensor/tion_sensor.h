@@ -37,11 +37,14 @@ template<class C> class TionSensor : public sensor::Sensor, public Component, pu
     if (!PC::is_supported(this)) {
       return;
     }
-    this->parent_->add_on_state_callback([this](const TionState *state) {
-      if (!PC::publish_state(this, state)) {
-        this->set_has_state(false);
-        this->callback_.call(NAN);
+    this->parent_->add_on_state_entity(this, PC::changes(), [](void *entity, const TionState *state) {
+      auto *sens = static_cast<TionSensor *>(entity);
+      if (!PC::publish_state(sens, state)) {
+        sens->set_has_state(false);
+        sens->callback_.call(NAN);
+        return false;
       }
+      return true;
     });
   }
 };
@@ -41,8 +41,12 @@ template<class C> class TionSwitch : public switch_::Switch, public Component, p
     if (!PC::is_supported(this)) {
       return;
     }
-    this->parent_->add_on_state_callback(
-        [this](const TionState *state) { this->set_has_state(PC::publish_state(this, state)); });
+    this->parent_->add_on_state_entity(this, PC::changes(), [](void *entity, const TionState *state) {
+      auto *sw = static_cast<TionSwitch *>(entity);
+      const bool has_state = PC::publish_state(sw, state);
+      sw->set_has_state(has_state);
+      return has_state;
+    });
   }
 
   bool assumed_state() override { return this->is_failed(); }
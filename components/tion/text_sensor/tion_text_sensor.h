@@ -35,11 +35,14 @@ class TionTextSensor : public text_sensor::TextSensor, public Component, public
   void setup() override {
     ESP_LOGD(TAG, "Setting up %s...", this->get_name().c_str());
 
-    this->parent_->add_on_state_callback([this](const TionState *state) {
-      if (!PC::publish_state(this, state)) {
-        this->set_has_state(false);
-        this->callback_.call("");
+    this->parent_->add_on_state_entity(this, PC::changes(), [](void *entity, const TionState *state) {
+      auto *sens = static_cast<TionTextSensor *>(entity);
+      if (!PC::publish_state(sens, state)) {
+        sens->set_has_state(false);
+        sens->callback_.call("");
+        return false;
       }
+      return true;
     });
   }
 };
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cinttypes>
 #include <ctime>
 
@@ -10,38 +11,88 @@ namespace tion {
 
 static const char *const TAG = "tion_api_component";
 static const char *const STATE_TIMEOUT = "state_timeout";
-static const char *const BATCH_TIMEOUT = "batch_timeout";
+static const char *const LINK_SUMMARY = "link_summary";
+static constexpr uint32_t LINK_SUMMARY_INTERVAL = 60 * 1000;
+
+using dentra::tion::TionLinkStats;
+static constexpr dentra::tion::TionLinkCounter TionLinkStats::*const LINK_COUNTERS[] = {
+    &TionLinkStats::rx_frames,  &TionLinkStats::rx_bytes,  &TionLinkStats::tx_frames, &TionLinkStats::tx_bytes,
+    &TionLinkStats::crc_errors, &TionLinkStats::bad_magic, &TionLinkStats::oversize,  &TionLinkStats::resyncs,
+    &TionLinkStats::drops,      &TionLinkStats::timeouts,
+};
+static_assert(sizeof(LINK_COUNTERS) / sizeof(LINK_COUNTERS[0]) * sizeof(dentra::tion::TionLinkCounter) ==
+                  sizeof(TionLinkStats),
+              "LINK_COUNTERS must contain all counters");
 
 void TionApiComponent::BatchStateCall::perform() {
-  this->start_time_ = millis();
-  if (this->c_->batch_timeout_) {
-    this->c_->set_timeout(BATCH_TIMEOUT, this->c_->batch_timeout_, [this]() { this->perform_(); });
-  } else {
+  if (this->c_->batch_timeout_ == 0 || this->is_priority_()) {
     this->perform_();
+    return;
+  }
+  const auto now = millis();
+  if (!this->pending_) {
+    this->pending_ = true;
+    this->start_time_ = now;
+  }
+  this->deadline_ = now + this->c_->batch_timeout_;
+  if (this->c_->batch_max_latency_ != 0) {
+    const auto max_deadline = this->start_time_ + this->c_->batch_max_latency_;
+    if (static_cast<int32_t>(this->deadline_ - max_deadline) > 0) {
+      this->deadline_ = max_deadline;
+    }
   }
 }
 
+bool TionApiComponent::BatchStateCall::is_priority_() const {
+  if (!this->get_power_state().value_or(true)) {
+    return true;
+  }
+  // heater in frost is urgent only for breezers relying on manual antifreeze, as in TionApiBase::notify_state_
+  if (!this->c_->traits().supports_manual_antifreeze) {
+    return false;
+  }
+  const auto &state = this->c_->state();
+  return this->get_heater_state().value_or(false) && state.power_state && state.outdoor_temperature < 0;
+}
+
 void TionApiComponent::BatchStateCall::perform_() {
   ESP_LOGD(TAG, "Write out batch changes");
 #ifdef TION_ENABLE_API_CONTROL_CALLBACK
   this->c_->control_callback_.call(this);
 #endif
+  this->pending_ = false;
   dentra::tion::TionStateCall::perform();
-  this->start_time_ = 0;
   this->c_->state_check_schedule_();
+  this->c_->poll_fast_();
 }
 
 void TionApiComponent::call_setup() {
+  this->load_snapshot_();
   PollingComponent::call_setup();
-  if (this->state_timeout_ >= this->get_update_interval()) {
+  if (this->poll_.min_interval != 0) {
+    // state is requested from call_loop
+    this->stop_poller();
+    this->poll_.next_time = millis() + this->poll_.min_interval;
+  } else if (this->state_timeout_ >= this->get_update_interval()) {
     ESP_LOGW(TAG, "Invalid state timeout: %.1f s", this->state_timeout_ * 0.001f);
     this->state_timeout_ = 0;
   }
+  if (this->link_stats_ != nullptr) {
+    this->set_interval(LINK_SUMMARY, LINK_SUMMARY_INTERVAL, [this]() { this->link_summary_(); });
+  }
 }
 
 // обработка и обновление App.app_state_ происходит только для компонентов
 // переопределяющих loop или call_loop (см. application.cpp:148)
-void TionApiComponent::call_loop() { PollingComponent::call_loop(); }
+void TionApiComponent::call_loop() {
+  PollingComponent::call_loop();
+  this->batch_call_.check(millis());
+  this->api_->check_requests();
+  this->check_prefs_();
+  if (this->poll_.min_interval != 0 && static_cast<int32_t>(millis() - this->poll_.next_time) >= 0) {
+    this->update();
+  }
+}
 
 void TionApiComponent::dump_config() {
 #if ESPHOME_VERSION_CODE < VERSION_CODE(2025, 9, 0)
@@ -49,31 +100,107 @@ void TionApiComponent::dump_config() {
 #else
   ESP_LOGCONFIG(TAG, "%s:", LOG_STR_ARG(this->get_component_log_str()));
 #endif
-  LOG_UPDATE_INTERVAL(this);
+  if (this->poll_.min_interval != 0) {
+    ESP_LOGCONFIG(TAG, "  Adaptive polling: %.1f s - %.1f s, backoff %.1f, fast window %.1f s",
+                  this->poll_.min_interval * 0.001f, this->poll_.max_interval * 0.001f, this->poll_.backoff,
+                  this->poll_.fast_window * 0.001f);
+  } else {
+    LOG_UPDATE_INTERVAL(this);
+  }
   ESP_LOGCONFIG(TAG, "  Force update: %s", ONOFF(this->force_update_));
+  ESP_LOGCONFIG(TAG, "  Optimistic: %s", ONOFF(this->api_->get_optimistic()));
   ESP_LOGCONFIG(TAG, "  State timeout: %.1f s", this->state_timeout_ * 0.001f);
-  ESP_LOGCONFIG(TAG, "  Batch timeout: %.1f s", this->batch_timeout_ * 0.001f);
+  ESP_LOGCONFIG(TAG, "  Batch timeout: %.1f s, max latency: %.1f s", this->batch_timeout_ * 0.001f,
+                this->batch_max_latency_ * 0.001f);
+#if defined(USE_TION_RESTORE_STATE) || defined(USE_TION_FAST_BOOT)
+  ESP_LOGCONFIG(TAG, "  Save interval: %.1f s", this->save_interval_ * 0.001f);
+#endif
   if (this->traits().supports_manual_antifreeze) {
     ESP_LOGCONFIG(TAG, "  Manual antifreeze: enabled");
   }
+#ifdef TION_ENABLE_TRACE
+  this->api_->get_trace().dump(TAG);
+#endif
+  if (this->link_stats_ != nullptr) {
+    const auto &stats = *this->link_stats_;
+    ESP_LOGCONFIG(TAG, "  Link: rx %" PRIu32 " frames (%" PRIu32 " bytes), tx %" PRIu32 " frames (%" PRIu32 " bytes)",
+                  stats.rx_frames.load(), stats.rx_bytes.load(), stats.tx_frames.load(), stats.tx_bytes.load());
+    ESP_LOGCONFIG(TAG,
+                  "  Link errors: crc %" PRIu32 ", magic %" PRIu32 ", size %" PRIu32 ", resync %" PRIu32
+                  ", drop %" PRIu32 ", timeout %" PRIu32,
+                  stats.crc_errors.load(), stats.bad_magic.load(), stats.oversize.load(), stats.resyncs.load(),
+                  stats.drops.load(), stats.timeouts.load());
+  }
 }
 
 void TionApiComponent::update() {
   this->api_->request_state();
+  if (this->poll_.min_interval != 0) {
+    // keep current interval until response
+    this->poll_.next_time = millis() + this->poll_.interval;
+    if (this->state_check_pending_) {
+      return;
+    }
+  }
   this->state_check_schedule_();
 }
 
-void TionApiComponent::on_state_(const TionState &state, const uint32_t request_id) {
-  ESP_LOGV(TAG, "State received, request_id: %" PRIu32, request_id);
-  // clear error reporting
-  this->status_clear_error();
-  this->cancel_timeout(STATE_TIMEOUT);
+void TionApiComponent::poll_fast_() {
+  if (this->poll_.min_interval == 0) {
+    return;
+  }
+  const auto now = millis();
+  this->poll_.fast_until = now + this->poll_.fast_window;
+  this->poll_.interval = this->poll_.min_interval;
+  this->poll_.next_time = now + this->poll_.interval;
+}
+
+void TionApiComponent::poll_schedule_(TionStateChangeMask changes) {
+  const auto now = millis();
+  if ((changes & ~POLL_IGNORED_CHANGES) != 0 || static_cast<int32_t>(now - this->poll_.fast_until) < 0) {
+    this->poll_.interval = this->poll_.min_interval;
+  } else {
+    const auto interval = static_cast<uint32_t>(this->poll_.interval * this->poll_.backoff);
+    this->poll_.interval = std::min(interval, this->poll_.max_interval);
+  }
+  ESP_LOGV(TAG, "Next poll in %.1f s", this->poll_.interval * 0.001f);
+  this->poll_.next_time = now + this->poll_.interval;
+}
+
+void TionApiComponent::on_state_(const TionState &state, const uint32_t request_id, TionStateChangeMask changes) {
+  ESP_LOGV(TAG, "State received, request_id: %" PRIu32 ", changes: 0x%08" PRIX32, request_id, changes);
+  if (this->api_->is_state_stale()) {
+    // cached state is published at once and replaced by the first received one
+    this->publish_entities_(&state, changes);
+    this->state_callback_.call(&state, changes);
+    return;
+  }
+  // predicted state is not received from the breezer
+  if (!this->api_->is_state_predicted()) {
+    // clear error reporting
+    this->status_clear_error();
+    this->cancel_timeout(STATE_TIMEOUT);
+    this->state_check_pending_ = false;
+  }
+  if (this->poll_.min_interval != 0) {
+    this->poll_schedule_(changes);
+  }
+  this->state_changes_ |= changes;
   // notify state
   this->defer([this]() {
+    TION_TRACE_DEFER(this->api_->get_trace());
     // загружаем запомненное состояние только после установки соединения
     if (!this->load_state_()) {
-      this->state_callback_.call(&this->state());
-      this->save_state_();
+      const auto changes = this->force_update_ ? TionState::ALL_FIELDS : this->state_changes_;
+      this->state_changes_ = 0;
+      this->publish_entities_(&this->state(), changes);
+      this->state_callback_.call(&this->state(), changes);
+      TION_TRACE_PUBLISH(this->api_->get_trace());
+      // do not save not confirmed state
+      if (!this->api_->is_state_pending()) {
+        this->save_state_();
+        this->save_snapshot_();
+      }
     }
   });
 }
@@ -81,7 +208,8 @@ void TionApiComponent::on_state_(const TionState &state, const uint32_t request_
 bool TionApiComponent::load_state_() {
 #ifdef USE_TION_RESTORE_STATE
   if (this->rtc_hash_ != 0) {
-    this->rtc_pref_ = global_preferences->make_preference<TionApiBase::PresetData>(this->rtc_hash_, true);
+    this->rtc_pref_.init(global_preferences->make_preference<TionApiBase::PresetData>(this->rtc_hash_, true),
+                         this->save_interval_);
     this->rtc_hash_ = 0;  // сбрасываем ключ чтобы не пытаться восстановить данные повторно
     TionApiBase::PresetData rtc_data{};
     if (this->rtc_pref_.load(&rtc_data)) {
@@ -115,16 +243,130 @@ void TionApiComponent::save_state_() {
       data.power_state = -1;
     }
   }
-  TionApiBase::PresetData rtc_data;  // не инициализируем, все поля будут заполнены из load
-  if (!this->rtc_pref_.load(&rtc_data) || memcmp(&data, &rtc_data, sizeof(data)) != 0) {
-    ESP_LOGD(TAG, "Saving state");
-    this->rtc_pref_.save(&data);
+  // запись во флеш откладывается и объединяется с последующими изменениями
+  this->rtc_pref_.save(data, millis());
+#endif
+}
+
+void TionApiComponent::load_snapshot_() {
+#ifdef USE_TION_FAST_BOOT
+  if (this->snapshot_hash_ == 0) {
+    return;
+  }
+  this->snapshot_pref_.init(global_preferences->make_preference<TionApiBase::Snapshot>(this->snapshot_hash_, false),
+                            this->save_interval_);
+  this->snapshot_hash_ = 0;
+  TionApiBase::Snapshot snapshot;
+  if (this->snapshot_pref_.load(&snapshot) && this->api_->restore_snapshot(snapshot)) {
+    ESP_LOGI(TAG, "Published cached state");
+  }
+#endif
+}
+
+void TionApiComponent::save_snapshot_() {
+#ifdef USE_TION_FAST_BOOT
+  if (!this->snapshot_pref_.is_initialized()) {
+    return;
+  }
+  const auto snapshot = this->api_->make_snapshot();
+  const auto &saved = this->snapshot_pref_.get();
+  // пишем только при изменении пользовательских настроек
+  if ((snapshot.state.diff(saved.state) & SNAPSHOT_FIELDS) == 0 &&
+      snapshot.max_fan_speed == saved.max_fan_speed && snapshot.max_heater_power == saved.max_heater_power) {
+    return;
   }
+  this->snapshot_pref_.save(snapshot, millis());
 #endif
 }
 
+void TionApiComponent::check_prefs_() {
+#if defined(USE_TION_RESTORE_STATE) || defined(USE_TION_FAST_BOOT)
+  const auto now = millis();
+#ifdef USE_TION_RESTORE_STATE
+  this->rtc_pref_.check(now);
+#endif
+#ifdef USE_TION_FAST_BOOT
+  this->snapshot_pref_.check(now);
+#endif
+#endif
+}
+
+void TionApiComponent::flush_prefs_() {
+#if defined(USE_TION_RESTORE_STATE) || defined(USE_TION_FAST_BOOT)
+  bool flushed = false;
+  const auto now = millis();
+#ifdef USE_TION_RESTORE_STATE
+  flushed |= this->rtc_pref_.flush(now);
+#endif
+#ifdef USE_TION_FAST_BOOT
+  flushed |= this->snapshot_pref_.flush(now);
+#endif
+  if (flushed) {
+    ESP_LOGD(TAG, "Flushed pending state");
+    global_preferences->sync();
+  }
+#endif
+}
+
+uint32_t TionApiComponent::get_flash_writes() const {
+  uint32_t writes = 0;
+#ifdef USE_TION_RESTORE_STATE
+  writes += this->rtc_pref_.get_writes();
+#endif
+#ifdef USE_TION_FAST_BOOT
+  writes += this->snapshot_pref_.get_writes();
+#endif
+  return writes;
+}
+
+float TionApiComponent::get_keepalive_interval(uint8_t percentile) const {
+  if (this->keepalive_ == nullptr || this->keepalive_->get_jitter().get_count() == 0) {
+    return NAN;
+  }
+  const auto &jitter = this->keepalive_->get_jitter();
+  return percentile >= 100 ? jitter.get_max() : jitter.get_percentile(percentile);
+}
+
+float TionApiComponent::get_link_rate(dentra::tion::TionLinkCounter TionLinkStats::*counter) const {
+  if (!this->link_rate_ready_) {
+    return NAN;
+  }
+  return (this->link_rate_.*counter).load();
+}
+
+void TionApiComponent::link_summary_() {
+  for (auto counter : LINK_COUNTERS) {
+    // counters are incremented by the I/O task, so each one is read once to keep rate and previous value consistent
+    const uint32_t value = (this->link_stats_->*counter).load();
+    this->link_rate_.*counter = value - (this->link_prev_.*counter).load();
+    this->link_prev_.*counter = value;
+  }
+  this->link_rate_ready_ = true;
+  const auto &rate = this->link_rate_;
+  if (rate.errors() == 0) {
+    ESP_LOGV(TAG, "Link per minute: rx %" PRIu32 ", tx %" PRIu32 " frames", rate.rx_frames.load(),
+             rate.tx_frames.load());
+    return;
+  }
+  ESP_LOGW(TAG,
+           "Link errors per minute: crc %" PRIu32 ", magic %" PRIu32 ", size %" PRIu32 ", resync %" PRIu32
+           ", drop %" PRIu32 ", timeout %" PRIu32 " of %" PRIu32 " rx frames",
+           rate.crc_errors.load(), rate.bad_magic.load(), rate.oversize.load(), rate.resyncs.load(), rate.drops.load(),
+           rate.timeouts.load(), rate.rx_frames.load());
+}
+
 void TionApiComponent::state_check_schedule_() {
+  this->state_check_pending_ = true;
   this->set_timeout(STATE_TIMEOUT, this->state_timeout_, [this]() {
+    this->state_check_pending_ = false;
+    // cached state is kept while connection is established after boot
+    if (this->api_->is_state_stale() && millis() < TION_SNAPSHOT_TIMEOUT) {
+      ESP_LOGD(TAG, "State was not received yet, keeping cached state");
+      return;
+    }
+    if (this->link_stats_ != nullptr) {
+      this->link_stats_->timeouts++;
+    }
     // error reporting
     if (this->status_has_error()) {
       ESP_LOGW(TAG, "State was not received in %.1f s", this->state_timeout_ * 0.001f);
@@ -132,14 +374,30 @@ void TionApiComponent::state_check_schedule_() {
       this->status_set_error(str_sprintf("State was not received in %.1f s", this->state_timeout_ * 0.001f).c_str());
     }
     // notify subscribers
-    this->state_callback_.call(nullptr);
+    this->publish_entities_(nullptr, 0);
+    this->state_callback_.call(nullptr, 0);
   });
 }
 
+void TionApiComponent::publish_entities_(const TionState *state, TionStateChangeMask changes) {
+  for (auto &e : this->state_entities_) {
+    // entity without state and entity depending on all fields always gets the state
+    const auto fields = e.changes & ~StateEntity::HAS_STATE;
+    const bool has_state = (e.changes & StateEntity::HAS_STATE) != 0;
+    if (state != nullptr && has_state && fields != StateEntity::ALL_FIELDS && (fields & changes) == 0) {
+      continue;
+    }
+    if (e.publish(e.entity, state)) {
+      e.changes |= StateEntity::HAS_STATE;
+    } else {
+      e.changes &= ~StateEntity::HAS_STATE;
+    }
+  }
+}
+
 dentra::tion::TionStateCall *TionApiComponent::make_call() {
-  const auto batch_start_time = this->batch_call_.get_start_time();
-  if (batch_start_time != 0) {
-    ESP_LOGD(TAG, "Continue batch update: %" PRIu32 " ms", millis() - batch_start_time);
+  if (this->batch_call_.is_pending()) {
+    ESP_LOGD(TAG, "Continue batch update: %" PRIu32 " ms", millis() - this->batch_call_.get_start_time());
   } else {
     ESP_LOGD(TAG, "Starting batch update: %" PRIu32 " ms", this->batch_timeout_);
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "esphome/core/defines.h"
 #include "esphome/core/log.h"
@@ -20,6 +21,7 @@
 #ifdef USE_TION_LT
 #include "../tion-api/tion-api-lt.h"
 #endif
+#include "tion_keepalive.h"
 #include "tion_vport.h"
 #include "tion_prefs.h"
 
@@ -36,6 +38,7 @@ class TionApiComponent : public PollingComponent {
  protected:
   using TionApiBase = dentra::tion::TionApiBase;
   using TionState = dentra::tion::TionState;
+  using TionStateChangeMask = dentra::tion::TionStateChangeMask;
   using TionStateCall = dentra::tion::TionStateCall;
   using TionGatePosition = dentra::tion::TionGatePosition;
 
@@ -48,22 +51,40 @@ class TionApiComponent : public PollingComponent {
     void perform() override;
 
     uint32_t get_start_time() const { return this->start_time_; };
+    bool is_pending() const { return this->pending_; }
+
+    /// Writes out pending changes when deadline is reached, called from loop.
+    void check(uint32_t now) {
+      if (this->pending_ && static_cast<int32_t>(now - this->deadline_) >= 0) {
+        this->perform_();
+      }
+    }
 
    protected:
     TionApiComponent *c_;
+    bool pending_{};
+    // time of the first pending change.
     uint32_t start_time_{};
+    // time to write out changes: batch_timeout after the last change but not later than batch_max_latency after the
+    // first one.
+    uint32_t deadline_{};
     void perform_();
+    // changes which should not wait, e.g. power off or heater on in frost.
+    bool is_priority_() const;
   };
 
  public:
   explicit TionApiComponent(TionApiBase *api) : api_(api), batch_call_(this) {
-    api->set_on_state(
-        [this](const TionState &state, const uint32_t request_id) { this->on_state_(state, request_id); });
+    api->set_on_state([this](const TionState &state, const uint32_t request_id, TionStateChangeMask changes) {
+      this->on_state_(state, request_id, changes);
+    });
   }
 
   void dump_config() override;
   void call_setup() override;
   void call_loop() override;
+  void on_safe_shutdown() override { this->flush_prefs_(); }
+  void on_shutdown() override { this->flush_prefs_(); }
   float get_setup_priority() const override { return setup_priority::AFTER_CONNECTION; }
 
   void update() override;
@@ -75,9 +96,39 @@ class TionApiComponent : public PollingComponent {
    * @param callback The callback to call.
    */
   void add_on_state_callback(std::function<void(const TionState *)> &&callback) {
+    this->state_callback_.add(
+        [callback = std::move(callback)](const TionState *state, TionStateChangeMask) { callback(state); });
+  }
+
+  /**
+   * Same as above but the callback also receives a mask of TionState::Field changed since the previous call.
+   * The mask is TionState::ALL_FIELDS when force_update is enabled. With nullptr state the mask is 0.
+   *
+   * @param callback The callback to call.
+   */
+  void add_on_state_callback(std::function<void(const TionState *, TionStateChangeMask)> &&callback) {
     this->state_callback_.add(std::move(callback));
   }
 
+  /// Publishes state to the entity.
+  /// @param entity entity passed to add_on_state_entity.
+  /// @param state current state or nullptr when state was not received.
+  /// @return true if entity has state after publishing.
+  using publish_entity_fn = bool (*)(void *entity, const TionState *state);
+
+  /**
+   * Add an entity to publish the breezer state to. Unlike add_on_state_callback, entities are kept in a flat array
+   * and publish function is called only when any of state fields from changes mask was changed or entity has no
+   * state yet.
+   *
+   * @param entity The entity.
+   * @param changes Mask of TionState::Field the entity depends on, TionState::ALL_FIELDS to publish on every state.
+   * @param publish The function to publish state to the entity.
+   */
+  void add_on_state_entity(void *entity, TionStateChangeMask changes, publish_entity_fn publish) {
+    this->state_entities_.push_back({entity, publish, changes & ~StateEntity::HAS_STATE});
+  }
+
 #ifdef TION_ENABLE_API_CONTROL_CALLBACK
   /**
    * Add a callback for the breezer configuration, each time the configuration parameters of a device
@@ -92,8 +143,27 @@ class TionApiComponent : public PollingComponent {
 
   void set_state_timeout(uint32_t state_timeout) { this->state_timeout_ = state_timeout; };
   void set_batch_timeout(uint32_t batch_timeout) { this->batch_timeout_ = batch_timeout; };
+  void set_batch_max_latency(uint32_t batch_max_latency) { this->batch_max_latency_ = batch_max_latency; };
   void set_force_update(bool force_update) { this->force_update_ = force_update; };
   bool get_force_update() const { return this->force_update_; }
+  /// Publishes predicted state at once after the write, see TionApiBase::set_optimistic.
+  void set_optimistic(bool optimistic) { this->api_->set_optimistic(optimistic); }
+  /// Returns true while published state has values not confirmed by the breezer.
+  bool is_state_pending() const { return this->api_->is_state_pending(); }
+  /**
+   * Enables adaptive polling instead of polling every update_interval.
+   * State is requested every min_interval during fast_window after a command and after any changed state. While
+   * responses are the same the interval is multiplied by backoff up to max_interval.
+   */
+  void set_adaptive_polling(uint32_t min_interval, uint32_t max_interval, float backoff, uint32_t fast_window) {
+    this->poll_.min_interval = min_interval;
+    this->poll_.max_interval = max_interval;
+    this->poll_.backoff = backoff;
+    this->poll_.fast_window = fast_window;
+    this->poll_.interval = min_interval;
+  }
+  /// Current adaptive polling interval, 0 when adaptive polling is disabled.
+  uint32_t get_poll_interval() const { return this->poll_.min_interval ? this->poll_.interval : 0; }
   void add_preset(const char *name, const TionApiBase::PresetData &preset) { this->api_->add_preset(name, preset); }
 
   TionStateCall *make_call();
@@ -124,11 +194,32 @@ class TionApiComponent : public PollingComponent {
     TionStateCall call(this->api_);
     this->api_->enable_boost(state, &call);
     call.perform();
+    this->poll_fast_();
   }
 
 #ifdef USE_TION_RESTORE_STATE
   void set_rtc_key(const char *key) { this->rtc_hash_ = key ? fnv1_hash(key) : 0; }
 #endif
+#ifdef USE_TION_FAST_BOOT
+  void set_snapshot_key(const char *key) { this->snapshot_hash_ = key ? fnv1_hash(key) : 0; }
+#endif
+  /// Minimum interval in ms between writes of the saved state, changes made in between are written at once later.
+  void set_save_interval(uint32_t save_interval) { this->save_interval_ = save_interval; }
+  /// Number of saved state writes since boot.
+  uint32_t get_flash_writes() const;
+  /// Returns true while published state is restored at startup and not received from the breezer yet.
+  bool is_state_stale() const { return this->api_->is_state_stale(); }
+
+  /// Sets keepalive of the vport to expose its jitter.
+  void set_keepalive(const TionKeepalive *keepalive) { this->keepalive_ = keepalive; }
+  /// Returns percentile of intervals between keepalive frames in ms, 100 for the maximum interval.
+  float get_keepalive_interval(uint8_t percentile) const;
+
+  using TionLinkStats = dentra::tion::TionLinkStats;
+  /// Sets link counters of the vport, errors are logged once a minute instead of every invalid frame.
+  void set_link_stats(TionLinkStats *link_stats) { this->link_stats_ = link_stats; }
+  /// Returns number of counted events during the last minute, NAN until the first minute is passed.
+  float get_link_rate(dentra::tion::TionLinkCounter TionLinkStats::*counter) const;
 
  protected:
   TionApiBase *api_;
@@ -138,20 +229,82 @@ class TionApiComponent : public PollingComponent {
 
   uint32_t state_timeout_{};
   uint32_t batch_timeout_{};
-
+  uint32_t batch_max_latency_{};
+  // state timeout is not restarted by every poll, so it works with poll interval shorter than timeout.
+  bool state_check_pending_{};
+
+  struct {
+    // 0 - adaptive polling is disabled.
+    uint32_t min_interval;
+    uint32_t max_interval;
+    float backoff;
+    uint32_t fast_window;
+    uint32_t interval;
+    // time of the next state request.
+    uint32_t next_time;
+    // fast polling is kept until this time after a command.
+    uint32_t fast_until;
+  } poll_{};
+  // counters are changing on every response of working breezer, so they do not reset polling interval.
+  static constexpr TionStateChangeMask POLL_IGNORED_CHANGES =
+      TionState::WORK_TIME | TionState::FAN_TIME | TionState::FILTER_TIME_LEFT | TionState::AIRFLOW_COUNTER |
+      TionState::AIRFLOW_M3 | TionState::BOOST_TIME_LEFT;
+  // fields of the snapshot needed for fast boot, measured temperatures and counters do not cause flash writes.
+  static constexpr TionStateChangeMask SNAPSHOT_FIELDS = TionState::INITIALIZED | TionState::POWER_STATE |
+                                                         TionState::HEATER_STATE | TionState::SOUND_STATE |
+                                                         TionState::LED_STATE | TionState::AUTO_STATE |
+                                                         TionState::FAN_SPEED | TionState::GATE_POSITION |
+                                                         TionState::TARGET_TEMPERATURE | TionState::FIRMWARE_VERSION;
+  void poll_fast_();
+  void poll_schedule_(TionStateChangeMask changes);
+
+  uint32_t save_interval_{};
 #ifdef USE_TION_RESTORE_STATE
   uint32_t rtc_hash_{};
-  TionPreferenceObject rtc_pref_;
+  TionWriteBehindPreference<TionApiBase::PresetData> rtc_pref_;
 #endif
   bool load_state_();
   void save_state_();
 
-  CallbackManager<void(const TionState *)> state_callback_{};
+#ifdef USE_TION_FAST_BOOT
+  uint32_t snapshot_hash_{};
+  TionWriteBehindPreference<TionApiBase::Snapshot> snapshot_pref_;
+#endif
+  void load_snapshot_();
+  void save_snapshot_();
+  void check_prefs_();
+  void flush_prefs_();
+
+  const TionKeepalive *keepalive_{};
+
+  TionLinkStats *link_stats_{};
+  // counters at the start of the current minute and their increase during the last one
+  // accessed by the loop only, sensors read rates from here instead of the live counters
+  TionLinkStats link_prev_{};
+  TionLinkStats link_rate_{};
+  bool link_rate_ready_{};
+  void link_summary_();
+
+  struct StateEntity {
+    // the highest bit is not used by TionState::Field, so it keeps entity state.
+    static constexpr TionStateChangeMask HAS_STATE = 1u << 31;
+    static constexpr TionStateChangeMask ALL_FIELDS = TionState::ALL_FIELDS & ~HAS_STATE;
+    void *entity;
+    publish_entity_fn publish;
+    // mask of fields the entity depends on and HAS_STATE bit.
+    TionStateChangeMask changes;
+  };
+  std::vector<StateEntity> state_entities_;
+  void publish_entities_(const TionState *state, TionStateChangeMask changes);
+
+  CallbackManager<void(const TionState *, TionStateChangeMask)> state_callback_{};
+  // changes accumulated until deferred state notification.
+  TionStateChangeMask state_changes_{};
 #ifdef TION_ENABLE_API_CONTROL_CALLBACK
   CallbackManager<void(TionStateCall *)> control_callback_{};
 #endif
 
-  void on_state_(const TionState &state, const uint32_t request_id);
+  void on_state_(const TionState &state, const uint32_t request_id, TionStateChangeMask changes);
   void state_check_schedule_();
 };
 
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_TESTS
+#include <chrono>
+#include <thread>
+#elif defined(USE_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#ifndef TION_IO_TASK_CORE
+// Arduino runs loop on core 1, so I/O task runs on the other one.
+#define TION_IO_TASK_CORE 0
+#endif
+#ifndef TION_IO_TASK_PRIORITY
+// Above loop task (1), below WiFi and BLE stacks.
+#define TION_IO_TASK_PRIORITY 5
+#endif
+#ifndef TION_IO_TASK_STACK_SIZE
+#define TION_IO_TASK_STACK_SIZE 3072
+#endif
+
+namespace esphome {
+namespace tion {
+
+/// Single-producer single-consumer lock-free ring buffer of frames, same as LockFreeQueue of esp32_ble, but frames
+/// are copied into fixed slots, so neither side allocates. I/O task is the only producer, and the main loop is the
+/// only consumer. Holds up to SIZE - 1 frames.
+template<size_t frame_max_size, uint8_t SIZE> class TionFrameQueue {
+ public:
+  struct Frame {
+    uint16_t size;
+    uint8_t data[frame_max_size];
+  };
+
+  bool push(const void *data, size_t size) {
+    if (size > frame_max_size) {
+      this->dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    const uint8_t current_tail = this->tail_.load(std::memory_order_relaxed);
+    const uint8_t next_tail = (current_tail + 1) % SIZE;
+    if (next_tail == this->head_.load(std::memory_order_acquire)) {
+      // Buffer full
+      this->dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    auto &frame = this->buffer_[current_tail];
+    frame.size = size;
+    std::memcpy(frame.data, data, size);
+    this->tail_.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  /// @return the oldest frame or nullptr, the frame is valid until pop.
+  const Frame *front() const {
+    const uint8_t current_head = this->head_.load(std::memory_order_relaxed);
+    if (current_head == this->tail_.load(std::memory_order_acquire)) {
+      return nullptr;  // Empty
+    }
+    return &this->buffer_[current_head];
+  }
+
+  void pop() {
+    const uint8_t current_head = this->head_.load(std::memory_order_relaxed);
+    if (current_head != this->tail_.load(std::memory_order_acquire)) {
+      this->head_.store((current_head + 1) % SIZE, std::memory_order_release);
+    }
+  }
+
+  size_t size() const {
+    const uint8_t tail = this->tail_.load(std::memory_order_acquire);
+    const uint8_t head = this->head_.load(std::memory_order_acquire);
+    return (tail - head + SIZE) % SIZE;
+  }
+
+  bool empty() const {
+    return this->head_.load(std::memory_order_acquire) == this->tail_.load(std::memory_order_acquire);
+  }
+
+  bool full() const {
+    const uint8_t next_tail = (this->tail_.load(std::memory_order_relaxed) + 1) % SIZE;
+    return next_tail == this->head_.load(std::memory_order_acquire);
+  }
+
+  uint16_t get_and_reset_dropped_count() { return this->dropped_count_.exchange(0, std::memory_order_relaxed); }
+
+ protected:
+  Frame buffer_[SIZE];
+  // written by producer, read and reset by consumer
+  std::atomic<uint16_t> dropped_count_{};
+  // written by consumer (pop), read by producer (push) to check if full
+  std::atomic<uint8_t> head_{};
+  // written by producer (push), read by consumer (pop) to check if empty
+  std::atomic<uint8_t> tail_{};
+};
+
+/// Calls function every period ms on a dedicated FreeRTOS task pinned to TION_IO_TASK_CORE, or on std::thread in
+/// host tests. Only dual-core ESP32 is supported.
+class TionIOTask {
+ public:
+  using fn_type = std::function<void()>;
+
+  ~TionIOTask() { this->stop(); }
+
+  bool start(fn_type &&fn, uint32_t period) {
+    if (this->running_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    this->fn_ = std::move(fn);
+    this->period_ = period;
+    this->running_.store(true, std::memory_order_release);
+#ifdef USE_TESTS
+    this->thread_ = std::thread([this]() { this->run_(); });
+    return true;
+#elif defined(USE_ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+    if (xTaskCreatePinnedToCore([](void *arg) { static_cast<TionIOTask *>(arg)->run_(); }, "tion_io",
+                                TION_IO_TASK_STACK_SIZE, this, TION_IO_TASK_PRIORITY, &this->handle_,
+                                TION_IO_TASK_CORE) == pdPASS) {
+      return true;
+    }
+    this->running_.store(false, std::memory_order_release);
+    return false;
+#else
+    this->running_.store(false, std::memory_order_release);
+    return false;
+#endif
+  }
+
+  /// Stops the task, on ESP32 it exits after the current iteration.
+  void stop() {
+    this->running_.store(false, std::memory_order_release);
+#ifdef USE_TESTS
+    if (this->thread_.joinable()) {
+      this->thread_.join();
+    }
+#endif
+  }
+
+  bool is_running() const { return this->running_.load(std::memory_order_acquire); }
+
+  /// Suspends the task for the period, must be called from the task only.
+  void sleep() const {
+#ifdef USE_TESTS
+    std::this_thread::sleep_for(std::chrono::milliseconds(this->period_));
+#elif defined(USE_ESP32)
+    const TickType_t ticks = pdMS_TO_TICKS(this->period_);
+    vTaskDelay(ticks > 0 ? ticks : 1);
+#endif
+  }
+
+ protected:
+  fn_type fn_{};
+  uint32_t period_{};
+  std::atomic<bool> running_{};
+#ifdef USE_TESTS
+  std::thread thread_;
+#elif defined(USE_ESP32)
+  TaskHandle_t handle_{};
+#endif
+
+  void run_() {
+    while (this->running_.load(std::memory_order_acquire)) {
+      this->fn_();
+      this->sleep();
+    }
+#if !defined(USE_TESTS) && defined(USE_ESP32)
+    this->handle_ = nullptr;
+    vTaskDelete(nullptr);
+#endif
+  }
+};
+
+}  // namespace tion
+}  // namespace esphome
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_ESP32
+#include <esp_timer.h>
+#endif
+
+namespace esphome {
+namespace tion {
+
+/// Histogram of intervals between keepalive frames. Bucket width is 1/20 of the nominal interval, intervals longer
+/// than BUCKETS widths are counted in the last bucket. Updated from the I/O task and read from the loop, torn reads
+/// only affect diagnostic values.
+class TionKeepaliveJitter {
+ public:
+  enum { BUCKETS = 64, BUCKETS_PER_INTERVAL = 20 };
+
+  void set_interval(uint32_t interval) {
+    this->width_ = interval < BUCKETS_PER_INTERVAL ? 1 : interval / BUCKETS_PER_INTERVAL;
+    this->reset();
+  }
+
+  void reset() {
+    std::memset(this->buckets_, 0, sizeof(this->buckets_));
+    this->count_ = 0;
+    this->max_ = 0;
+  }
+
+  void add(uint32_t interval) {
+    uint32_t idx = interval / this->width_;
+    if (idx >= BUCKETS) {
+      idx = BUCKETS - 1;
+    }
+    this->buckets_[idx]++;
+    this->count_++;
+    if (interval > this->max_) {
+      this->max_ = interval;
+    }
+  }
+
+  uint32_t get_count() const { return this->count_; }
+  uint32_t get_max() const { return this->max_; }
+
+  /// @return upper bound of the bucket containing the percentile, but not more than maximum interval.
+  uint32_t get_percentile(uint8_t percentile) const {
+    if (this->count_ == 0) {
+      return 0;
+    }
+    const uint32_t rank = (uint64_t(this->count_) * percentile + 99) / 100;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+      sum += this->buckets_[i];
+      if (sum >= rank && sum > 0) {
+        const uint32_t upper = (i + 1) * this->width_;
+        return i == BUCKETS - 1 || upper > this->max_ ? this->max_ : upper;
+      }
+    }
+    return this->max_;
+  }
+
+ protected:
+  uint32_t width_{1};
+  uint32_t buckets_[BUCKETS]{};
+  uint32_t count_{};
+  uint32_t max_{};
+};
+
+/// Sends pre-built keepalive frame with a fixed interval. On ESP32 esp_timer only marks the frame as due, the frame
+/// is written by loop() of the uart owner (I/O or TX task, main loop without them), so the timer never calls uart
+/// driver. On other platforms or when the timer is not available loop() also keeps the interval.
+class TionKeepalive {
+ public:
+  /// Writes complete frame, called from loop().
+  using writer_type = std::function<void(const uint8_t *data, size_t size)>;
+
+  enum { FRAME_MAX_SIZE = 16 };
+
+  ~TionKeepalive() { this->stop(); }
+
+  void set_interval(uint32_t interval) {
+    this->interval_ = interval;
+    this->jitter_.set_interval(interval);
+  }
+  uint32_t get_interval() const { return this->interval_; }
+
+  void set_writer(writer_type &&writer) { this->writer_ = std::move(writer); }
+
+  /// Sets frame to send, must be called before start.
+  bool set_frame(const uint8_t *data, size_t size) {
+    if (size > sizeof(this->frame_)) {
+      return false;
+    }
+    std::memcpy(this->frame_, data, size);
+    this->frame_size_ = size;
+    return true;
+  }
+
+  /// Suspends sending without stopping the timer, e.g. while frame is not required by the breezer.
+  void set_enabled(bool enabled) { this->enabled_.store(enabled, std::memory_order_relaxed); }
+  bool is_enabled() const { return this->enabled_.load(std::memory_order_relaxed); }
+
+  /// Starts periodic timer.
+  /// @param use_timer false to send frames from loop() only.
+  void start(bool use_timer = true) {
+    if (this->interval_ == 0 || this->frame_size_ == 0) {
+      return;
+    }
+    this->next_time_ = millis() + this->interval_;
+#ifdef USE_ESP32
+    if (use_timer && this->timer_ == nullptr) {
+      esp_timer_create_args_t args{};
+      args.callback = [](void *arg) { static_cast<TionKeepalive *>(arg)->due_.store(true, std::memory_order_release); };
+      args.arg = this;
+      args.name = "tion_keepalive";
+      if (esp_timer_create(&args, &this->timer_) != ESP_OK) {
+        this->timer_ = nullptr;
+      } else if (esp_timer_start_periodic(this->timer_, uint64_t(this->interval_) * 1000) != ESP_OK) {
+        esp_timer_delete(this->timer_);
+        this->timer_ = nullptr;
+      }
+      if (this->timer_ == nullptr) {
+        ESP_LOGW("tion_keepalive", "Failed to start timer, using loop");
+      }
+    }
+#endif
+  }
+
+  void stop() {
+#ifdef USE_ESP32
+    if (this->timer_ != nullptr) {
+      esp_timer_stop(this->timer_);
+      esp_timer_delete(this->timer_);
+      this->timer_ = nullptr;
+    }
+#endif
+  }
+
+  /// @return true if frames are sent from the timer.
+  bool is_timer() const {
+#ifdef USE_ESP32
+    return this->timer_ != nullptr;
+#else
+    return false;
+#endif
+  }
+
+  /// Sends frame when it is due, must be called from the owner of uart writes.
+  void loop(uint32_t now) {
+    if (this->interval_ == 0 || this->frame_size_ == 0) {
+      return;
+    }
+    if (this->is_timer()) {
+      // ticks missed while the owner is stalled are sent as one frame
+      if (this->due_.exchange(false, std::memory_order_acquire)) {
+        this->tick(now);
+      }
+      return;
+    }
+    if (int32_t(now - this->next_time_) < 0) {
+      return;
+    }
+    this->next_time_ += this->interval_;
+    // do not send burst of frames after a long stall
+    if (int32_t(now - this->next_time_) >= 0) {
+      this->next_time_ = now + this->interval_;
+    }
+    this->tick(now);
+  }
+
+  /// Sends frame and records interval since the previous one.
+  void tick(uint32_t now) {
+    if (!this->is_enabled()) {
+      this->has_last_ = false;
+      return;
+    }
+    if (this->writer_) {
+      this->writer_(this->frame_, this->frame_size_);
+    }
+    if (this->has_last_) {
+      this->jitter_.add(now - this->last_time_);
+    }
+    this->last_time_ = now;
+    this->has_last_ = true;
+  }
+
+  const TionKeepaliveJitter &get_jitter() const { return this->jitter_; }
+
+ protected:
+  uint32_t interval_{};
+  writer_type writer_{};
+  uint8_t frame_[FRAME_MAX_SIZE]{};
+  size_t frame_size_{};
+  std::atomic<bool> enabled_{true};
+  // set by the timer, cleared by loop()
+  std::atomic<bool> due_{};
+  uint32_t next_time_{};
+  uint32_t last_time_{};
+  bool has_last_{};
+  TionKeepaliveJitter jitter_;
+#ifdef USE_ESP32
+  esp_timer_handle_t timer_{};
+#endif
+};
+
+}  // namespace tion
+}  // namespace esphome
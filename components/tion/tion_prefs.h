@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+
 #include "esphome/core/preferences.h"
 
 namespace esphome {
@@ -20,5 +22,77 @@ class TionPreferenceObject : public ESPPreferenceObject {
   }
 };
 
+// Preference with RAM shadow copy of the stored value. Changes are coalesced and written not often than once per
+// commit interval, the first change after boot is written at once.
+template<class T> class TionWriteBehindPreference {
+ public:
+  void init(const ESPPreferenceObject &pref, uint32_t commit_interval) {
+    this->pref_ = pref;
+    this->commit_interval_ = commit_interval;
+  }
+
+  bool is_initialized() const { return this->pref_.is_initialized(); }
+
+  /// Loads stored value, it is kept as the shadow copy.
+  bool load(T *data) {
+    if (!this->pref_.load(&this->shadow_)) {
+      return false;
+    }
+    this->has_shadow_ = true;
+    *data = this->shadow_;
+    return true;
+  }
+
+  /// Last loaded or saved value.
+  const T &get() const { return this->shadow_; }
+
+  /// Schedules the value to write if it differs from the shadow copy.
+  void save(const T &data, uint32_t now) {
+    if (this->has_shadow_ && std::memcmp(&data, &this->shadow_, sizeof(T)) == 0) {
+      return;
+    }
+    this->shadow_ = data;
+    this->has_shadow_ = true;
+    this->dirty_ = true;
+    this->check(now);
+  }
+
+  /// Writes pending value when commit interval is passed, must be called periodically.
+  void check(uint32_t now) {
+    if (this->dirty_ && (this->writes_ == 0 || now - this->commit_time_ >= this->commit_interval_)) {
+      this->commit_(now);
+    }
+  }
+
+  /// Writes pending value at once, e.g. on shutdown.
+  bool flush(uint32_t now) {
+    if (!this->dirty_) {
+      return false;
+    }
+    this->commit_(now);
+    return true;
+  }
+
+  bool is_dirty() const { return this->dirty_; }
+  /// Number of writes since boot.
+  uint32_t get_writes() const { return this->writes_; }
+
+ protected:
+  TionPreferenceObject pref_;
+  T shadow_{};
+  bool has_shadow_{};
+  bool dirty_{};
+  uint32_t commit_interval_{};
+  uint32_t commit_time_{};
+  uint32_t writes_{};
+
+  void commit_(uint32_t now) {
+    this->pref_.save(&this->shadow_);
+    this->dirty_ = false;
+    this->commit_time_ = now;
+    this->writes_++;
+  }
+};
+
 }  // namespace tion
 }  // namespace esphome
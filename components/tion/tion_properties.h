@@ -11,6 +11,7 @@ namespace tion {
 namespace property_controller {
 
 using dentra::tion::TionState;
+using dentra::tion::TionStateChangeMask;
 using dentra::tion::TionTraits;
 using dentra::tion::TionGatePosition;
 using dentra::tion::TionStateCall;
@@ -46,6 +47,9 @@ template<typename C> class Controller {
         -> std::enable_if_t<sizeof(decltype(T::get(c, {})) *) != 0, std::true_type>;
     template<typename T> std::false_type test_api_state_get(...);
 
+    template<typename T> auto test_changes(int) -> std::enable_if_t<sizeof(T::CHANGES) != 0, std::true_type>;
+    template<typename T> std::false_type test_changes(...);
+
     template<typename T>
     auto test_icon_get(TionApiComponent *c)
         -> std::enable_if_t<sizeof(decltype(T::get_icon(c)) *) != 0, std::true_type>;
@@ -65,6 +69,8 @@ template<typename C> class Controller {
     constexpr bool has_api_set() { return !has_state_set() && !has_api_state_set(); }
 
     constexpr bool has_icon_get() { return decltype(test_icon_get<C>(TAC))::value; }
+
+    constexpr bool has_changes() { return decltype(test_changes<C>(0))::value; }
   };
 
  public:
@@ -95,6 +101,14 @@ template<typename C> class Controller {
     ESP_LOGW(TAG, "Unsupported %s", component->get_name().c_str());
   }
 
+  // State fields the property depends on. Properties without CHANGES are published on every state.
+  static constexpr TionStateChangeMask changes() {
+    if constexpr (checker().has_changes()) {
+      return C::CHANGES;
+    }
+    return TionState::ALL_FIELDS;
+  }
+
   template<typename T> static bool publish_state(T *component, const TionState *state) {
     // на данный момент (EH-2024.5/HA-2024.6), данные об изменении иконки не обновляются в рантайме
     // if constexpr (checker().has_icon_get()) {
@@ -149,12 +163,16 @@ template<typename C> class Controller {
 
 namespace binary_sensor {
 struct Power {
+  static constexpr TionStateChangeMask CHANGES = TionState::POWER_STATE;
+
   static const char *get_icon(TionApiComponent *c) { return c->state().power_state ? "mdi:power" : "mdi:power-off"; }
 
   static bool get(const TionState &state) { return state.power_state; }
 };
 
 struct Heater {
+  static constexpr TionStateChangeMask CHANGES = TionState::HEATER_STATE;
+
   static const char *get_icon(TionApiComponent *c) {
     return c->state().heater_state ? "mdi:radiator" : "mdi:radiator-off";
   }
@@ -163,6 +181,8 @@ struct Heater {
 };
 
 struct Sound {
+  static constexpr TionStateChangeMask CHANGES = TionState::SOUND_STATE;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_sound_state; }
 
   static const char *get_icon(TionApiComponent *c) {
@@ -173,6 +193,8 @@ struct Sound {
 };
 
 struct Led {
+  static constexpr TionStateChangeMask CHANGES = TionState::LED_STATE;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_led_state; }
 
   static const char *get_icon(TionApiComponent *c) { return c->state().led_state ? "mdi:led-on" : "mdi:led-off"; }
@@ -181,18 +203,26 @@ struct Led {
 };
 
 struct Auto {
+  static constexpr TionStateChangeMask CHANGES = TionState::AUTO_STATE;
+
   static bool get(const TionState &state) { return state.auto_state; }
 };
 
 struct Filter {
+  static constexpr TionStateChangeMask CHANGES = TionState::FILTER_STATE;
+
   static bool get(const TionState &state) { return state.filter_state; }
 };
 
 struct GateError {
+  static constexpr TionStateChangeMask CHANGES = TionState::GATE_ERROR_STATE;
+
   static bool get(const TionState &state) { return state.gate_error_state; }
 };
 
 struct Gate {
+  static constexpr TionStateChangeMask CHANGES = TionState::GATE_POSITION;
+
   static const char *get_icon(TionApiComponent *c) {
     if (c->traits().supports_gate_position_change_mixed && c->state().gate_position == TionGatePosition::MIXED) {
       return "mdi:valve";
@@ -204,12 +234,19 @@ struct Gate {
 };
 
 struct Heating {
+  // heating is detected by temperatures when heater var is not supported
+  static constexpr TionStateChangeMask CHANGES = TionState::HEATER_STATE | TionState::HEATER_VAR |
+                                                 TionState::TARGET_TEMPERATURE | TionState::OUTDOOR_TEMPERATURE |
+                                                 TionState::CURRENT_TEMPERATURE;
+
   static const char *get_icon(TionApiComponent *c) { return Heater::get_icon(c); }
 
   static bool get(TionApiComponent *c, const TionState &state) { return state.is_heating(c->traits()); }
 };
 
 struct Error {
+  static constexpr TionStateChangeMask CHANGES = TionState::ERRORS;
+
   static bool get(const TionState &state) { return state.errors != 0; }
 };
 
@@ -245,6 +282,8 @@ struct Auto : public binary_sensor::Auto {
 };
 
 struct Recirculation {
+  static constexpr TionStateChangeMask CHANGES = TionState::GATE_POSITION;
+
   static bool is_supported(TionApiComponent *c) {
     return c->traits().supports_gate_position_change || c->traits().supports_gate_position_change_mixed;
   }
@@ -263,6 +302,8 @@ struct Boost : public binary_sensor::Boost {
 
 namespace sensor {
 struct FanSpeed {
+  static constexpr TionStateChangeMask CHANGES = TionState::POWER_STATE | TionState::FAN_SPEED;
+
   static const char *get_icon(TionApiComponent *c) {
     if (c->api()->is_boost_running()) {
       return "mdi:fan-clock";
@@ -289,44 +330,62 @@ struct FanSpeed {
 };
 
 struct OutdoorTemperature {
+  static constexpr TionStateChangeMask CHANGES = TionState::OUTDOOR_TEMPERATURE;
+
   static int8_t get(const TionState &state) { return state.outdoor_temperature; }
 };
 
 struct CurrentTemperature {
+  static constexpr TionStateChangeMask CHANGES = TionState::CURRENT_TEMPERATURE;
+
   static int8_t get(const TionState &state) { return state.current_temperature; }
 };
 
 struct TargetTemperature {
+  static constexpr TionStateChangeMask CHANGES = TionState::TARGET_TEMPERATURE;
+
   static constexpr int8_t get(const TionState &state) { return state.target_temperature; }
 };
 
 struct Productivity {
+  static constexpr TionStateChangeMask CHANGES = TionState::PRODUCTIVITY;
+
   static uint8_t get(const TionState &state) { return state.productivity; }
 };
 
 struct HeaterVar {
+  static constexpr TionStateChangeMask CHANGES = TionState::HEATER_VAR;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_heater_var; }
 
   static uint8_t get(const TionState &state) { return state.heater_var; }
 };
 
 struct HeaterPower {
+  static constexpr TionStateChangeMask CHANGES = binary_sensor::Heating::CHANGES;
+
   static float get(TionApiComponent *c, const TionState &state) { return state.get_heater_power(c->traits()); }
 };
 
 struct WorkTime {
+  static constexpr TionStateChangeMask CHANGES = TionState::WORK_TIME;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_work_time; }
 
   static uint32_t get(const TionState &state) { return state.work_time; }
 };
 
 struct WorkTimeDays {
+  static constexpr TionStateChangeMask CHANGES = WorkTime::CHANGES;
+
   static bool is_supported(TionApiComponent *c) { return WorkTime::is_supported(c); }
 
   static uint32_t get(const TionState &state) { return WorkTime::get(state) / (24 * 3600); }
 };
 
 struct FilterTimeLeft {
+  static constexpr TionStateChangeMask CHANGES = TionState::FILTER_TIME_LEFT;
+
   static const char *get_icon(TionApiComponent *c) {
     return binary_sensor::Filter::get(c->state()) ? "mdi:filter-remove" : "mdi:filter-check";
   }
@@ -334,41 +393,55 @@ struct FilterTimeLeft {
 };
 
 struct FilterTimeLeftDays {
+  static constexpr TionStateChangeMask CHANGES = FilterTimeLeft::CHANGES;
+
   static const char *get_icon(TionApiComponent *c) { return FilterTimeLeft::get_icon(c); }
   static uint32_t get(const TionState &state) { return FilterTimeLeft::get(state) / (24 * 3600); }
 };
 
 struct FanTime {
+  static constexpr TionStateChangeMask CHANGES = TionState::FAN_TIME;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_fan_time; }
 
   static uint32_t get(const TionState &state) { return state.fan_time; }
 };
 
 struct FanTimeDays {
+  static constexpr TionStateChangeMask CHANGES = FanTime::CHANGES;
+
   static bool is_supported(TionApiComponent *c) { return FanTime::is_supported(c); }
 
   static uint32_t get(const TionState &state) { return FanTime::get(state) / (24 * 3600); }
 };
 
 struct Airflow {
+  static constexpr TionStateChangeMask CHANGES = TionState::AIRFLOW_M3;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_airflow_counter; }
 
   static float get(const TionState &state) { return state.airflow_m3; }
 };
 
 struct AirflowCounter {
+  static constexpr TionStateChangeMask CHANGES = TionState::AIRFLOW_COUNTER;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_airflow_counter; }
 
   static uint32_t get(const TionState &state) { return state.airflow_counter; }
 };
 
 struct PcbCtlTemperature {
+  static constexpr TionStateChangeMask CHANGES = TionState::PCB_CTL_TEMPERATURE;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_pcb_ctl_temperature; }
 
   static int8_t get(const TionState &state) { return state.pcb_ctl_temperature; }
 };
 
 struct PcbPwrTemperature {
+  static constexpr TionStateChangeMask CHANGES = TionState::PCB_PWR_TEMPERATURE;
+
   static bool is_supported(TionApiComponent *c) { return c->traits().supports_pcb_pwr_temperature; }
 
   static int8_t get(const TionState &state) { return state.pcb_pwr_temperature; }
@@ -378,13 +451,73 @@ struct BoostTimeLeft {
   static float get(TionApiComponent *c) { return c->api()->get_boost_time_left(); }
 };
 
+struct FlashWrites {
+  static float get(TionApiComponent *c) { return c->get_flash_writes(); }
+};
+
+struct KeepaliveP50 {
+  static float get(TionApiComponent *c) { return c->get_keepalive_interval(50); }
+};
+
+struct KeepaliveP99 {
+  static float get(TionApiComponent *c) { return c->get_keepalive_interval(99); }
+};
+
+struct KeepaliveMax {
+  static float get(TionApiComponent *c) { return c->get_keepalive_interval(100); }
+};
+
+struct LinkRxFrames {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::rx_frames); }
+};
+
+struct LinkRxBytes {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::rx_bytes); }
+};
+
+struct LinkTxFrames {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::tx_frames); }
+};
+
+struct LinkTxBytes {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::tx_bytes); }
+};
+
+struct LinkCrcErrors {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::crc_errors); }
+};
+
+struct LinkBadMagic {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::bad_magic); }
+};
+
+struct LinkOversize {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::oversize); }
+};
+
+struct LinkResyncs {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::resyncs); }
+};
+
+struct LinkDrops {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::drops); }
+};
+
+struct LinkTimeouts {
+  static float get(TionApiComponent *c) { return c->get_link_rate(&TionApiComponent::TionLinkStats::timeouts); }
+};
+
 struct FanPower {
+  static constexpr TionStateChangeMask CHANGES = TionState::POWER_STATE | TionState::FAN_SPEED;
+
   static float get(TionApiComponent *c, const TionState &state) {
     return c->traits().get_max_fan_power(state.power_state ? state.fan_speed : 0);
   }
 };
 
 struct Power {
+  static constexpr TionStateChangeMask CHANGES = FanPower::CHANGES | HeaterPower::CHANGES;
+
   static float get(TionApiComponent *c, const TionState &state) {
     return (FanPower::get(c, state) + HeaterPower::get(c, state)) * 0.001;
   }
@@ -460,12 +593,16 @@ struct BoostTime {
 namespace text_sensor {
 
 struct Errors {
+  static constexpr TionStateChangeMask CHANGES = TionState::ERRORS;
+
   static std::string get(TionApiComponent *c, const TionState &state) {
     return c->traits().errors_decode(state.errors);
   };
 };
 
 struct FirmwareVersion {
+  static constexpr TionStateChangeMask CHANGES = TionState::FIRMWARE_VERSION;
+
   static std::string get(const TionState &state) {
     if (!state.firmware_version) {
       return {};
@@ -475,6 +612,8 @@ struct FirmwareVersion {
 };
 
 struct HardwareVersion {
+  static constexpr TionStateChangeMask CHANGES = TionState::HARDWARE_VERSION;
+
   static std::string get(const TionState &state) {
     if (!state.hardware_version) {
       return {};
@@ -488,6 +627,8 @@ struct HardwareVersion {
 namespace select {
 
 struct AirIntake {
+  static constexpr TionStateChangeMask CHANGES = TionState::GATE_POSITION;
+
   static FixedVector<const char *> get_options(TionApiComponent *c) {
     if (c->traits().supports_gate_position_change_mixed) {
       return {"outdoor", "indoor", "mixed"};
@@ -6,7 +6,11 @@
 
 #include "esphome/components/vport/vport.h"
 
+#include "../tion-api/tion-api-blackbox.h"
+#include "../tion-api/tion-api-command-queue.h"
+#include "../tion-api/tion-api-defines.h"
 #include "../tion-api/tion-api-protocol.h"
+#include "../tion-api/tion-api-trace.h"
 #include "../tion-api/tion-api-writer.h"
 
 namespace esphome {
@@ -28,6 +32,8 @@ template<class protocol_type> class TionIO {
 
   void set_on_frame(on_frame_type &&reader) { this->protocol_.set_protocol_reader(std::move(reader)); }
 
+  dentra::tion::TionLinkStats *get_link_stats() { return &this->protocol_.get_link_stats(); }
+
  protected:
   protocol_type protocol_;
 };
@@ -38,6 +44,7 @@ template<class frame_spec_t, class api_t> class TionVPortApi : public api_t, pub
 
  public:
   using vport_t = vport::VPort<frame_spec_t>;
+  using command_queue_type = dentra::tion::TionCommandQueue<TION_COMMAND_QUEUE_SIZE, api_t::TX_DATA_MAX_SIZE>;
 
   TionVPortApi(vport_t *vport) : vport_(vport) {
     vport->add_listener(this);
@@ -52,19 +59,89 @@ template<class frame_spec_t, class api_t> class TionVPortApi : public api_t, pub
   }
 
   void on_frame(const frame_spec_t &frame, size_t size) override {
+    TION_TRACE_FRAME();
+    TION_BLACKBOX_RX(this->blackbox_source_, frame.type, frame.data, size - frame_spec_t::head_size());
+    this->wait_response_ = false;
     this->read_frame(frame.type, frame.data, size - frame_spec_t::head_size());
+    this->drain_();
+  }
+
+  /// Sends next frame only after any frame is received or timeout ms passed since the previous one.
+  /// Frames written meanwhile are queued and sent by priority of their class, 0 sends all frames at once.
+  void set_response_timeout(uint32_t timeout) { this->response_timeout_ = timeout; }
+  const command_queue_type &get_command_queue() const { return this->queue_; }
+  /// Sets link counters of the vport to count dropped commands.
+  void set_link_stats(dentra::tion::TionLinkStats *link_stats) { this->link_stats_ = link_stats; }
+  /// Sets vport type and model the frames are recorded with to the black box.
+  void set_blackbox_source(TionVPortType vport_type, dentra::tion::TionBlackBoxRecord::Model model) {
+    this->blackbox_source_ = dentra::tion::TionBlackBoxRecord::make_source(vport_type, model);
+  }
+
+  void check_requests() override {
+    api_t::check_requests();
+    this->drain_();
   }
 
  protected:
   vport_t *vport_;
+  dentra::tion::TionLinkStats *link_stats_{};
+  uint8_t blackbox_source_{};
+  command_queue_type queue_;
+  uint32_t response_timeout_{};
+  uint32_t sent_time_{};
+  bool wait_response_{};
+
+  bool is_busy_() {
+    if (this->wait_response_ && millis() - this->sent_time_ >= this->response_timeout_) {
+      this->wait_response_ = false;
+    }
+    return this->wait_response_;
+  }
 
   bool write_frame_(uint16_t type, const void *data, size_t size) {
-    uint8_t buf[sizeof(frame_spec_t) + size];
-    std::memset(buf, 0, sizeof(buf));
-    auto frame = reinterpret_cast<frame_spec_t *>(buf);
+    if (this->response_timeout_ == 0 || (this->queue_.empty() && !this->is_busy_())) {
+      return this->send_frame_(type, data, size);
+    }
+    const auto high_water = this->queue_.get_high_water();
+    if (!this->queue_.push(type, this->get_command_class(type), data, size)) {
+      ESP_LOGW("tion_vport", "Command queue is full, frame 0x%04X dropped", type);
+      if (this->link_stats_ != nullptr) {
+        this->link_stats_->drops++;
+      }
+      return false;
+    }
+    if (this->queue_.get_high_water() > high_water) {
+      ESP_LOGD("tion_vport", "Command queue high water: %zu", this->queue_.get_high_water());
+    }
+    return true;
+  }
+
+  void drain_() {
+    while (!this->queue_.empty() && !this->is_busy_()) {
+      const auto &cmd = this->queue_.front();
+      // cmd refers to the queue slot, so it is released only after the frame is sent
+      this->send_frame_(cmd.type, cmd.data, cmd.size);
+      this->queue_.pop();
+    }
+  }
+
+  bool send_frame_(uint16_t type, const void *data, size_t size) {
+    static_assert(frame_spec_t::head_size() <= api_t::TX_HEAD_ROOM, "no room for frame head");
+    // frame data built by api with make_frame_data_ is already in place, otherwise copy it once
+    if (!this->tx_frame_.set_data(data, size)) {
+      ESP_LOGW("tion_vport", "Frame 0x%04X is too large: %zu", type, size);
+      return false;
+    }
+    TION_BLACKBOX_TX(this->blackbox_source_, type, data, size);
+    auto *frame = reinterpret_cast<frame_spec_t *>(this->tx_frame_.push_head(frame_spec_t::head_size()));
+    std::memset(frame, 0, frame_spec_t::head_size());
     frame->type = type;
-    std::memcpy(frame->data, data, size);
-    this->vport_->write(*frame, sizeof(buf));
+    this->vport_->write(*frame, this->tx_frame_.frame_size());
+    // wait for response only when the frame is really sent, rejected one must not block the queue
+    if (this->response_timeout_ != 0 && this->get_command_class(type) != dentra::tion::TionCommandClass::KEEPALIVE) {
+      this->wait_response_ = true;
+      this->sent_time_ = millis();
+    }
     return true;
   }
 };
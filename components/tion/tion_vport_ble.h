@@ -35,7 +35,10 @@ template<class protocol_type> class TionBleIO : public TionIO<protocol_type>, pu
       this->on_ready_();
     }
   }
-  bool on_ble_data(const uint8_t *data, uint16_t size) override { return this->protocol_.read_data(data, size); }
+  bool on_ble_data(const uint8_t *data, uint16_t size) override {
+    TION_TRACE_RX(true);
+    return this->protocol_.read_data(data, size);
+  }
 
  protected:
   on_ready_type on_ready_;
@@ -49,6 +52,8 @@ class TionVPortBLEComponent : public vport::VPortBLEComponent<io_t, typename io_
   TionVPortBLEComponent(io_t *io) : vport::VPortBLEComponent<io_t, typename io_t::frame_spec_type>(io) {}
 
   TionVPortType get_type() const { return TionVPortType::VPORT_BLE; }
+
+  dentra::tion::TionLinkStats *get_link_stats() { return this->io_->get_link_stats(); }
 };
 
 }  // namespace tion
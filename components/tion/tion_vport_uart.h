@@ -2,16 +2,17 @@
 #include "esphome/core/defines.h"
 #ifdef USE_VPORT_UART
 
-#ifdef USE_TION_HALF_DUPLEX
-// #pragma message("USE_TION_HALF_DUPLEX")
-#include "esphome/core/application.h"
-#endif
-
 #include "esphome/components/uart/uart_component.h"
 #include "esphome/components/vport/vport_uart.h"
+#ifdef USE_ESP_IDF
+#include <driver/uart.h>
+#include "esphome/components/uart/uart_component_esp_idf.h"
+#endif
 
 #include "../tion-api/tion-api-uart.h"
 
+#include "tion_io_task.h"
+#include "tion_keepalive.h"
 #include "tion_vport.h"
 
 namespace esphome {
@@ -19,11 +20,131 @@ namespace tion {
 
 template<class protocol_t> class TionUartIO : public TionIO<protocol_t>, public dentra::tion::TionUartReader {
  public:
+  using on_frame_type = typename TionIO<protocol_t>::on_frame_type;
+  using on_tx_complete_type = std::function<void(const uint8_t *data, size_t size)>;
+
+  // RX timeout used with pattern detection when it is not set.
+  static constexpr uint32_t RX_PATTERN_FALLBACK_TIMEOUT = 50;
+
   explicit TionUartIO(uart::UARTComponent *uart) : uart_(uart) {
     this->protocol_.set_protocol_writer([this](const uint8_t *data, size_t size) { return this->write_(data, size); });
   }
 
-  void poll() { this->protocol_.read_uart_data(this); }
+  void poll() {
+    if (this->rx_queued_) {
+      // uart is read and written by the task
+      this->rx_dispatch_();
+      return;
+    }
+    this->rx_read_();
+    if (this->tx_queued_) {
+      // frames are written by the TX task
+      return;
+    }
+    this->keepalive_poll_();
+    this->tx_drain_();
+  }
+
+  /// Reads, parses and writes data on a dedicated task, decoded frames are passed to on_frame from poll and written
+  /// frames are passed to the task with a queue. Must be called after setup_rx.
+  /// @return false if the task is not supported, data is read and written from poll then.
+  bool start_io_task() {
+    this->rx_queued_ = true;
+    this->tx_queued_ = true;
+    if (!this->io_task_.start(
+            [this]() {
+              this->rx_read_();
+              this->tx_task_();
+            },
+            IO_TASK_PERIOD)) {
+      this->rx_queued_ = false;
+      this->tx_queued_ = false;
+      return false;
+    }
+    return true;
+  }
+
+  /// Writes frames and keepalive on a dedicated task while data is read from poll, so keepalive cadence does not
+  /// depend on the loop. Must be called instead of start_io_task.
+  /// @return false if the task is not supported, data is written from poll then.
+  bool start_tx_task() {
+    this->tx_queued_ = true;
+    if (!this->io_task_.start([this]() { this->tx_task_(); }, IO_TASK_PERIOD)) {
+      this->tx_queued_ = false;
+      return false;
+    }
+    return true;
+  }
+
+  /// @return true if frames are written by the task.
+  bool is_tx_task() const { return this->tx_queued_ && this->io_task_.is_running(); }
+
+  void stop_io_task() { this->io_task_.stop(); }
+
+  /// Sends keepalive frames with the TX path, from the task when it is running or from poll otherwise.
+  void set_keepalive(TionKeepalive *keepalive) {
+    this->keepalive_ = keepalive;
+    keepalive->set_writer([this](const uint8_t *data, size_t size) { this->tx_push_(data, size); });
+  }
+
+  /// Wakes the reader only when pattern byte (end of frame or line) is received. Uses ESP-IDF uart pattern
+  /// detection, on other platforms only RX timeout is used. Must be called before setup_rx.
+  /// Without RX timeout data of a lost pattern event is read after RX_PATTERN_FALLBACK_TIMEOUT.
+  void set_rx_pattern(uint8_t pattern) {
+    this->rx_pattern_ = pattern;
+    this->rx_wait_ = true;
+  }
+
+  /// Wakes the reader when received data is not changed for rx_timeout ms.
+  void set_rx_timeout(uint32_t rx_timeout) {
+    this->rx_timeout_ = rx_timeout;
+    this->rx_wait_ = true;
+  }
+
+  /// Enables RX events, uart must be already set up.
+  void setup_rx() {
+#ifdef USE_ESP_IDF
+    if (this->rx_wait_ && this->rx_pattern_ >= 0) {
+      const auto uart_num = static_cast<uart_port_t>(this->get_uart_num_());
+      this->rx_pattern_det_ = uart_enable_pattern_det_baud_intr(uart_num, this->rx_pattern_, 1, 9, 0, 0) == ESP_OK &&
+                              uart_pattern_queue_reset(uart_num, RX_PATTERN_QUEUE_SIZE) == ESP_OK;
+    }
+#endif
+  }
+
+  void set_on_frame(on_frame_type &&reader) {
+    this->on_rx_frame_ = std::move(reader);
+    this->protocol_.set_protocol_reader([this](const typename protocol_t::frame_spec_type &frame, size_t size) {
+      // response is received, so the next frame may be written in half duplex mode
+      this->tx_await_.store(false, std::memory_order_relaxed);
+      if (this->rx_queued_) {
+        // called from the task, the frame is dispatched from poll. While the loop is stalled the task waits and
+        // unread data stays in the uart buffer, as it does without the task.
+        while (this->rx_queue_.full() && this->io_task_.is_running()) {
+          this->io_task_.sleep();
+        }
+        this->rx_queue_.push(&frame, size);
+        return;
+      }
+      this->rx_frame_(frame, size);
+    });
+  }
+
+  /// Called for every frame passed to uart, from the task when it is running.
+  void set_on_tx_complete(on_tx_complete_type &&on_tx_complete) { this->on_tx_complete_ = std::move(on_tx_complete); }
+
+  /// In half duplex mode next frame is written only after response to previous one or HALF_DUPLEX_TIMEOUT.
+  void set_half_duplex(bool half_duplex) { this->half_duplex_ = half_duplex; }
+
+  /// Encodes frame with the protocol into buf without sending it.
+  /// @return size of the encoded frame or 0 if it does not fit into buf.
+  size_t encode_frame(uint16_t type, const void *data, size_t size, uint8_t *buf, size_t buf_size) {
+    this->encode_buf_ = buf;
+    this->encode_size_ = buf_size;
+    const bool res = this->protocol_.write_frame(type, data, size);
+    this->encode_buf_ = nullptr;
+    return res ? this->encode_size_ : 0;
+  }
 
   int available() override { return this->uart_->available(); }
   bool read_array(void *data, size_t size) override {
@@ -31,10 +152,206 @@ template<class protocol_t> class TionUartIO : public TionIO<protocol_t>, public
   }
 
  protected:
+  enum {
+    // Hardware TX FIFO size of ESP32 and ESP8266 uart, writing more blocks until it drains.
+    TX_FIFO_SIZE = 128,
+    TX_QUEUE_SIZE = 256,
+    HALF_DUPLEX_TIMEOUT = 100,
+    RX_PATTERN_QUEUE_SIZE = 8,
+    RX_QUEUE_SIZE = 8,
+    TX_TASK_QUEUE_SIZE = 8,
+    // uart driver buffers received data, so the task does not need to spin. 10 ms is about 10 bytes at 9600 baud
+    // and the delay of written frames stays below a loop iteration.
+    IO_TASK_PERIOD = 10,
+  };
+
   uart::UARTComponent *uart_;
+  on_frame_type on_rx_frame_{};
+  on_tx_complete_type on_tx_complete_{};
+  dentra::tion::TionUartTxQueue<TX_QUEUE_SIZE> tx_queue_;
+  // estimated time when TX FIFO becomes empty
+  uint32_t tx_fifo_done_us_{};
+  uint32_t tx_frame_time_{};
+  // cleared by the reader, which runs on the loop when only TX task is running
+  std::atomic<bool> tx_await_{};
+  bool half_duplex_{};
+  bool rx_wait_{};
+  bool rx_pattern_det_{};
+  int16_t rx_pattern_{-1};
+  uint32_t rx_timeout_{};
+  // available bytes and time of the last change
+  int rx_available_{};
+  uint32_t rx_time_{};
+  // frames are read by io_task_ and passed to the loop with rx_queue_, frames to write are passed to the task with
+  // tx_task_queue_. TX queue, FIFO estimate and keepalive are owned by the task then.
+  bool rx_queued_{};
+  bool tx_queued_{};
+  TionFrameQueue<protocol_t::frame_max_size(), RX_QUEUE_SIZE> rx_queue_;
+  TionFrameQueue<protocol_t::frame_max_size(), TX_TASK_QUEUE_SIZE> tx_task_queue_;
+  TionKeepalive *keepalive_{};
+  // declared after the queues, so the task is stopped before the queues are destroyed
+  TionIOTask io_task_;
+  // destination of encode_frame
+  uint8_t *encode_buf_{};
+  size_t encode_size_{};
+
+#ifdef USE_ESP_IDF
+  uint8_t get_uart_num_() const { return static_cast<uart::IDFUARTComponent *>(this->uart_)->get_hw_serial_number(); }
+#endif
+
+  void rx_read_() {
+    // frames received by the task are traced from dispatching only
+    TION_TRACE_RX(!this->rx_queued_ && this->uart_->available() > 0);
+    if (this->rx_ready_()) {
+      this->protocol_.read_uart_data(this);
+      this->rx_available_ = 0;
+    }
+  }
+
+  void rx_frame_(const typename protocol_t::frame_spec_type &frame, size_t size) {
+    if (this->on_rx_frame_) {
+      this->on_rx_frame_(frame, size);
+    }
+  }
+
+  /// Passes frames received by the task to on_frame.
+  void rx_dispatch_() {
+    while (const auto *frame = this->rx_queue_.front()) {
+      this->rx_frame_(*reinterpret_cast<const typename protocol_t::frame_spec_type *>(frame->data), frame->size);
+      this->rx_queue_.pop();
+    }
+    const auto dropped = this->rx_queue_.get_and_reset_dropped_count();
+    if (dropped != 0) {
+      ESP_LOGW("tion_vport_uart", "RX queue is full, %u frames dropped", dropped);
+      this->protocol_.get_link_stats().drops += dropped;
+    }
+  }
+
+  /// Checks if received data may contain complete frame.
+  bool rx_ready_() {
+    if (!this->rx_wait_) {
+      return true;
+    }
+#ifdef USE_ESP_IDF
+    if (this->rx_pattern_det_) {
+      const auto uart_num = static_cast<uart_port_t>(this->get_uart_num_());
+      if (uart_pattern_pop_pos(uart_num) >= 0) {
+        // all received frames are read at once
+        while (uart_pattern_pop_pos(uart_num) >= 0) {
+        }
+        return true;
+      }
+    }
+#endif
+    const int available = this->uart_->available();
+    if (available <= 0) {
+      this->rx_available_ = 0;
+      return false;
+    }
+    const uint32_t now = millis();
+    if (available != this->rx_available_) {
+      this->rx_available_ = available;
+      this->rx_time_ = now;
+      return false;
+    }
+    // pattern events may be lost when the driver queue overflows, so data is never left unread
+    const uint32_t rx_timeout =
+        this->rx_timeout_ == 0 && this->rx_pattern_det_ ? RX_PATTERN_FALLBACK_TIMEOUT : this->rx_timeout_;
+    return now - this->rx_time_ >= rx_timeout;
+  }
+
   bool write_(const uint8_t *data, size_t size) {
-    this->uart_->write_array(data, size);
-    this->uart_->flush();
+    if (this->encode_buf_ != nullptr) {
+      if (size > this->encode_size_) {
+        return false;
+      }
+      std::memcpy(this->encode_buf_, data, size);
+      this->encode_size_ = size;
+      return true;
+    }
+    if (this->tx_queued_) {
+      if (!this->tx_task_queue_.push(data, size)) {
+        ESP_LOGW("tion_vport_uart", "TX queue is full, frame dropped");
+        this->protocol_.get_link_stats().drops++;
+        return false;
+      }
+      return true;
+    }
+    return this->tx_push_(data, size);
+  }
+
+  /// Queues frame and writes it if possible, called by the owner of the TX queue.
+  bool tx_push_(const uint8_t *data, size_t size) {
+    if (!this->tx_queue_.push(data, size)) {
+      ESP_LOGW("tion_vport_uart", "TX queue is full, frame dropped");
+      this->protocol_.get_link_stats().drops++;
+      return false;
+    }
+    this->tx_drain_();
+    return true;
+  }
+
+  void keepalive_poll_() {
+    if (this->keepalive_ != nullptr) {
+      this->keepalive_->loop(millis());
+    }
+  }
+
+  /// Writes keepalive and frames passed by the loop, called from the task.
+  void tx_task_() {
+    this->keepalive_poll_();
+    while (const auto *frame = this->tx_task_queue_.front()) {
+      // frame stays in the task queue until there is a room in the TX queue
+      if (!this->tx_queue_.push(frame->data, frame->size)) {
+        break;
+      }
+      this->tx_task_queue_.pop();
+    }
+    this->tx_drain_();
+  }
+
+  /// Writes queued frames while they fit into TX FIFO, so write_array never waits for uart.
+  void tx_drain_() {
+    while (!this->tx_queue_.empty()) {
+      if (this->half_duplex_ && this->tx_await_.load(std::memory_order_relaxed)) {
+        if (millis() - this->tx_frame_time_ < HALF_DUPLEX_TIMEOUT) {
+          return;
+        }
+        ESP_LOGW("tion_vport_uart", "No response to previous frame");
+      }
+      const size_t size = this->tx_queue_.front_size();
+      if (!this->tx_fifo_reserve_(size)) {
+        return;
+      }
+      const uint8_t *data = this->tx_queue_.front_data();
+      this->uart_->write_array(data, size);
+      this->tx_frame_time_ = millis();
+      this->tx_await_.store(this->half_duplex_, std::memory_order_relaxed);
+      if (this->on_tx_complete_) {
+        this->on_tx_complete_(data, size);
+      }
+      this->tx_queue_.pop();
+    }
+  }
+
+  /// Accounts size bytes in TX FIFO if they fit there.
+  bool tx_fifo_reserve_(size_t size) {
+    const uint32_t baud_rate = this->uart_->get_baud_rate();
+    if (baud_rate == 0) {
+      return true;
+    }
+    // 10 bits per byte: start, 8 data and stop bits, rounded up to not overflow FIFO
+    const uint32_t byte_us = (10 * 1000000 + baud_rate - 1) / baud_rate;
+    const uint32_t now = micros();
+    int32_t pending_us = static_cast<int32_t>(this->tx_fifo_done_us_ - now);
+    if (pending_us < 0) {
+      pending_us = 0;
+    }
+    // frame larger than FIFO is written to the empty FIFO at once
+    if (pending_us != 0 && pending_us + size * byte_us > TX_FIFO_SIZE * byte_us) {
+      return false;
+    }
+    this->tx_fifo_done_us_ = now + pending_us + size * byte_us;
     return true;
   }
 };
@@ -46,8 +363,7 @@ class TionVPortUARTComponent : public vport::VPortUARTComponent<io_t, typename i
  public:
   explicit TionVPortUARTComponent(io_t *io) : super_t(io) {
 #ifdef USE_TION_HALF_DUPLEX
-    this->io_->set_on_frame(
-        [this](const typename io_t::frame_spec_type &frame, size_t size) { this->on_frame_(frame, size); });
+    this->io_->set_half_duplex(true);
 #endif
   }
 
@@ -60,39 +376,47 @@ class TionVPortUARTComponent : public vport::VPortUARTComponent<io_t, typename i
       uint8_t c;
       this->io_->read_array(&c, sizeof(c));
     }
+    this->io_->setup_rx();
+#ifdef USE_TION_IO_TASK
+    if (!this->io_->start_io_task()) {
+      ESP_LOGW("tion_vport_uart", "Failed to start I/O task, data is read from loop");
+    }
+#else
+    // keepalive is started by setup of the vport, the task writes it when the loop is stalled
+    if (this->keepalive_.get_interval() != 0 && !this->io_->start_tx_task()) {
+      ESP_LOGD("tion_vport_uart", "TX task is not supported, keepalive is written from loop");
+    }
+#endif
   }
 
-#ifdef USE_TION_HALF_DUPLEX
-  void write(const typename io_t::frame_spec_type &frame, size_t size) override {
-    if (this->await_frame_) {
-      auto data8 = reinterpret_cast<const uint8_t *>(&frame);
-      auto datav = std::vector<uint8_t>(data8, data8 + size);
-      this->defer([this, datav]() {
-        auto frame = reinterpret_cast<const typename io_t::frame_spec_type *>(datav.data());
-        if (this->await_frame_) {
-          ESP_LOGW("tion_vport_uart", "prev frame was not recv, may lead to crash");
-        }
-        super_t::write(*frame, datav.size());
-        arch_feed_wdt();
-        yield();
-      });
-    } else {
-      this->await_frame_ = true;
-      super_t::write(frame, size);
-      arch_feed_wdt();
-      yield();
+  /// Keepalive frames timed independently of the loop.
+  const TionKeepalive *get_keepalive() const { return &this->keepalive_; }
+
+  dentra::tion::TionLinkStats *get_link_stats() { return this->io_->get_link_stats(); }
+
+ protected:
+  TionKeepalive keepalive_;
+
+  /// Starts sending the frame with the interval.
+  bool start_keepalive_(uint16_t type, const void *data, size_t size, uint32_t interval) {
+    uint8_t buf[TionKeepalive::FRAME_MAX_SIZE];
+    const size_t frame_size = this->io_->encode_frame(type, data, size, buf, sizeof(buf));
+    if (frame_size == 0 || interval == 0) {
+      return false;
     }
+    this->keepalive_.set_interval(interval);
+    this->keepalive_.set_frame(buf, frame_size);
+    this->io_->set_keepalive(&this->keepalive_);
+    this->keepalive_.start();
+    return true;
   }
 
- protected:
-  bool await_frame_{};
-  void on_frame_(const typename io_t::frame_spec_type &frame, size_t size) {
-    arch_feed_wdt();
-    yield();
-    this->await_frame_ = false;
-    this->fire_frame(frame, size);
+  void dump_keepalive_(const char *tag) {
+    if (this->keepalive_.get_interval() != 0) {
+      ESP_LOGCONFIG(tag, "  Keepalive: %.1f s, %s, written by %s", this->keepalive_.get_interval() * 0.001f,
+                    this->keepalive_.is_timer() ? "timer" : "loop", this->io_->is_tx_task() ? "task" : "loop");
+    }
   }
-#endif
 };
 
 }  // namespace tion
@@ -4,6 +4,7 @@
 
 #include "../tion/tion_vport_uart.h"
 #include "../tion-api/tion-api-3s.h"
+#include "../tion-api/tion-api-3s-internal.h"
 #include "../tion-api/tion-api-uart-3s.h"
 
 namespace esphome {
@@ -13,7 +14,11 @@ using Tion3sUartIO = TionUartIO<dentra::tion::Tion3sUartProtocol>;
 
 class Tion3sUartVPort : public TionVPortUARTComponent<Tion3sUartIO, PollingComponent> {
  public:
-  explicit Tion3sUartVPort(io_type *io) : TionVPortUARTComponent(io) {}
+  explicit Tion3sUartVPort(io_type *io) : TionVPortUARTComponent(io) {
+    // every frame ends with magic, timeout is for frames broken by noise
+    io->set_rx_pattern(dentra::tion_3s::FRAME_MAGIC_END);
+    io->set_rx_timeout(50);
+  }
 
   void dump_config() override;
   // TODO нужно ли делать этот запрос
@@ -15,6 +15,7 @@ static const char *const TAG = "tion_4s_uart_vport";
 void Tion4sUartVPort::dump_config() {
   VPORT_UART_LOG("Tion 4S UART");
   ESP_LOGCONFIG(TAG, "  Heartbeat Interval: %.1f s", this->heartbeat_interval_ * 0.001f);
+  this->dump_keepalive_(TAG);
 }
 
 void Tion4sUartVPort::setup() {
@@ -24,14 +25,20 @@ void Tion4sUartVPort::setup() {
     return;
   }
 
-  this->set_interval(this->heartbeat_interval_, [this]() { this->api_->send_heartbeat(); });
+  // heartbeat is timed by esp_timer and written by the I/O or TX task, so slow components do not delay it
+  if (!this->start_keepalive_(dentra::tion_4s::FRAME_TYPE_HEARTBEAT_REQ, nullptr, 0, this->heartbeat_interval_)) {
+    this->set_interval(this->heartbeat_interval_, [this]() { this->api_->send_heartbeat(); });
+  }
 
 #ifdef USE_OTA
   auto *global_ota_callback = ota::get_global_ota_callback();
 
-  // дополнительно пинганем бризер при OTA обновлении
+  // дополнительно пинганем бризер при OTA обновлении, если heartbeat отправляется не таймером
   global_ota_callback->add_on_state_callback([this](ota::OTAState state, float, uint8_t, ota::OTAComponent *) {
     static uint32_t tm{};
+    if (this->keepalive_.is_timer()) {
+      return;
+    }
     if (state == ota::OTAState::OTA_STARTED) {
       // при старте
       tm = millis();
@@ -49,6 +56,7 @@ void Tion4sUartVPort::setup() {
 }
 
 void Tion4sUartVPort::on_shutdown() {
+  this->keepalive_.stop();
   // дополнительно пинганем бризер перед перезагрузкой
   this->api_->send_heartbeat();
   delay(20);  // дадим немного времени чтобы принять ответ
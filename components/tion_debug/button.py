@@ -0,0 +1,27 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import button
+from esphome.const import CONF_SIZE, ENTITY_CATEGORY_DIAGNOSTIC
+
+# pylint: disable-next=relative-beyond-top-level
+from .. import tion
+
+DEPENDENCIES = ["tion"]
+
+TionBlackBoxButton = tion.tion_ns.class_("TionBlackBoxButton", button.Button)
+
+CONFIG_SCHEMA = button.button_schema(
+    TionBlackBoxButton,
+    icon="mdi:record-rec",
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+).extend(
+    {
+        cv.Optional(CONF_SIZE, default=4096): cv.int_range(min=512, max=65535),
+    }
+)
+
+
+async def to_code(config):
+    await button.new_button(config)
+    cg.add_build_flag("-DTION_ENABLE_BLACKBOX")
+    cg.add_build_flag(f"-DTION_BLACKBOX_SIZE={config[CONF_SIZE]}")
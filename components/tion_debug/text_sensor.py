@@ -0,0 +1,34 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import text_sensor
+from esphome.const import ENTITY_CATEGORY_DIAGNOSTIC
+
+# pylint: disable-next=relative-beyond-top-level
+from .. import tion
+
+DEPENDENCIES = ["tion"]
+
+TionTraceTextSensor = tion.tion_ns.class_(
+    "TionTraceTextSensor", text_sensor.TextSensor, cg.PollingComponent
+)
+
+CONFIG_SCHEMA = (
+    text_sensor.text_sensor_schema(
+        TionTraceTextSensor,
+        icon="mdi:timer-sand",
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+    .extend(
+        {
+            cv.GenerateID(tion.CONF_TION_ID): cv.use_id(tion.TionApiComponent),
+        }
+    )
+    .extend(cv.polling_component_schema("60s"))
+)
+
+
+async def to_code(config):
+    parent = await cg.get_variable(config[tion.CONF_TION_ID])
+    var = await text_sensor.new_text_sensor(config, parent)
+    await cg.register_component(var, config)
+    cg.add_build_flag("-DTION_ENABLE_TRACE")
@@ -0,0 +1,23 @@
+#pragma once
+#include "esphome/core/defines.h"
+#ifdef TION_ENABLE_BLACKBOX
+
+#include "esphome/components/button/button.h"
+
+#include "../tion-api/tion-api-blackbox.h"
+
+namespace esphome {
+namespace tion {
+
+/// Dumps recorded frames to the log.
+class TionBlackBoxButton : public button::Button {
+  constexpr static const auto *TAG = "tion_blackbox";
+
+ protected:
+  void press_action() override { dentra::tion::TionBlackBox::get().dump(TAG); }
+};
+
+}  // namespace tion
+}  // namespace esphome
+
+#endif  // TION_ENABLE_BLACKBOX
@@ -15,6 +15,8 @@ class TionVPortHostComponent : public vport::VPortUARTComponent<io_t, typename i
  public:
   explicit TionVPortHostComponent(io_t *io) : super_t(io) {}
   TionVPortType get_type() const { return TionVPortType::VPORT_UART; }
+
+  dentra::tion::TionLinkStats *get_link_stats() { return this->io_->get_link_stats(); }
 };
 
 }  // namespace tion
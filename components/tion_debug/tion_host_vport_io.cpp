@@ -1,8 +1,7 @@
 #include "esphome/core/defines.h"
 
-#ifndef USE_HOST
-#error "Only for host platform"
-#endif
+// host vport is only for host platform, other components of tion_debug are available everywhere
+#ifdef USE_HOST
 
 #include "esphome/core/log.h"
 #include "esphome/core/log.h"
@@ -87,3 +86,5 @@ void TionLtHostIO::update_state_() {
 
 }  // namespace tion
 }  // namespace esphome
+
+#endif  // USE_HOST
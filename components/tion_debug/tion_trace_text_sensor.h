@@ -0,0 +1,31 @@
+#pragma once
+#include "esphome/core/defines.h"
+#ifdef TION_ENABLE_TRACE
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+
+#include "../tion/tion_component.h"
+
+namespace esphome {
+namespace tion {
+
+/// Publishes p50/p95/max latency of every trace stage of received states.
+class TionTraceTextSensor : public text_sensor::TextSensor,
+                            public PollingComponent,
+                            public Parented<TionApiComponent> {
+  constexpr static const auto *TAG = "tion_trace";
+
+ public:
+  explicit TionTraceTextSensor(TionApiComponent *api) : Parented(api) {}
+
+  void dump_config() override { LOG_TEXT_SENSOR("", "Tion Trace", this); }
+
+  void update() override { this->publish_state(this->parent_->api()->get_trace().to_string()); }
+};
+
+}  // namespace tion
+}  // namespace esphome
+
+#endif  // TION_ENABLE_TRACE
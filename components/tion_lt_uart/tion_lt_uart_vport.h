@@ -12,7 +12,7 @@ using TionLtUartIO = TionUartIO<dentra::tion_lt::TionLtUartProtocol>;
 
 class TionLtUartVPort : public TionVPortUARTComponent<TionLtUartIO> {
  public:
-  explicit TionLtUartVPort(io_type *io) : TionVPortUARTComponent(io) {}
+  explicit TionLtUartVPort(io_type *io) : TionVPortUARTComponent(io) { io->set_rx_pattern('\n'); }
 
   void dump_config() override;
 
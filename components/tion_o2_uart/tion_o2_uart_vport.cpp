@@ -8,7 +8,39 @@ namespace tion {
 
 static const char *const TAG = "tion_o2_uart_vport";
 
-void TionO2UartVPort::dump_config() { VPORT_UART_LOG("Tion O2 UART"); }
+void TionO2UartVPort::dump_config() {
+  VPORT_UART_LOG("Tion O2 UART");
+  this->dump_keepalive_(TAG);
+}
+
+void TionO2UartVPort::setup() {
+  if (this->work_mode_interval_ == 0 || this->api_ == nullptr) {
+    return;
+  }
+  // режим работы отсчитывается таймером и записывается задачей ввода-вывода или отправки,
+  // так что медленные компоненты не задерживают его
+  const dentra::tion_o2::WorkModeFlags work_mode{
+      .ma_pair_accepted = {},
+      .rf_connected = {},
+      .ma_pairing = {},
+      .ma_auto = true,
+      .ma_connected = {},
+      .reserved = 0,
+  };
+  this->keepalive_.set_enabled(false);
+  if (!this->start_keepalive_(dentra::tion_o2::FRAME_TYPE_SET_WORK_MODE_REQ, &work_mode, sizeof(work_mode),
+                              this->work_mode_interval_)) {
+    ESP_LOGW(TAG, "Failed to start work mode refresh");
+  }
+}
+
+void TionO2UartVPort::loop() {
+  if (this->api_ != nullptr) {
+    // обновляем режим работы только в автоматическом режиме, как и update_work_mode
+    this->keepalive_.set_enabled(this->api_->get_state().auto_state);
+  }
+  TionVPortUARTComponent::loop();
+}
 
 }  // namespace tion
 }  // namespace esphome
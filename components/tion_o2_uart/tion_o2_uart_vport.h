@@ -13,11 +13,23 @@ using TionO2UartIO = TionUartIO<dentra::tion_o2::TionO2UartProtocol>;
 
 class TionO2UartVPort : public TionVPortUARTComponent<TionO2UartIO> {
  public:
-  explicit TionO2UartVPort(io_type *io) : TionVPortUARTComponent(io) {}
+  explicit TionO2UartVPort(io_type *io) : TionVPortUARTComponent(io) {
+    // frames have no end marker, so wait until line becomes idle
+    io->set_rx_timeout(10);
+  }
 
   void dump_config() override;
+  void setup() override;
+  void loop() override;
+  void on_shutdown() override { this->keepalive_.stop(); }
 
-  void set_api(void *) {}
+  void set_api(dentra::tion_o2::TionO2Api *api) { this->api_ = api; }
+  /// Interval of work mode refresh in auto mode, 0 disables refresh.
+  void set_work_mode_interval(uint32_t work_mode_interval) { this->work_mode_interval_ = work_mode_interval; }
+
+ protected:
+  uint32_t work_mode_interval_{};
+  dentra::tion_o2::TionO2Api *api_{};
 };
 
 }  // namespace tion
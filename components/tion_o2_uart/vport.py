@@ -1,16 +1,25 @@
 import esphome.codegen as cg
+import esphome.config_validation as cv
 
 # pylint: disable-next=relative-beyond-top-level
 from .. import tion, vport
 
 AUTO_LOAD = ["vport", "tion"]
 
-TionO2UartVPort = tion.tion_ns.class_("TionO2UartVPort", cg.Component, vport.VPort)
+CONF_WORK_MODE_INTERVAL = "work_mode_interval"
+
+TionO2UartVPort = tion.tion_ns.class_("TionO2UartVPort", tion.TionVPortUARTComponent)
 TionO2UartIO = tion.tion_ns.class_("TionO2UartIO")
 
-CONFIG_SCHEMA = vport.vport_uart_schema(TionO2UartVPort, TionO2UartIO)
+CONFIG_SCHEMA = vport.vport_uart_schema(TionO2UartVPort, TionO2UartIO).extend(
+    {
+        cv.Optional(CONF_WORK_MODE_INTERVAL): cv.positive_time_period_milliseconds,
+    }
+)
 
 
 async def to_code(config):
-    await vport.setup_vport_uart(config)
+    var = await vport.setup_vport_uart(config)
+    if CONF_WORK_MODE_INTERVAL in config:
+        cg.add(var.set_work_mode_interval(config[CONF_WORK_MODE_INTERVAL]))
     cg.add_define("USE_TION_O2")
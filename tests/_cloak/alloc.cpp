@@ -0,0 +1,32 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "cloak.h"
+
+namespace cloak {
+
+// tests may allocate from several threads
+static std::atomic<size_t> alloc_count_{};
+
+size_t alloc_count() { return alloc_count_.load(std::memory_order_relaxed); }
+
+}  // namespace cloak
+
+// Global allocation functions counting every heap allocation.
+
+void *operator new(std::size_t size) {
+  cloak::alloc_count_.fetch_add(1, std::memory_order_relaxed);
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
@@ -1,6 +1,10 @@
+#include <cstdio>
 #include <map>
 #include <set>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/components/logger/logger.h"
@@ -56,6 +60,20 @@ bool run_tests(const std::set<std::string> &run_only) {
   return failed_tests.empty();
 }
 
+MuteStdout::MuteStdout() {
+  std::fflush(stdout);
+  this->fd_ = dup(STDOUT_FILENO);
+  int null_fd = open("/dev/null", O_WRONLY);
+  dup2(null_fd, STDOUT_FILENO);
+  close(null_fd);
+}
+
+MuteStdout::~MuteStdout() {
+  std::fflush(stdout);
+  dup2(this->fd_, STDOUT_FILENO);
+  close(this->fd_);
+}
+
 int run_tests(int argc, char const *argv[]) {
   std::set<std::string> run_only;
   for (int i = 1; i < argc; i++) {
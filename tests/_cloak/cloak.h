@@ -25,6 +25,29 @@ int run_tests(int argc, char const *argv[]);
 
 std::vector<uint8_t> from_hex(const std::string &hex);
 
+/// Number of heap allocations made with global operator new since start.
+size_t alloc_count();
+
+/// Counts heap allocations made during its lifetime.
+class AllocCounter {
+ public:
+  AllocCounter() : start_(alloc_count()) {}
+  size_t count() const { return alloc_count() - this->start_; }
+
+ protected:
+  size_t start_;
+};
+
+/// Redirects stdout to /dev/null during its lifetime.
+class MuteStdout {
+ public:
+  MuteStdout();
+  ~MuteStdout();
+
+ protected:
+  int fd_;
+};
+
 inline std::string hexencode(const void *data, size_t size) {
   return esphome::format_hex_pretty(static_cast<const uint8_t *>(data), size);
 }
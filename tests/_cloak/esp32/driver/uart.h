@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/components/uart/uart_component_esp_idf.h"
+
+#ifndef esp_err_t
+#define esp_err_t int
+#endif
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+#ifndef ESP_FAIL
+#define ESP_FAIL 1
+#endif
+
+typedef int uart_port_t;
+
+// Pattern detection of the ESP-IDF uart driver backed by cloak uart component.
+
+inline esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t uart_num, char pattern_chr, uint8_t chr_num,
+                                                   int chr_tout, int post_idle, int pre_idle) {
+  auto *uart = esphome::uart::IDFUARTComponent::test_get(uart_num);
+  if (uart == nullptr || chr_num != 1) {
+    return ESP_FAIL;
+  }
+  uart->test_pattern_enable(pattern_chr);
+  return ESP_OK;
+}
+
+inline esp_err_t uart_pattern_queue_reset(uart_port_t uart_num, int queue_length) {
+  return esphome::uart::IDFUARTComponent::test_get(uart_num) ? ESP_OK : ESP_FAIL;
+}
+
+inline int uart_pattern_pop_pos(uart_port_t uart_num) {
+  auto *uart = esphome::uart::IDFUARTComponent::test_get(uart_num);
+  return uart ? uart->test_pattern_pop_pos() : -1;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/helpers.h"
+
+#ifndef esp_err_t
+#define esp_err_t int
+#endif
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+#ifndef ESP_FAIL
+#define ESP_FAIL 1
+#endif
+
+// esp_timer backed by cloak millis. Timers are fired by esp_timer_test_run, so tests can advance time without
+// running loop to simulate its stalls.
+
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum {
+  ESP_TIMER_TASK,
+} esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void *arg;
+  uint64_t period_us;
+  uint64_t next_us;
+};
+
+typedef struct esp_timer *esp_timer_handle_t;
+
+inline std::vector<esp_timer_handle_t> &esp_timer_test_timers() {
+  static std::vector<esp_timer_handle_t> timers;
+  return timers;
+}
+
+inline int64_t esp_timer_get_time() { return int64_t(esphome::millis()) * 1000; }
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle) {
+  *out_handle = new esp_timer{args->callback, args->arg, 0, 0};
+  esp_timer_test_timers().push_back(*out_handle);
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+  timer->period_us = period;
+  timer->next_us = esp_timer_get_time() + period;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  timer->period_us = 0;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  auto &timers = esp_timer_test_timers();
+  for (auto it = timers.begin(); it != timers.end(); ++it) {
+    if (*it == timer) {
+      timers.erase(it);
+      break;
+    }
+  }
+  delete timer;
+  return ESP_OK;
+}
+
+/// Fires all timers due at the current cloak time.
+inline void esp_timer_test_run() {
+  const uint64_t now = esp_timer_get_time();
+  for (auto *timer : esp_timer_test_timers()) {
+    while (timer->period_us != 0 && timer->next_us <= now) {
+      timer->next_us += timer->period_us;
+      timer->callback(timer->arg);
+    }
+  }
+}
@@ -66,6 +66,7 @@ class BinarySensor : public EntityBase {
 
   /// Return whether this binary sensor has outputted a state.
   virtual bool has_state() const;
+  void set_has_state(bool state) { this->has_state_ = state; }
 
   virtual bool is_status_binary_sensor() const;
 
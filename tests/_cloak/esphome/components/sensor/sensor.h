@@ -140,6 +140,7 @@ class Sensor : public EntityBase {
 
   /// Return whether this sensor has gotten a full state (that passed through all filters) yet.
   bool has_state() const;
+  void set_has_state(bool state) { this->has_state_ = state; }
 
   /** A unique ID for this sensor, empty for no unique id. See unique ID requirements:
    * https://developers.home-assistant.io/docs/en/entity_registry_index.html#unique-id-requirements
@@ -55,6 +55,7 @@ class TextSensor : public EntityBase {
   virtual std::string unique_id();
 
   bool has_state();
+  void set_has_state(bool state) { this->has_state_ = state; }
 
   void internal_send_state_to_frontend(const std::string &state);
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -35,21 +36,113 @@ class UARTComponent : public cloak::Cloak {
     this->write_array(data, strlen(str));
   };
 
-  int available() { return this->str_uart_.available(); }
-  bool read_array(void *data, size_t size) { return this->str_uart_.read_array(data, size); }
+  int available() { return this->rx_live_ ? this->rx_arrived_() - this->rx_pos_ : this->str_uart_.available(); }
+  bool read_array(void *data, size_t size) {
+    if (!this->rx_live_) {
+      return this->str_uart_.read_array(data, size);
+    }
+    if (size > this->rx_arrived_() - this->rx_pos_) {
+      return false;
+    }
+    std::memcpy(data, this->rx_data_.data() + this->rx_pos_, size);
+    this->rx_pos_ += size;
+    return true;
+  }
   int read() { return this->str_uart_.read(); }
   bool read_byte(uint8_t *ch) { return this->str_uart_.read_byte(ch); }
   bool peek_byte(uint8_t *data) { return this->str_uart_.peek_byte(data); }
 
   void write_array(const uint8_t *data, size_t len) {
     this->cloak_data_.insert(this->cloak_data_.end(), data, data + len);
+    this->tx_write_(len);
   }
   void write_array(const std::vector<uint8_t> &data) { this->write_array(&data[0], data.size()); }
   void write_byte(uint8_t data) { this->write_array(&data, 1); }
-  void flush() {}
+  void flush() {
+    // wait until TX FIFO is drained
+    const double now = this->tx_now_us_();
+    if (this->tx_done_us_ > now) {
+      this->tx_blocked_us_ += this->tx_done_us_ - now;
+    }
+  }
+
+  void set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
+  uint32_t get_baud_rate() const { return this->baud_rate_; }
+
+  /// Total time spent in write_array and flush waiting for TX FIFO, simulated with baud rate set.
+  uint32_t get_tx_blocked_us() const { return this->tx_blocked_us_; }
+
+  /// Starts receiving data from the other side, bytes arrive one by one with baud rate from now.
+  void test_rx_push(const std::vector<uint8_t> &data) {
+    this->rx_live_ = true;
+    const double byte_us = this->baud_rate_ == 0 ? 0 : 10.0 * 1000000 / this->baud_rate_;
+    double time_us = std::max(this->tx_now_us_(), this->rx_time_us_.empty() ? 0 : this->rx_time_us_.back());
+    for (auto byte : data) {
+      time_us += byte_us;
+      this->rx_data_.push_back(byte);
+      this->rx_time_us_.push_back(time_us);
+    }
+  }
+  /// Time when the last pushed byte arrives.
+  uint32_t test_rx_last_us() const { return this->rx_time_us_.empty() ? 0 : this->rx_time_us_.back(); }
+
+  /// Pattern detection as ESP-IDF uart driver does it.
+  void test_pattern_enable(uint8_t pattern) {
+    this->rx_pattern_ = pattern;
+    this->rx_pattern_pos_ = this->rx_arrived_();
+  }
+  /// @return position of the next arrived pattern byte relative to the read position or -1.
+  int test_pattern_pop_pos() {
+    const size_t arrived = this->rx_arrived_();
+    while (this->rx_pattern_ >= 0 && this->rx_pattern_pos_ < arrived) {
+      const size_t pos = this->rx_pattern_pos_++;
+      if (this->rx_data_[pos] == this->rx_pattern_) {
+        return pos < this->rx_pos_ ? 0 : pos - this->rx_pos_;
+      }
+    }
+    return -1;
+  }
+  /// Drops positions of arrived pattern bytes, as the driver does when its pattern queue overflows.
+  void test_pattern_drop() { this->rx_pattern_pos_ = std::max(this->rx_pattern_pos_, this->rx_arrived_()); }
 
  protected:
+  static constexpr size_t TX_FIFO_SIZE = 128;
+
   cloak::internal::StringUart str_uart_;
+  uint32_t baud_rate_{};
+  double tx_blocked_us_{};
+  // time when TX FIFO becomes empty
+  double tx_done_us_{};
+
+  bool rx_live_{};
+  std::vector<uint8_t> rx_data_;
+  std::vector<double> rx_time_us_;
+  size_t rx_pos_{};
+  int rx_pattern_{-1};
+  size_t rx_pattern_pos_{};
+
+  // uart time goes forward by the blocked time
+  double tx_now_us_() const { return double(millis()) * 1000 + this->tx_blocked_us_; }
+
+  // number of received bytes arrived by now
+  size_t rx_arrived_() const {
+    const double now = this->tx_now_us_();
+    return std::upper_bound(this->rx_time_us_.begin(), this->rx_time_us_.end(), now) - this->rx_time_us_.begin();
+  }
+
+  void tx_write_(size_t len) {
+    if (this->baud_rate_ == 0) {
+      return;
+    }
+    const double byte_us = 10.0 * 1000000 / this->baud_rate_;
+    const double now = this->tx_now_us_();
+    this->tx_done_us_ = std::max(this->tx_done_us_, now) + len * byte_us;
+    // writer is blocked until the rest of data fits to FIFO
+    const double overflow_us = this->tx_done_us_ - now - TX_FIFO_SIZE * byte_us;
+    if (overflow_us > 0) {
+      this->tx_blocked_us_ += overflow_us;
+    }
+  }
 };
 
 }  // namespace uart
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "uart_component.h"
+
+namespace esphome {
+namespace uart {
+
+// Hardware uart with number, backs the fake ESP-IDF uart driver functions.
+class IDFUARTComponent : public UARTComponent {
+ public:
+  explicit IDFUARTComponent(uint8_t uart_num) : uart_num_(uart_num) { uarts_[uart_num] = this; }
+  ~IDFUARTComponent() { uarts_[this->uart_num_] = nullptr; }
+
+  uint8_t get_hw_serial_number() { return this->uart_num_; }
+
+  static IDFUARTComponent *test_get(uint8_t uart_num) { return uart_num < UART_NUM_MAX ? uarts_[uart_num] : nullptr; }
+
+ protected:
+  static constexpr uint8_t UART_NUM_MAX = 3;
+  static inline IDFUARTComponent *uarts_[UART_NUM_MAX]{};
+  uint8_t uart_num_;
+};
+
+}  // namespace uart
+}  // namespace esphome
@@ -306,6 +306,10 @@ class PollingComponent : public Component {
   /// Get the update interval in ms of this sensor
   virtual uint32_t get_update_interval() const { return this->update_interval_; }
 
+  // poller is not emulated, update() is called by tests.
+  void start_poller() {}
+  void stop_poller() {}
+
  protected:
   uint32_t update_interval_;
 };
@@ -1,3 +1,5 @@
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
 
 #include "helpers.h"
@@ -122,12 +124,25 @@ size_t parse_hex(const char *str, size_t length, uint8_t *data, size_t count) {
   return chars;
 }
 
-uint32_t _millis{};
+// set by the test, read by I/O tasks too
+std::atomic<uint32_t> _millis{};
 
 uint32_t millis() { return _millis; }
 
+bool _real_micros{};
+
+uint32_t micros() {
+  if (_real_micros) {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+  }
+  return _millis * 1000;
+}
+
 void test_set_millis(uint32_t millis) { _millis = millis; }
 
+void test_set_real_micros(bool real_micros) { _real_micros = real_micros; }
+
 std::string _mac_address = "000000000000";
 std::string get_mac_address() { return _mac_address; }
 
@@ -62,7 +62,10 @@ using std::is_trivially_copyable;
 using std::is_invocable;
 
 uint32_t millis();
+uint32_t micros();
 void test_set_millis(uint32_t millis);
+/// Makes micros() return time of the host steady clock instead of millis() * 1000, used by benchmarks.
+void test_set_real_micros(bool real_micros);
 
 inline void get_mac_address_raw(uint8_t *mac) { mac[0] = mac[1] = mac[2] = mac[3] = mac[4] = mac[5] = 0; }
 
@@ -142,6 +145,17 @@ bool str_endswith(const std::string &str, const std::string &end);
 using std::to_string;
 
 /// Helper class to easily give an object a parent of type \p T.
+/// Vector with capacity set once with init(), as esphome FixedVector.
+template<typename T> class FixedVector : public std::vector<T> {
+ public:
+  FixedVector() = default;
+  FixedVector(std::initializer_list<T> init) : std::vector<T>(init) {}
+  void init(size_t n) {
+    this->clear();
+    this->reserve(n);
+  }
+};
+
 template<typename T> class Parented {
  public:
   Parented() {}
@@ -51,6 +51,8 @@ fi
 OUT=$BLD/tests
 if [ "$1" == "info" ]; then
   size $OUT
+elif [ "$1" == "bench" ]; then
+  $BLD/benchmarks "${@:2}"
 elif [ "$1" != "build" ]; then
   $OUT $*
 fi
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "cloak.h"
+
+#include "bench.h"
+
+/*
+Usage: benchmarks [--filter <substr>] [--min-time <ms>] [--json <file>] [--compare <baseline.json>]
+                  [--threshold <percent>]
+
+Results are written as JSON to stdout or to the --json file. With --compare every benchmark is checked against
+the baseline and the run fails if it is slower by more than --threshold percent (10 by default).
+*/
+
+namespace bench {
+
+namespace {
+
+struct Bench {
+  std::string name;
+  bench_fn_t fn;
+};
+
+struct Result {
+  std::string name;
+  size_t iterations;
+  double ns_per_op;
+};
+
+std::vector<Bench> &benches() {
+  static std::vector<Bench> benches;
+  return benches;
+}
+
+std::vector<report_fn_t> &reports() {
+  static std::vector<report_fn_t> reports;
+  return reports;
+}
+
+Result run_bench(const Bench &bench, double min_time_ms) {
+  // warm up caches and lazy statics
+  bench.fn(1);
+  size_t iterations = 1;
+  while (true) {
+    const auto t1 = std::chrono::steady_clock::now();
+    bench.fn(iterations);
+    const auto t2 = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(t2 - t1).count();
+    if (ns >= min_time_ms * 1e6 || iterations >= (size_t(1) << 40)) {
+      return {bench.name, iterations, ns / iterations};
+    }
+    // aim at 1.5 of min time to avoid another round
+    const double scale = ns > 0 ? min_time_ms * 1e6 * 1.5 / ns : 100;
+    iterations = std::max(iterations * 2, size_t(iterations * std::min(scale, 100.0)));
+  }
+}
+
+std::string to_json(const std::vector<Result> &results) {
+  std::ostringstream os;
+  os << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    char ns[32];
+    std::snprintf(ns, sizeof(ns), "%.3f", results[i].ns_per_op);
+    os << "    {\"name\": \"" << results[i].name << "\", \"iterations\": " << results[i].iterations
+       << ", \"ns_per_op\": " << ns << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}\n";
+  return os.str();
+}
+
+// Reads name and ns_per_op pairs from the file written by to_json.
+bool load_baseline(const char *path, std::map<std::string, double> *baseline) {
+  std::ifstream is(path);
+  if (!is) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << is.rdbuf();
+  const std::string json = ss.str();
+  static const std::string NAME = "\"name\": \"";
+  static const std::string NS_PER_OP = "\"ns_per_op\": ";
+  for (size_t pos = json.find(NAME); pos != std::string::npos; pos = json.find(NAME, pos)) {
+    pos += NAME.size();
+    const size_t end = json.find('"', pos);
+    const size_t ns = json.find(NS_PER_OP, end);
+    if (end == std::string::npos || ns == std::string::npos) {
+      return false;
+    }
+    (*baseline)[json.substr(pos, end - pos)] = std::strtod(json.c_str() + ns + NS_PER_OP.size(), nullptr);
+  }
+  return true;
+}
+
+}  // namespace
+
+void register_bench(const std::string &name, bench_fn_t fn) { benches().push_back({name, fn}); }
+
+void register_report(report_fn_t fn) { reports().push_back(fn); }
+
+int run_benches(int argc, char const *argv[]) {
+  const char *filter = nullptr;
+  const char *json_path = nullptr;
+  const char *baseline_path = nullptr;
+  double min_time_ms = 100;
+  double threshold = 10;
+  for (int i = 1; i < argc; i++) {
+    const bool has_value = i + 1 < argc;
+    if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+      filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--min-time") == 0 && has_value) {
+      min_time_ms = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--json") == 0 && has_value) {
+      json_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--compare") == 0 && has_value) {
+      baseline_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--threshold") == 0 && has_value) {
+      threshold = std::atof(argv[++i]);
+    } else {
+      std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  std::map<std::string, double> baseline;
+  if (baseline_path != nullptr && !load_baseline(baseline_path, &baseline)) {
+    std::fprintf(stderr, "Failed to load baseline %s\n", baseline_path);
+    return 2;
+  }
+
+  std::vector<Result> results;
+  for (auto &bench : benches()) {
+    if (filter != nullptr && bench.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    Result result;
+    {
+      // verbose component logging goes to stdout
+      cloak::MuteStdout mute;
+      result = run_bench(bench, min_time_ms);
+    }
+    std::fprintf(stderr, "%-40s %12.1f ns/op %12zu iterations\n", result.name.c_str(), result.ns_per_op,
+                 result.iterations);
+    results.push_back(result);
+  }
+  for (auto report : reports()) {
+    report();
+  }
+
+  const auto json = to_json(results);
+  if (json_path != nullptr) {
+    std::ofstream(json_path) << json;
+  } else {
+    std::fputs(json.c_str(), stdout);
+  }
+
+  if (baseline_path == nullptr) {
+    return 0;
+  }
+
+  size_t regressions = 0;
+  std::fprintf(stderr, "\nCompared with %s, threshold %.1f%%:\n", baseline_path, threshold);
+  for (auto &result : results) {
+    auto it = baseline.find(result.name);
+    if (it == baseline.end() || it->second <= 0) {
+      std::fprintf(stderr, "%-40s %12.1f ns/op      new\n", result.name.c_str(), result.ns_per_op);
+      continue;
+    }
+    const double change = (result.ns_per_op - it->second) * 100 / it->second;
+    const bool regression = change > threshold;
+    regressions += regression;
+    std::fprintf(stderr, "%-40s %12.1f ns/op %+8.1f%%%s\n", result.name.c_str(), result.ns_per_op, change,
+                 regression ? "  REGRESSION" : "");
+  }
+  if (regressions > 0) {
+    std::fprintf(stderr, "%zu regression(s) found\n", regressions);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace bench
+
+int main(int argc, char const *argv[]) { return bench::run_benches(argc, argv); }
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace bench {
+
+/// Runs benchmarked operation given number of times.
+typedef void (*bench_fn_t)(size_t iterations);
+
+void register_bench(const std::string &name, bench_fn_t fn);
+
+/// Prints additional results to stderr after all benchmarks are run.
+typedef void (*report_fn_t)();
+
+void register_report(report_fn_t fn);
+
+/// Runs benchmarks and compares them with the baseline, see usage in bench.cpp.
+int run_benches(int argc, char const *argv[]);
+
+/// Prevents the compiler from optimizing value away.
+template<class T> inline void do_not_optimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+}  // namespace bench
@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+
+#include "../../components/tion-api/crc.h"
+
+#include "bench_models.h"
+#include "bench.h"
+
+namespace {
+
+// Exposes state pipeline internals.
+template<class api_t> class BenchApi : public api_t {
+ public:
+  using api_t::make_write_state_;
+  using api_t::notify_state_;
+};
+
+// Api with received state response.
+template<class M> class ModelApi : public BenchApi<typename M::api_type> {
+ public:
+  std::vector<uint8_t> state_data;
+
+  ModelApi() : state_data(dentra::tion::find_frame_handler(M::handlers(), M::state_type())->size) {
+    for (size_t i = 0; i < this->state_data.size(); i++) {
+      this->state_data[i] = i * 7;
+    }
+    this->set_on_state([](const dentra::tion::TionState &, uint32_t, dentra::tion::TionStateChangeMask) {});
+    this->read_frame(M::state_type(), this->state_data.data(), this->state_data.size());
+  }
+};
+
+template<class M> void bench_read_frame(size_t iterations) {
+  static ModelApi<M> api;
+  for (size_t i = 0; i < iterations; i++) {
+    bench::do_not_optimize(api.read_frame(M::state_type(), api.state_data.data(), api.state_data.size()));
+  }
+}
+
+template<class M> void bench_crc(size_t iterations) {
+  static ModelApi<M> api;
+  uint16_t crc = 0;
+  for (size_t i = 0; i < iterations; i++) {
+    crc ^= dentra::tion::crc16_ccitt_false_ffff(api.state_data.data(), api.state_data.size());
+    bench::do_not_optimize(crc);
+  }
+}
+
+template<class M> void bench_make_write_state(size_t iterations) {
+  static ModelApi<M> api;
+  dentra::tion::TionStateCall call(&api);
+  call.set_fan_speed(2);
+  call.set_target_temperature(20);
+  call.set_power_state(true);
+  for (size_t i = 0; i < iterations; i++) {
+    bench::do_not_optimize(api.make_write_state_(&call));
+  }
+}
+
+template<class M> void bench_notify_state(size_t iterations) {
+  static ModelApi<M> api;
+  for (size_t i = 0; i < iterations; i++) {
+    api.notify_state_(i);
+  }
+}
+
+template<class M> void register_model() {
+  const std::string name(M::NAME);
+  bench::register_bench(name + "/read_frame", bench_read_frame<M>);
+  bench::register_bench(name + "/crc16_ccitt_false", bench_crc<M>);
+  bench::register_bench(name + "/make_write_state", bench_make_write_state<M>);
+  bench::register_bench(name + "/notify_state", bench_notify_state<M>);
+}
+
+struct ApiBenchReg {
+  ApiBenchReg() {
+    register_model<bench::Model4s>();
+    register_model<bench::Model3s>();
+    register_model<bench::ModelLt>();
+    register_model<bench::ModelO2>();
+  }
+} api_bench_reg;
+
+}  // namespace
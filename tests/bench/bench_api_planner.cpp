@@ -0,0 +1,80 @@
+#include <cstdio>
+
+#include "../test_api_planner.h"
+
+#include "bench.h"
+
+namespace {
+
+using Planner = dentra::tion::TionApiBase::RequestPlanner;
+
+// Ten minutes of 1 s polls per iteration, traffic of the last one is reported.
+// Index 0 is requested always, 1 is requested on change.
+PlannerLinkStat stat_4s[2];
+PlannerLinkStat stat_lt[2];
+PlannerLinkStat stat_o2[2];
+
+Planner::Policy planner_policy(size_t planned) { return planned ? Planner::ON_CHANGE : Planner::ALWAYS; }
+
+template<size_t planned> void bench_planner_4s(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    Planner4s fake;
+    fake.api.set_request_policy(dentra::tion_4s::Tion4sApi::REQUEST_TURBO, planner_policy(planned),
+                                TION_4S_TURBO_REFRESH_INTERVAL);
+    stat_4s[planned] = run_planner_fast_mode(fake);
+  }
+}
+
+template<size_t planned> void bench_planner_lt(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    PlannerLt fake;
+    stat_lt[planned] = run_planner_fast_mode(fake);
+  }
+}
+
+template<size_t planned> void bench_planner_o2(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    PlannerO2 fake;
+    fake.api.set_request_policy(dentra::tion_o2::TionO2Api::REQUEST_DEV_MODE, planner_policy(planned),
+                                TION_O2_DEV_MODE_REFRESH_INTERVAL);
+    stat_o2[planned] = run_planner_fast_mode(fake);
+  }
+}
+
+void report_planner_stat(const char *model, const PlannerLinkStat *stat, uint32_t baud_rate) {
+  const char *modes[] = {"always", "changed"};
+  for (size_t planned = 0; planned < 2; planned++) {
+    const auto &s = stat[planned];
+    if (s.frames == 0) {
+      continue;
+    }
+    if (baud_rate == 0) {
+      std::fprintf(stderr, "%-9s %-7s: %4zu frames/min, %6zu bytes/min, %4zu packets/min\n", model, modes[planned],
+                   s.frames, s.bytes, s.packets);
+    } else {
+      // 10 bits per byte on the wire
+      std::fprintf(stderr, "%-9s %-7s: %4zu frames/min, %6zu bytes/min, bus %.2f%%\n", model, modes[planned], s.frames,
+                   s.bytes, s.bytes * 10 * 100.0f / (baud_rate * 60.0f));
+    }
+  }
+}
+
+void report_planner() {
+  report_planner_stat("4s ble", stat_4s, 0);
+  report_planner_stat("lt ble", stat_lt, 0);
+  report_planner_stat("o2 uart", stat_o2, 115200);
+}
+
+struct PlannerBenchReg {
+  PlannerBenchReg() {
+    bench::register_bench("4s/planner_always", bench_planner_4s<0>);
+    bench::register_bench("4s/planner_on_change", bench_planner_4s<1>);
+    bench::register_bench("lt/planner_always", bench_planner_lt<0>);
+    bench::register_bench("lt/planner_on_change", bench_planner_lt<1>);
+    bench::register_bench("o2/planner_always", bench_planner_o2<0>);
+    bench::register_bench("o2/planner_on_change", bench_planner_o2<1>);
+    bench::register_report(report_planner);
+  }
+} planner_bench_reg;
+
+}  // namespace
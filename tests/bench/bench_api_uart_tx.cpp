@@ -0,0 +1,53 @@
+#include <cstdio>
+
+#include "../test_api_uart_tx.h"
+
+#include "bench.h"
+
+namespace {
+
+// 4s timers setup is the largest burst: 12 frames
+constexpr size_t TX_FRAMES = 12;
+constexpr size_t TX_DATA_SIZE = 10;
+constexpr uint32_t TX_BAUD_RATE = 9600;
+
+// Result of the last burst is reported, index 0 is write+flush, 1 is tx queue.
+TxResult tx_result[2];
+bool tx_done[2];
+
+template<class io_t> void bench_tx_burst(size_t index, size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    esphome::uart::UARTComponent uart;
+    uart.set_baud_rate(TX_BAUD_RATE);
+    io_t io(&uart);
+    tx_result[index] = run_tx_burst(io, uart, TX_FRAMES, TX_DATA_SIZE);
+    tx_done[index] = true;
+  }
+}
+
+void bench_tx_blocking(size_t iterations) { bench_tx_burst<TxBlockingUartIO>(0, iterations); }
+
+void bench_tx_queued(size_t iterations) { bench_tx_burst<TxUartIO>(1, iterations); }
+
+void report_tx() {
+  if (tx_done[0]) {
+    const auto &r = tx_result[0];
+    std::fprintf(stderr, "%zu frames at %u: write+flush blocked %u us in write, %u us max per loop\n", TX_FRAMES,
+                 TX_BAUD_RATE, r.write_us, r.loop_us_max);
+  }
+  if (tx_done[1]) {
+    const auto &r = tx_result[1];
+    std::fprintf(stderr, "%zu frames at %u: tx queue    blocked %u us in write, %u us max per loop, sent in %u ms\n",
+                 TX_FRAMES, TX_BAUD_RATE, r.write_us, r.loop_us_max, r.done_ms);
+  }
+}
+
+struct UartTxBenchReg {
+  UartTxBenchReg() {
+    bench::register_bench("4s/uart_tx_burst_blocking", bench_tx_blocking);
+    bench::register_bench("4s/uart_tx_burst_queued", bench_tx_queued);
+    bench::register_report(report_tx);
+  }
+} uart_tx_bench_reg;
+
+}  // namespace
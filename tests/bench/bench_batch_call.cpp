@@ -0,0 +1,55 @@
+#include <cstdio>
+
+#include "../test_batch_call.h"
+
+#include "bench.h"
+
+namespace {
+
+// Result of the last run is reported.
+BatchResult slider_unbound;
+BatchResult slider;
+BatchResult clicks;
+
+void bench_slider_unbound(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    slider_unbound = run_batch_slider(200, 0);
+  }
+}
+
+void bench_slider(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    slider = run_batch_slider(200, 1000);
+  }
+}
+
+void bench_clicks(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    clicks = run_batch_clicks(200, 1000);
+  }
+}
+
+void report_batch_result(const char *name, const BatchResult &r) {
+  if (r.calls == 0) {
+    return;
+  }
+  std::fprintf(stderr, "%-28s: %2zu calls, %2zu frames, worst latency %4u ms\n", name, r.calls, r.frames,
+               r.latency_max);
+}
+
+void report_batch() {
+  report_batch_result("slider, debounce only", slider_unbound);
+  report_batch_result("slider, debounce + 1 s max", slider);
+  report_batch_result("clicks, debounce + 1 s max", clicks);
+}
+
+struct BatchBenchReg {
+  BatchBenchReg() {
+    bench::register_bench("4s/batch_slider_debounce", bench_slider_unbound);
+    bench::register_bench("4s/batch_slider_max_latency", bench_slider);
+    bench::register_bench("4s/batch_clicks_max_latency", bench_clicks);
+    bench::register_report(report_batch);
+  }
+} batch_bench_reg;
+
+}  // namespace
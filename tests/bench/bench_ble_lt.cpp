@@ -0,0 +1,65 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../components/tion-api/tion-api-ble-lt.h"
+
+#include "bench.h"
+
+namespace {
+
+using dentra::tion::TionLtBleProtocol;
+using packets_t = std::vector<std::vector<uint8_t>>;
+
+// Protocol receiving packets of the frame with random payload of given size.
+template<size_t frame_size> class BlePackets {
+ public:
+  static BlePackets &get() {
+    static BlePackets packets;
+    return packets;
+  }
+
+  void feed() {
+    for (auto &packet : this->packets_) {
+      this->protocol_.read_data(packet.data(), packet.size());
+    }
+  }
+
+ protected:
+  TionLtBleProtocol protocol_;
+  packets_t packets_;
+  size_t frames_{};
+
+  BlePackets() {
+    std::mt19937 rnd(0xB1E);
+    std::vector<uint8_t> data(frame_size);
+    for (auto &b : data) {
+      b = rnd();
+    }
+    this->protocol_.set_protocol_writer([this](const uint8_t *data, size_t size) {
+      this->packets_.emplace_back(data, data + size);
+      return true;
+    });
+    this->protocol_.write_frame(0x3231, data.data(), data.size());
+    this->protocol_.set_protocol_reader(
+        [this](const dentra::tion::tion_any_ble_frame_t &, size_t) { this->frames_++; });
+  }
+};
+
+template<size_t frame_size> void bench_reassembly(size_t iterations) {
+  auto &packets = BlePackets<frame_size>::get();
+  for (size_t i = 0; i < iterations; i++) {
+    packets.feed();
+  }
+}
+
+struct BleLtBenchReg {
+  BleLtBenchReg() {
+    // 4s state response and 4s TEST response
+    bench::register_bench("lt/ble_reassembly/35", bench_reassembly<35>);
+    bench::register_bench("lt/ble_reassembly/" + std::to_string(TionLtBleProtocol::FRAME_DATA_MAX_SIZE),
+                          bench_reassembly<TionLtBleProtocol::FRAME_DATA_MAX_SIZE>);
+  }
+} ble_lt_bench_reg;
+
+}  // namespace
@@ -0,0 +1,41 @@
+#include <cstdio>
+
+#include "../test_command_queue.h"
+
+#include "bench.h"
+
+namespace {
+
+// Result of the last flood is reported, index 0 is fifo only, 1 is with queue.
+FloodResult flood_result[2];
+bool flood_done[2];
+
+template<size_t queued> void bench_flood(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    flood_result[queued] = run_queue_flood(queued ? 250 : 0);
+    flood_done[queued] = true;
+  }
+}
+
+void report_flood() {
+  if (flood_done[0]) {
+    const auto &r = flood_result[0];
+    std::fprintf(stderr, "fifo only   : control latency %4u ms, link depth %2zu\n", r.control_latency, r.tx_max);
+  }
+  if (flood_done[1]) {
+    const auto &r = flood_result[1];
+    std::fprintf(stderr,
+                 "with queue  : control latency %4u ms, link depth %2zu, high water %zu, coalesced %u, dropped %u\n",
+                 r.control_latency, r.tx_max, r.high_water, r.coalesced, r.dropped);
+  }
+}
+
+struct CommandQueueBenchReg {
+  CommandQueueBenchReg() {
+    bench::register_bench("4s/flood_fifo", bench_flood<0>);
+    bench::register_bench("4s/flood_queue", bench_flood<1>);
+    bench::register_report(report_flood);
+  }
+} command_queue_bench_reg;
+
+}  // namespace
@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../components/tion/binary_sensor/tion_binary_sensor.h"
+#include "../../components/tion/sensor/tion_sensor.h"
+#include "../../components/tion/text_sensor/tion_text_sensor.h"
+
+#include "bench_models.h"
+#include "bench.h"
+
+namespace {
+
+namespace pc = esphome::tion::property_controller;
+using esphome::tion::TionBinarySensor;
+using esphome::tion::TionSensor;
+using esphome::tion::TionTextSensor;
+
+class FanoutComponent : public esphome::tion::TionApiComponent {
+ public:
+  explicit FanoutComponent(TionApiBase *api) : TionApiComponent(api) {}
+  void publish(dentra::tion::TionStateChangeMask changes = dentra::tion::TionState::ALL_FIELDS) {
+    this->publish_entities_(&this->state(), changes);
+    this->state_callback_.call(&this->state(), changes);
+  }
+};
+
+// Breezer component with 40 entities subscribed to its state.
+template<class M> class Fanout {
+ public:
+  explicit Fanout(bool force_update = true) : component_(&this->api_) {
+    this->state_.resize(dentra::tion::find_frame_handler(M::handlers(), M::state_type())->size);
+    // publish every time, otherwise unchanged entities are skipped
+    this->component_.set_force_update(force_update);
+
+    this->add_<TionSensor<pc::sensor::FanSpeed>>();
+    this->add_<TionSensor<pc::sensor::OutdoorTemperature>>();
+    this->add_<TionSensor<pc::sensor::CurrentTemperature>>();
+    this->add_<TionSensor<pc::sensor::TargetTemperature>>();
+    this->add_<TionSensor<pc::sensor::Productivity>>();
+    this->add_<TionSensor<pc::sensor::HeaterVar>>();
+    this->add_<TionSensor<pc::sensor::HeaterPower>>();
+    this->add_<TionSensor<pc::sensor::WorkTime>>();
+    this->add_<TionSensor<pc::sensor::WorkTimeDays>>();
+    this->add_<TionSensor<pc::sensor::FilterTimeLeft>>();
+    this->add_<TionSensor<pc::sensor::FilterTimeLeftDays>>();
+    this->add_<TionSensor<pc::sensor::FanTime>>();
+    this->add_<TionSensor<pc::sensor::FanTimeDays>>();
+    this->add_<TionSensor<pc::sensor::Airflow>>();
+    this->add_<TionSensor<pc::sensor::AirflowCounter>>();
+    this->add_<TionSensor<pc::sensor::PcbCtlTemperature>>();
+    this->add_<TionSensor<pc::sensor::PcbPwrTemperature>>();
+    this->add_<TionSensor<pc::sensor::BoostTimeLeft>>();
+    this->add_<TionSensor<pc::sensor::FanPower>>();
+    this->add_<TionSensor<pc::sensor::Power>>();
+
+    this->add_<TionBinarySensor<pc::binary_sensor::Power>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Heater>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Sound>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Led>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Auto>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Filter>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::GateError>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Gate>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Heating>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Error>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::Boost>>();
+    this->add_<TionBinarySensor<pc::binary_sensor::State>>();
+
+    this->add_<TionTextSensor<pc::text_sensor::Errors>>();
+    this->add_<TionTextSensor<pc::text_sensor::FirmwareVersion>>();
+    this->add_<TionTextSensor<pc::text_sensor::HardwareVersion>>();
+
+    // configs often have temperatures and fan speed twice, e.g. with different filters
+    this->add_<TionSensor<pc::sensor::FanSpeed>>();
+    this->add_<TionSensor<pc::sensor::OutdoorTemperature>>();
+    this->add_<TionSensor<pc::sensor::CurrentTemperature>>();
+    this->add_<TionSensor<pc::sensor::TargetTemperature>>();
+    this->add_<TionSensor<pc::sensor::Productivity>>();
+
+    this->poll();
+  }
+
+  void publish(dentra::tion::TionStateChangeMask changes = dentra::tion::TionState::ALL_FIELDS) {
+    this->component_.publish(changes);
+  }
+
+  /// Receives state response, the whole path from frame to the entities.
+  void poll() {
+    // the same probes as vports take on received data
+    TION_TRACE_RX(true);
+    TION_TRACE_FRAME();
+    this->api_.read_frame(M::state_type(), this->state_.data(), this->state_.size());
+  }
+
+  /// Raw state response.
+  std::vector<uint8_t> &state() { return this->state_; }
+
+  typename M::api_type &api() { return this->api_; }
+
+ protected:
+  typename M::api_type api_;
+  std::vector<uint8_t> state_;
+  FanoutComponent component_;
+  // shared_ptr<void> keeps the deleter of the entity type
+  std::vector<std::shared_ptr<void>> entities_;
+
+  template<class E> void add_() {
+    auto entity = std::make_shared<E>(&this->component_);
+    entity->setup();
+    this->entities_.push_back(entity);
+  }
+};
+
+template<class M> void bench_publish(size_t iterations) {
+  static Fanout<M> fanout;
+  for (size_t i = 0; i < iterations; i++) {
+    fanout.publish();
+  }
+}
+
+template<class M> void register_model() {
+  bench::register_bench(std::string(M::NAME) + "/publish_40", bench_publish<M>);
+}
+
+using Fanout4s = Fanout<bench::Model4s>;
+using State4s = dentra::tion_4s::tion4s_raw_frame_t<dentra::tion_4s::tion4s_state_t>;
+
+// Regular poll: the breezer responds with the same state.
+void bench_poll_unchanged(size_t iterations) {
+  static Fanout4s fanout(false);
+  for (size_t i = 0; i < iterations; i++) {
+    fanout.poll();
+  }
+}
+
+// Entities notification only, without frame parsing.
+void bench_notify_unchanged(size_t iterations) {
+  static Fanout4s fanout(false);
+  for (size_t i = 0; i < iterations; i++) {
+    fanout.publish(0);
+  }
+}
+
+// Poll where only outdoor temperature is changed.
+void bench_poll_one_field(size_t iterations) {
+  static Fanout4s fanout(false);
+  auto *state = reinterpret_cast<State4s *>(fanout.state().data());
+  for (size_t i = 0; i < iterations; i++) {
+    state->data.outdoor_temperature = i & 1;
+    fanout.poll();
+  }
+}
+
+#ifdef TION_ENABLE_TRACE
+template<class M> Fanout<M> &trace_fanout() {
+  static Fanout<M> fanout;
+  return fanout;
+}
+
+// Regular poll with latency trace by the host clock.
+template<class M> void bench_trace_poll(size_t iterations) {
+  auto &fanout = trace_fanout<M>();
+  esphome::test_set_real_micros(true);
+  for (size_t i = 0; i < iterations; i++) {
+    fanout.poll();
+  }
+  esphome::test_set_real_micros(false);
+}
+
+template<class M> void report_trace() {
+  const auto &trace = trace_fanout<M>().api().get_trace();
+  for (uint8_t stage = 0; stage < dentra::tion::TionTrace::STAGES; stage++) {
+    const auto st = dentra::tion::TionTrace::Stage(stage);
+    const auto &histogram = trace.get_histogram(st);
+    std::fprintf(stderr, "%s/trace %-31s p50 %6u us, p95 %6u us, max %6u us %10u samples\n", M::NAME,
+                 dentra::tion::TionTrace::get_stage_name(st), histogram.get_percentile(50),
+                 histogram.get_percentile(95), histogram.get_max(), histogram.get_count());
+  }
+}
+
+template<class M> void register_trace() {
+  bench::register_bench(std::string(M::NAME) + "/trace_poll_40", bench_trace_poll<M>);
+  bench::register_report(report_trace<M>);
+}
+#endif
+
+struct ComponentBenchReg {
+  ComponentBenchReg() {
+    register_model<bench::Model4s>();
+    register_model<bench::Model3s>();
+    register_model<bench::ModelLt>();
+    register_model<bench::ModelO2>();
+    bench::register_bench("4s/poll_40_unchanged", bench_poll_unchanged);
+    bench::register_bench("4s/notify_40_unchanged", bench_notify_unchanged);
+    bench::register_bench("4s/poll_40_one_field", bench_poll_one_field);
+#ifdef TION_ENABLE_TRACE
+    register_trace<bench::Model4s>();
+    register_trace<bench::Model3s>();
+    register_trace<bench::ModelLt>();
+    register_trace<bench::ModelO2>();
+#endif
+  }
+} component_bench_reg;
+
+}  // namespace
@@ -0,0 +1,61 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../components/tion-api/crc.h"
+
+#include "bench.h"
+
+namespace {
+
+using crc_fn_t = uint16_t (*)(uint16_t, const void *, size_t);
+
+// 4s TEST response, the largest frame
+constexpr size_t DATA_SIZE = 440;
+
+const std::vector<uint8_t> &random_data() {
+  static const std::vector<uint8_t> data = []() {
+    std::mt19937 rnd(0xC2C);
+    std::vector<uint8_t> data(DATA_SIZE);
+    for (auto &b : data) {
+      b = rnd();
+    }
+    return data;
+  }();
+  return data;
+}
+
+uint16_t crc16_update_bytes(uint16_t state, const void *data, size_t size) {
+  auto *data_ptr = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++) {
+    state = dentra::tion::crc16_update(state, data_ptr[i]);
+  }
+  return state;
+}
+
+template<crc_fn_t crc_fn, size_t size> void bench_crc(size_t iterations) {
+  const auto &data = random_data();
+  uint16_t crc = 0;
+  for (size_t i = 0; i < iterations; i++) {
+    // feed previous result to prevent the compiler from hoisting the call
+    crc ^= crc_fn(0xFFFF ^ crc, data.data(), size);
+    bench::do_not_optimize(crc);
+  }
+}
+
+template<crc_fn_t crc_fn> void register_crc(const std::string &name) {
+  // 4s state response frame and 4s TEST response
+  bench::register_bench("crc/" + name + "/42", bench_crc<crc_fn, 42>);
+  bench::register_bench("crc/" + name + "/440", bench_crc<crc_fn, DATA_SIZE>);
+}
+
+struct CrcBenchReg {
+  CrcBenchReg() {
+    register_crc<dentra::tion::crc16_ccitt_false_bytewise>("bytewise");
+    register_crc<dentra::tion::crc16_ccitt_false_slice8>("slice8");
+    register_crc<dentra::tion::crc16_ccitt_false>("default");
+    register_crc<crc16_update_bytes>("update");
+  }
+} crc_bench_reg;
+
+}  // namespace
@@ -0,0 +1,53 @@
+#include <cstdio>
+
+#include "../test_fast_boot.h"
+
+#include "bench.h"
+
+namespace {
+
+// Breezer is connected 8 s after boot, result of the last start is reported.
+constexpr uint32_t CONNECT_TIME = 8000;
+
+BootResult cold_result;
+BootResult fast_result;
+bool cold_done;
+bool fast_done;
+
+void bench_cold_start(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    cold_result = run_cold_start(CONNECT_TIME, false);
+    cold_done = true;
+  }
+}
+
+void bench_fast_boot(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    fast_result = run_cold_start(CONNECT_TIME, true);
+    fast_done = true;
+  }
+}
+
+void report_boot_result(const char *name, const BootResult &r) {
+  std::fprintf(stderr, "%-24s: first publish %5u ms, first received %5u ms, dev info requests %zu\n", name,
+               r.first_publish, r.first_received, r.dev_info_requests);
+}
+
+void report_boot() {
+  if (cold_done) {
+    report_boot_result("cold start", cold_result);
+  }
+  if (fast_done) {
+    report_boot_result("fast boot", fast_result);
+  }
+}
+
+struct FastBootBenchReg {
+  FastBootBenchReg() {
+    bench::register_bench("4s/boot_cold_start", bench_cold_start);
+    bench::register_bench("4s/boot_fast_boot", bench_fast_boot);
+    bench::register_report(report_boot);
+  }
+} fast_boot_bench_reg;
+
+}  // namespace
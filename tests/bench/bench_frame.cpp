@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../../components/tion-api/tion-api-3s-internal.h"
+#include "../../components/tion-api/tion-api-o2-internal.h"
+#include "../../components/tion-api/tion-api-ble-lt.h"
+#include "../../components/tion-api/tion-api-uart-3s.h"
+#include "../../components/tion-api/tion-api-uart-4s.h"
+#include "../../components/tion-api/tion-api-uart-o2.h"
+#include "../../components/tion/tion_vport.h"
+
+#include "bench_models.h"
+#include "bench.h"
+
+namespace {
+
+// Counts bytes copied on the way from api to the transport.
+struct CopyStat {
+  size_t frames;
+  size_t data_bytes;
+  size_t api_copied;
+  size_t protocol_copied;
+};
+
+// Passes frames from the api to the protocol like vport without command queue does.
+template<class protocol_t> class BenchVPort : public esphome::vport::VPort<typename protocol_t::frame_spec_type> {
+  using frame_spec_t = typename protocol_t::frame_spec_type;
+
+ public:
+  const uint8_t *api_tx_data{};
+  CopyStat stat{};
+
+  BenchVPort() {
+    this->protocol_.set_protocol_writer([](const uint8_t *data, size_t size) {
+      bench::do_not_optimize(data);
+      return true;
+    });
+  }
+
+  void write(const frame_spec_t &frame, size_t size) override {
+    const size_t data_size = size - frame_spec_t::head_size();
+    this->stat.frames++;
+    this->stat.data_bytes += data_size;
+    if (reinterpret_cast<const uint8_t *>(frame.data) != this->api_tx_data) {
+      this->stat.api_copied += data_size;
+    }
+    // every protocol frames data in its own buffer
+    this->stat.protocol_copied += data_size;
+    this->protocol_.write_frame(frame.type, frame.data, data_size);
+  }
+
+ protected:
+  protocol_t protocol_;
+};
+
+// Api of the model with initialized state writing to the protocol.
+template<class M, class protocol_t>
+class BenchVPortApi : public esphome::tion::TionVPortApi<typename protocol_t::frame_spec_type, typename M::api_type> {
+ public:
+  static BenchVPortApi &get() {
+    static BenchVPort<protocol_t> vport;
+    static BenchVPortApi api(&vport);
+    return api;
+  }
+
+  const CopyStat &stat() const { return this->bench_vport_->stat; }
+
+ protected:
+  BenchVPort<protocol_t> *bench_vport_;
+
+  explicit BenchVPortApi(BenchVPort<protocol_t> *vport)
+      : esphome::tion::TionVPortApi<typename protocol_t::frame_spec_type, typename M::api_type>(vport),
+        bench_vport_(vport) {
+    vport->api_tx_data = this->tx_frame_.data();
+    std::vector<uint8_t> state(dentra::tion::find_frame_handler(M::handlers(), M::state_type())->size);
+    this->read_frame(M::state_type(), state.data(), state.size());
+  }
+};
+
+template<class M, class protocol_t> void bench_write_state(size_t iterations) {
+  auto &api = BenchVPortApi<M, protocol_t>::get();
+  dentra::tion::TionStateCall call(&api);
+  call.set_fan_speed(2);
+  call.set_power_state(true);
+  for (size_t i = 0; i < iterations; i++) {
+    api.write_state(&call);
+  }
+}
+
+template<class M, class protocol_t> std::string &bench_name() {
+  static std::string name;
+  return name;
+}
+
+// Bytes copied before frame builder: VLA memset with head and payload, then payload memcpy.
+template<class M, class protocol_t> void report_copied() {
+  const auto &stat = BenchVPortApi<M, protocol_t>::get().stat();
+  if (stat.frames == 0) {
+    return;
+  }
+  const size_t head_size = protocol_t::frame_spec_type::head_size();
+  const size_t before = stat.frames * head_size + stat.data_bytes * 2 + stat.protocol_copied;
+  const size_t after = stat.api_copied + stat.protocol_copied;
+  std::fprintf(stderr, "%-40s copied %zu bytes per frame, %zu bytes before frame builder\n",
+               bench_name<M, protocol_t>().c_str(), after / stat.frames, before / stat.frames);
+}
+
+template<class M, class protocol_t> void register_write_state(const char *transport) {
+  auto &name = bench_name<M, protocol_t>();
+  name = std::string(M::NAME) + "/write_state_" + transport;
+  bench::register_bench(name, bench_write_state<M, protocol_t>);
+  bench::register_report(report_copied<M, protocol_t>);
+}
+
+struct FrameBenchReg {
+  FrameBenchReg() {
+    register_write_state<bench::Model4s, dentra::tion::Tion4sUartProtocol>("uart");
+    register_write_state<bench::Model4s, dentra::tion::TionLtBleProtocol>("ble");
+    register_write_state<bench::Model3s, dentra::tion::Tion3sUartProtocol>("uart");
+    register_write_state<bench::ModelLt, dentra::tion::TionLtBleProtocol>("ble");
+    register_write_state<bench::ModelO2, dentra::tion_o2::TionO2UartProtocol>("uart");
+  }
+} frame_bench_reg;
+
+}  // namespace
@@ -0,0 +1,53 @@
+#include <cstdio>
+
+#include "../test_keepalive.h"
+
+#include "bench.h"
+
+namespace {
+
+struct StallCase {
+  const char *name;
+  uint32_t interval;
+  bool task;
+};
+
+const StallCase STALL_CASES[] = {
+    {"work_mode_loop", 200, false},
+    {"work_mode_task", 200, true},
+    {"heartbeat_loop", 5000, false},
+    {"heartbeat_task", 5000, true},
+};
+
+// A minute of keepalive per iteration, result of the last one is reported.
+StallResult stall_result[4];
+
+template<size_t index> void bench_stalls(size_t iterations) {
+  const auto &c = STALL_CASES[index];
+  for (size_t i = 0; i < iterations; i++) {
+    stall_result[index] = run_keepalive_stalls(c.interval, c.task, c.task);
+  }
+}
+
+void report_stalls() {
+  for (size_t i = 0; i < 4; i++) {
+    const auto &r = stall_result[i];
+    if (r.frames == 0) {
+      continue;
+    }
+    std::fprintf(stderr, "keepalive %-14s: frames %4u, p50 %4u ms, p99 %4u ms, max %4u ms\n", STALL_CASES[i].name,
+                 r.frames, r.p50, r.p99, r.max);
+  }
+}
+
+struct KeepaliveBenchReg {
+  KeepaliveBenchReg() {
+    bench::register_bench("keepalive/work_mode_loop", bench_stalls<0>);
+    bench::register_bench("keepalive/work_mode_task", bench_stalls<1>);
+    bench::register_bench("keepalive/heartbeat_loop", bench_stalls<2>);
+    bench::register_bench("keepalive/heartbeat_task", bench_stalls<3>);
+    bench::register_report(report_stalls);
+  }
+} keepalive_bench_reg;
+
+}  // namespace
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../../components/tion-api/tion-api-3s-internal.h"
+#include "../../components/tion-api/tion-api-3s.h"
+#include "../../components/tion-api/tion-api-4s-internal.h"
+#include "../../components/tion-api/tion-api-4s.h"
+#include "../../components/tion-api/tion-api-lt-internal.h"
+#include "../../components/tion-api/tion-api-lt.h"
+#include "../../components/tion-api/tion-api-o2-internal.h"
+#include "../../components/tion-api/tion-api-o2.h"
+
+namespace bench {
+
+// Benchmarked breezer models: api, its frame handlers and state response type.
+
+struct Model4s {
+  using api_type = dentra::tion_4s::Tion4sApi;
+  static constexpr const char *NAME = "4s";
+  static uint16_t state_type() { return dentra::tion_4s::FRAME_TYPE_STATE_RSP; }
+  static const auto &handlers() { return dentra::tion_4s::tion4s_frame_handlers_t<api_type>::HANDLERS; }
+};
+
+struct Model3s {
+  using api_type = dentra::tion::Tion3sApi;
+  static constexpr const char *NAME = "3s";
+  static uint16_t state_type() { return api_type().get_state_type(); }
+  static const auto &handlers() { return dentra::tion_3s::tion3s_frame_handlers_t<api_type>::HANDLERS; }
+};
+
+struct ModelLt {
+  using api_type = dentra::tion::TionLtApi;
+  static constexpr const char *NAME = "lt";
+  static uint16_t state_type() { return dentra::tion_lt::FRAME_TYPE_STATE_RSP; }
+  static const auto &handlers() { return dentra::tion_lt::tionlt_frame_handlers_t<api_type>::HANDLERS; }
+};
+
+struct ModelO2 {
+  using api_type = dentra::tion_o2::TionO2Api;
+  static constexpr const char *NAME = "o2";
+  static uint16_t state_type() { return dentra::tion_o2::FRAME_TYPE_STATE_GET_RSP; }
+  static const auto &handlers() { return dentra::tion_o2::tiono2_frame_handlers_t<api_type>::HANDLERS; }
+};
+
+}  // namespace bench
@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <string>
+
+#include "../test_poll.h"
+
+#include "bench.h"
+
+namespace {
+
+constexpr uint32_t MINUTE = 60 * 1000;
+
+struct PollScenario {
+  const char *name;
+  uint32_t events_period;
+};
+
+struct PollMode {
+  const char *name;
+  uint32_t update_interval;
+};
+
+const PollScenario POLL_SCENARIOS[] = {{"idle", 0}, {"active", 15 * MINUTE}};
+const PollMode POLL_MODES[] = {{"fixed_60s", 60000}, {"fixed_1s", 1000}, {"adaptive", 0}};
+
+// An hour of polling per iteration, result of the last one is reported.
+template<size_t scenario, size_t mode> PollResult &poll_result() {
+  static PollResult result{};
+  return result;
+}
+
+template<size_t scenario, size_t mode> void bench_poll_hour(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    poll_result<scenario, mode>() =
+        run_poll_hour(POLL_MODES[mode].update_interval, POLL_SCENARIOS[scenario].events_period);
+  }
+}
+
+template<size_t scenario, size_t mode> void report_poll_hour() {
+  const auto &r = poll_result<scenario, mode>();
+  if (r.requests == 0) {
+    return;
+  }
+  std::fprintf(stderr, "4s/poll_hour %-6s %-9s %4zu requests/hour, confirmed in %5u ms, remote change in %6u ms\n",
+               POLL_SCENARIOS[scenario].name, POLL_MODES[mode].name, r.requests, r.latency_avg, r.remote_latency_avg);
+}
+
+template<size_t scenario, size_t mode> void register_poll_hour() {
+  bench::register_bench(std::string("4s/poll_hour_") + POLL_SCENARIOS[scenario].name + "_" + POLL_MODES[mode].name,
+                        bench_poll_hour<scenario, mode>);
+  bench::register_report(report_poll_hour<scenario, mode>);
+}
+
+template<size_t scenario> void register_poll_scenario() {
+  register_poll_hour<scenario, 0>();
+  register_poll_hour<scenario, 1>();
+  register_poll_hour<scenario, 2>();
+}
+
+struct PollBenchReg {
+  PollBenchReg() {
+    register_poll_scenario<0>();
+    register_poll_scenario<1>();
+  }
+} poll_bench_reg;
+
+}  // namespace
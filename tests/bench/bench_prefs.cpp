@@ -0,0 +1,42 @@
+#include <cstdio>
+
+#include "../test_prefs.h"
+
+#include "bench.h"
+
+namespace {
+
+// A week in auto mode per iteration, flash writes of the last one are reported.
+uint32_t on_change_writes;
+uint32_t write_behind_writes;
+
+void bench_on_change(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    on_change_writes = run_prefs_week(0);
+  }
+}
+
+void bench_write_behind(size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    write_behind_writes = run_prefs_week(10 * PREFS_MINUTE);
+  }
+}
+
+void report_prefs() {
+  if (on_change_writes != 0) {
+    std::fprintf(stderr, "week in auto mode, write on change  : %5u flash writes\n", on_change_writes);
+  }
+  if (write_behind_writes != 0) {
+    std::fprintf(stderr, "week in auto mode, write behind 10m : %5u flash writes\n", write_behind_writes);
+  }
+}
+
+struct PrefsBenchReg {
+  PrefsBenchReg() {
+    bench::register_bench("4s/prefs_week_on_change", bench_on_change);
+    bench::register_bench("4s/prefs_week_write_behind", bench_write_behind);
+    bench::register_report(report_prefs);
+  }
+} prefs_bench_reg;
+
+}  // namespace
@@ -0,0 +1,145 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../components/tion-api/tion-api-3s-internal.h"
+#include "../../components/tion-api/tion-api-o2-internal.h"
+#include "../../components/tion-api/tion-api-uart-3s.h"
+#include "../../components/tion-api/tion-api-uart-4s.h"
+#include "../../components/tion-api/tion-api-uart-o2.h"
+
+#include "bench.h"
+
+namespace {
+
+using bursts_t = std::vector<std::vector<uint8_t>>;
+
+// Reads data in chunks like hardware uart fifo does.
+class ChunkUartReader : public dentra::tion::TionUartReader {
+ public:
+  explicit ChunkUartReader(const std::vector<uint8_t> &data) : data_(data) {}
+  int available() override {
+    const size_t left = this->data_.size() - this->pos_;
+    return left < CHUNK_SIZE ? left : CHUNK_SIZE;
+  }
+  bool read_array(void *data, size_t size) override {
+    if (this->pos_ + size > this->data_.size()) {
+      return false;
+    }
+    std::memcpy(data, this->data_.data() + this->pos_, size);
+    this->pos_ += size;
+    return true;
+  }
+  bool empty() const { return this->pos_ == this->data_.size(); }
+
+ protected:
+  enum { CHUNK_SIZE = 64 };
+  const std::vector<uint8_t> &data_;
+  size_t pos_{};
+};
+
+// Generates frame with random payload using protocol writer.
+template<class protocol_t>
+std::vector<uint8_t> make_frame(protocol_t &protocol, std::mt19937 &rnd, uint16_t type, size_t size) {
+  std::vector<uint8_t> payload(size);
+  for (auto &b : payload) {
+    b = rnd();
+  }
+  std::vector<uint8_t> frame;
+  protocol.set_protocol_writer([&frame](const uint8_t *data, size_t size) {
+    frame.assign(data, data + size);
+    return true;
+  });
+  protocol.write_frame(type, payload.data(), payload.size());
+  return frame;
+}
+
+struct Resync4s {
+  using protocol_type = dentra::tion::Tion4sUartProtocol;
+  static constexpr const char *NAME = "4s";
+  static std::vector<uint8_t> make(protocol_type &protocol, std::mt19937 &rnd) {
+    return make_frame(protocol, rnd, 0x3231, rnd() % 30);
+  }
+};
+
+struct Resync3s {
+  using protocol_type = dentra::tion::Tion3sUartProtocol;
+  static constexpr const char *NAME = "3s";
+  static std::vector<uint8_t> make(protocol_type &protocol, std::mt19937 &rnd) {
+    return make_frame(protocol, rnd, FRAME_TYPE(dentra::tion_3s::FRAME_MAGIC_RSP, 0x10), 17);
+  }
+};
+
+struct ResyncO2 {
+  using protocol_type = dentra::tion_o2::TionO2UartProtocol;
+  static constexpr const char *NAME = "o2";
+  static std::vector<uint8_t> make(protocol_type &protocol, std::mt19937 &rnd) {
+    static const uint8_t types[] = {dentra::tion_o2::FRAME_TYPE_STATE_GET_RSP, dentra::tion_o2::FRAME_TYPE_CONNECT_RSP,
+                                    dentra::tion_o2::FRAME_TYPE_DEV_MODE_RSP};
+    const uint8_t type = types[rnd() % sizeof(types)];
+    return make_frame(protocol, rnd, type, dentra::tion_o2::get_rsp_frame_size(type) - 1);
+  }
+};
+
+// Protocol fed with bursts of random noise, each followed by a valid frame.
+template<class M> class NoisyLink {
+ public:
+  enum { BURSTS = 1024 };
+
+  static NoisyLink &get() {
+    static NoisyLink link;
+    return link;
+  }
+
+  // Feeds the next burst, one operation is a time-to-resync.
+  void feed() {
+    ChunkUartReader io(this->bursts_[this->next_]);
+    this->next_ = (this->next_ + 1) % this->bursts_.size();
+    while (!io.empty()) {
+      this->protocol_.read_uart_data(&io);
+    }
+  }
+
+ protected:
+  typename M::protocol_type protocol_;
+  bursts_t bursts_;
+  size_t next_{};
+  size_t frames_{};
+
+  NoisyLink() {
+    std::mt19937 rnd(0x7107);
+    std::uniform_int_distribution<size_t> burst_dist(1, 64);
+    for (size_t i = 0; i < BURSTS; i++) {
+      std::vector<uint8_t> data(burst_dist(rnd));
+      for (auto &b : data) {
+        b = rnd();
+      }
+      const auto frame = M::make(this->protocol_, rnd);
+      data.insert(data.end(), frame.begin(), frame.end());
+      this->bursts_.push_back(std::move(data));
+    }
+    this->protocol_.set_protocol_reader([this](const dentra::tion::tion_any_frame_t &, size_t) { this->frames_++; });
+  }
+};
+
+template<class M> void bench_resync(size_t iterations) {
+  auto &link = NoisyLink<M>::get();
+  for (size_t i = 0; i < iterations; i++) {
+    link.feed();
+  }
+}
+
+template<class M> void register_resync() {
+  bench::register_bench(std::string(M::NAME) + "/uart_resync", bench_resync<M>);
+}
+
+struct ResyncBenchReg {
+  ResyncBenchReg() {
+    register_resync<Resync4s>();
+    register_resync<Resync3s>();
+    register_resync<ResyncO2>();
+  }
+} resync_bench_reg;
+
+}  // namespace
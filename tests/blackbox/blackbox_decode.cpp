@@ -0,0 +1,128 @@
+// Decodes black box dump from the log, see TionBlackBox::dump.
+// Usage: blackbox_decode [log-file], reads stdin without arguments.
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../../components/tion-api/tion-api-blackbox.h"
+#include "../../components/tion-api/tion-api-3s.h"
+#include "../../components/tion-api/tion-api-4s.h"
+#include "../../components/tion-api/tion-api-lt.h"
+#include "../../components/tion-api/tion-api-o2.h"
+
+using dentra::tion::TionBlackBoxRecord;
+using dentra::tion::TionState;
+
+namespace {
+
+const char *get_vport_name(uint8_t vport) {
+  // esphome::tion::TionVPortType
+  static const char *const NAMES[] = {"unknown", "ble", "uart", "jtag", "tcp"};
+  return vport < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[vport] : NAMES[0];
+}
+
+void print_state(const TionState &state) {
+  std::printf("    state: power %s, fan %u, heater %s, target %d, outdoor %d, current %d, gate %u, errors %08" PRIX32
+              "\n",
+              state.power_state ? "on" : "off", state.fan_speed, state.heater_state ? "on" : "off",
+              state.target_temperature, state.outdoor_temperature, state.current_temperature,
+              static_cast<uint8_t>(state.gate_position), state.errors);
+}
+
+// Api of the model, decoded states are printed.
+template<class api_t> class Decoder {
+ public:
+  Decoder() {
+    this->api_.set_api_writer([](uint16_t, const void *, size_t) { return true; });
+    this->api_.set_on_state([](const TionState &state, uint32_t, dentra::tion::TionStateChangeMask) {
+      print_state(state);
+    });
+  }
+
+  void decode(uint16_t type, const uint8_t *data, size_t size) {
+    if (!this->api_.read_frame(type, data, size)) {
+      std::printf("    not decoded\n");
+    }
+  }
+
+ protected:
+  api_t api_;
+};
+
+void decode(const TionBlackBoxRecord &record, const uint8_t *data) {
+  // requests are not decoded, their data is printed only
+  if (record.is_tx()) {
+    return;
+  }
+  switch (record.get_model()) {
+    case TionBlackBoxRecord::MODEL_3S: {
+      static Decoder<dentra::tion::Tion3sApi> decoder;
+      decoder.decode(record.type, data, record.size);
+      break;
+    }
+    case TionBlackBoxRecord::MODEL_4S: {
+      static Decoder<dentra::tion_4s::Tion4sApi> decoder;
+      decoder.decode(record.type, data, record.size);
+      break;
+    }
+    case TionBlackBoxRecord::MODEL_LT: {
+      static Decoder<dentra::tion::TionLtApi> decoder;
+      decoder.decode(record.type, data, record.size);
+      break;
+    }
+    case TionBlackBoxRecord::MODEL_O2: {
+      static Decoder<dentra::tion_o2::TionO2Api> decoder;
+      decoder.decode(record.type, data, record.size);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+int decode_stream(std::istream &in) {
+  std::string line;
+  uint32_t records = 0;
+  uint32_t start = 0;
+  while (std::getline(in, line)) {
+    if (line.find("Black box:") != std::string::npos) {
+      std::printf("%s\n", line.c_str());
+      records = 0;
+      continue;
+    }
+    TionBlackBoxRecord record;
+    uint8_t data[TionBlackBoxRecord::DATA_MAX_SIZE];
+    if (!TionBlackBoxRecord::parse(line.c_str(), &record, data)) {
+      continue;
+    }
+    if (records++ == 0) {
+      start = record.time;
+    }
+    std::printf("%10.3f %s %-4s %-2s 0x%04X [%2u]:", (record.time - start) * 0.001f, record.is_tx() ? "TX" : "RX",
+                get_vport_name(record.get_vport()), TionBlackBoxRecord::get_model_name(record.get_model()),
+                record.type, record.size);
+    for (size_t i = 0; i < record.size; i++) {
+      std::printf(" %02X", data[i]);
+    }
+    std::printf("\n");
+    decode(record, data);
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char const *argv[]) {
+  if (argc < 2) {
+    return decode_stream(std::cin);
+  }
+  std::ifstream in(argv[1]);
+  if (!in) {
+    std::fprintf(stderr, "Can't open %s\n", argv[1]);
+    return 1;
+  }
+  return decode_stream(in);
+}
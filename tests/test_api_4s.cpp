@@ -1,12 +1,18 @@
+#include <algorithm>
+
 #include "esphome/components/climate/climate_mode.h"
 
+#include "../components/tion-api/crc.h"
 #include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-uart-4s.h"
 #include "../components/tion_4s_uart/tion_4s_uart_vport.h"
 #include "../components/tion/climate/tion_climate.h"
 #include "../components/tion/tion_component.h"
 
 #include "test_api.h"
 #include "test_vport.h"
+#include "test_hw.h"
+#include "string_uart.h"
 
 DEFINE_TAG;
 
@@ -30,6 +36,8 @@ class Tion4sBleVPortApiTest : public esphome::tion::TionVPortApi<Tion4sBleIOTest
   Tion4sBleVPortApiTest(vport_t *vport)
       : esphome::tion::TionVPortApi<Tion4sBleIOTest::frame_spec_type, Tion4sApi>(vport) {
     this->state_.firmware_version = 0xFFFF;
+    // device info is known, so it is not requested with the state
+    this->planner_.complete(REQUEST_DEV_INFO);
     this->state_.fan_speed = 1;
     this->state_.work_time = 0xFFFF;
   }
@@ -43,6 +51,8 @@ class Tion4sUartVPortApiTest : public Tion4sUartVPortApiTestBase {
         Tion4sApi::writer_type::create<Tion4sUartVPortApiTest, &Tion4sUartVPortApiTest::test_write_>(*this));
     // this->traits_.max_fan_speed = 6;
     this->state_.firmware_version = 0xFFFF;
+    // device info is known, so it is not requested with the state
+    this->planner_.complete(REQUEST_DEV_INFO);
     this->state_.fan_speed = 1;
     this->state_.work_time = 0xFFFF;
   }
@@ -320,6 +330,8 @@ bool test_batch() {
   vport.call_loop();
 
   capi.test_timeout(false);
+  // batch is written out from loop after timeout
+  esphome::test_set_millis(esphome::millis() + 3000);
   capi.call_loop();
   vport.call_loop();
 
@@ -376,3 +388,157 @@ REGISTER_TEST(test_presets);
 REGISTER_TEST(test_heat_cool);
 REGISTER_TEST(test_preset_update);
 REGISTER_TEST(test_batch);
+
+class StringUartReader : public dentra::tion::TionUartReader, public cloak::internal::StringUart {
+ public:
+  explicit StringUartReader(const std::vector<uint8_t> &data) : cloak::internal::StringUart(data.data(), data.size()) {}
+  int available() override { return cloak::internal::StringUart::available(); }
+  bool read_array(void *data, size_t size) override {
+    this->read_calls++;
+    return cloak::internal::StringUart::read_array(data, size);
+  }
+  size_t read_calls{};
+};
+
+// Byte by byte state machine reader as it was before bulk reading, used as a reference.
+class Tion4sUartLegacyProtocol : public dentra::tion::TionUartProtocolBase<0x2A> {
+ public:
+  void read_uart_data(dentra::tion::TionUartReader *io) {
+    while (io->available() > 0) {
+      if (this->read_frame_(io) == READ_NEXT_LOOP) {
+        break;
+      }
+    }
+  }
+
+ protected:
+  struct RawFrame {
+    enum { FRAME_MAGIC = 0x3A };
+    uint8_t magic;
+    uint16_t size;
+    dentra::tion::tion_frame_t<uint8_t[sizeof(uint16_t)]> data;
+  } PACKED;
+
+  read_frame_result_t read_frame_(dentra::tion::TionUartReader *io) {
+    auto *frame = reinterpret_cast<RawFrame *>(this->buf_);
+    if (frame->magic != RawFrame::FRAME_MAGIC) {
+      if (io->available() < sizeof(frame->magic)) {
+        return READ_NEXT_LOOP;
+      }
+      if (!io->read_array(&frame->magic, sizeof(frame->magic)) || frame->magic != RawFrame::FRAME_MAGIC) {
+        return READ_THIS_LOOP;
+      }
+    }
+    if (frame->size == 0) {
+      if (io->available() < sizeof(frame->size)) {
+        return READ_NEXT_LOOP;
+      }
+      if (!io->read_array(&frame->size, sizeof(frame->size))) {
+        this->reset_buf_();
+        return READ_THIS_LOOP;
+      }
+    }
+    if (frame->size < sizeof(RawFrame) || frame->size > FRAME_MAX_SIZE) {
+      this->reset_buf_();
+      return READ_THIS_LOOP;
+    }
+    auto tail_size = frame->size - sizeof(frame->size) - sizeof(frame->magic);
+    if (io->available() < tail_size) {
+      return READ_NEXT_LOOP;
+    }
+    if (!io->read_array(&frame->data.type, tail_size)) {
+      this->reset_buf_();
+      return READ_THIS_LOOP;
+    }
+    if (dentra::tion::crc16_ccitt_false_ffff(frame, frame->size) != 0) {
+      this->reset_buf_();
+      return READ_NEXT_LOOP;
+    }
+    auto frame_data_size = frame->size - sizeof(RawFrame) + sizeof(dentra::tion::tion_any_frame_t);
+    this->reader_(*reinterpret_cast<const dentra::tion::tion_any_frame_t *>(&frame->data), frame_data_size);
+    this->reset_buf_();
+    return READ_NEXT_LOOP;
+  }
+};
+
+using frames_t = std::vector<std::vector<uint8_t>>;
+
+template<class protocol_t> frames_t read_4s_frames(const std::vector<uint8_t> &data, size_t *read_calls) {
+  frames_t frames;
+  protocol_t protocol;
+  protocol.set_protocol_reader([&frames](const dentra::tion::tion_any_frame_t &frame, size_t size) {
+    auto *frame8 = reinterpret_cast<const uint8_t *>(&frame);
+    frames.emplace_back(frame8, frame8 + size);
+  });
+  StringUartReader io(data);
+  // each available() call "receives" one more byte, so data is read in chunks of growing size
+  for (size_t i = 0; i < data.size() * 2 && io.available_() > 0; i++) {
+    protocol.read_uart_data(&io);
+  }
+  *read_calls = io.read_calls;
+  return frames;
+}
+
+// checks that all frames of sub are found in frames in the same order.
+bool has_all_frames(const frames_t &frames, const frames_t &sub) {
+  auto it = frames.begin();
+  for (auto &frame : sub) {
+    it = std::find(it, frames.end(), frame);
+    if (it == frames.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool test_uart_4s_reader() {
+  bool res = true;
+
+  std::vector<std::string> inputs;
+  for (auto &td : test_data) {
+    inputs.push_back(td.data);
+  }
+  // noise, truncated and corrupted frames
+  inputs.push_back("FF 3A FF 00 3A 0800 3139 00 E82B 3A 0800 3139 01 E82B 3A 0800 3139 00 E82B");
+  inputs.push_back("3A 0100 3A 0800 3139 00 E82B");
+  inputs.push_back(test_data_long);
+
+  std::vector<uint8_t> all;
+  size_t legacy_calls{}, bulk_calls{};
+  for (auto &input : inputs) {
+    auto data = cloak::from_hex(input);
+    all.insert(all.end(), data.begin(), data.end());
+    size_t legacy_calls_, bulk_calls_;
+    auto legacy = read_4s_frames<Tion4sUartLegacyProtocol>(data, &legacy_calls_);
+    auto bulk = read_4s_frames<dentra::tion::Tion4sUartProtocol>(data, &bulk_calls_);
+    res &= cloak::check_data(input.substr(0, 16), bulk.size() == legacy.size() && bulk == legacy, true);
+    legacy_calls += legacy_calls_;
+    bulk_calls += bulk_calls_;
+  }
+
+  // test_data_long2 contains truncated frame followed by valid ones,
+  // legacy reader drops them all while bulk reader resyncs to the next header.
+  auto data2 = cloak::from_hex(test_data_long2);
+  all.insert(all.end(), data2.begin(), data2.end());
+  size_t legacy_calls_, bulk_calls_;
+  auto legacy2 = read_4s_frames<Tion4sUartLegacyProtocol>(data2, &legacy_calls_);
+  auto bulk2 = read_4s_frames<dentra::tion::Tion4sUartProtocol>(data2, &bulk_calls_);
+  res &= cloak::check_data("long2 legacy frames", has_all_frames(bulk2, legacy2), true);
+  res &= cloak::check_data("long2 recovered frames", bulk2.size() > legacy2.size(), true);
+  legacy_calls += legacy_calls_;
+  bulk_calls += bulk_calls_;
+
+  auto legacy = read_4s_frames<Tion4sUartLegacyProtocol>(all, &legacy_calls_);
+  auto bulk = read_4s_frames<dentra::tion::Tion4sUartProtocol>(all, &bulk_calls_);
+  res &= cloak::check_data("all legacy frames", has_all_frames(bulk, legacy), true);
+  legacy_calls += legacy_calls_;
+  bulk_calls += bulk_calls_;
+
+  ESP_LOGI(TAG, "frames: legacy=%zu, bulk=%zu", legacy.size(), bulk.size());
+  ESP_LOGI(TAG, "read_array calls: legacy=%zu, bulk=%zu", legacy_calls, bulk_calls);
+  res &= cloak::check_data("less read_array calls", bulk_calls < legacy_calls, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_uart_4s_reader);
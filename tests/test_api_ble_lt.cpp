@@ -0,0 +1,275 @@
+#include <cstring>
+#include <vector>
+
+#include "../components/tion-api/crc.h"
+#include "../components/tion-api/log.h"
+#include "../components/tion-api/utils.h"
+#include "../components/tion-api/tion-api-ble-lt.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using dentra::tion::tion_any_ble_frame_t;
+using dentra::tion::TionLtBleProtocol;
+using packets_t = std::vector<std::vector<uint8_t>>;
+
+namespace {
+
+struct ReceivedFrame {
+  uint16_t type;
+  std::vector<uint8_t> data;
+};
+
+// Protocol with packets writer and frames reader attached.
+class TestBleProtocol : public TionLtBleProtocol {
+ public:
+  std::vector<ReceivedFrame> frames;
+  packets_t packets;
+
+  TestBleProtocol() {
+    this->set_protocol_reader([this](const tion_any_ble_frame_t &frame, size_t size) {
+      this->frames.push_back({frame.type, {frame.data, frame.data + size - frame.head_size()}});
+    });
+    this->set_protocol_writer([this](const uint8_t *data, size_t size) {
+      this->packets.emplace_back(data, data + size);
+      return true;
+    });
+  }
+
+  packets_t make_packets(uint16_t type, size_t size) {
+    std::vector<uint8_t> data(size);
+    for (auto &b : data) {
+      b = fast_random_8();
+    }
+    this->packets.clear();
+    this->write_frame(type, data.data(), data.size());
+    return this->packets;
+  }
+
+  bool feed(const std::vector<uint8_t> &packet) { return this->read_data(packet.data(), packet.size()); }
+  void feed(const packets_t &packets) {
+    for (auto &packet : packets) {
+      this->feed(packet);
+    }
+  }
+};
+
+bool check_frame(const std::string &name, const TestBleProtocol &pr, uint16_t type, size_t size) {
+  bool res = true;
+  res &= cloak::check_data(name + " frames", pr.frames.size(), 1);
+  if (pr.frames.size() == 1) {
+    res &= cloak::check_data(name + " type", pr.frames[0].type, type);
+    res &= cloak::check_data(name + " size", uint32_t(pr.frames[0].data.size()), uint32_t(size));
+  }
+  return res;
+}
+
+// Reassembly as it was before fixed buffer: vector grows on every packet and released after frame.
+class VectorBleProtocol : public dentra::tion::TionProtocol<tion_any_ble_frame_t> {
+ public:
+  bool read_data(const uint8_t *data, size_t size) {
+    TION_LOGV(TAG, "Read packet: %s", dentra::tion::hex_cstr(data, size));
+    const uint8_t type = data[0];
+    auto *pkt_data = data + 1;
+    auto data_size = size - 1;
+    if (type == 0x80) {
+      TION_LOGV(TAG, "Packet LONE");
+      this->read_frame_(pkt_data, data_size);
+      return true;
+    }
+    if (type == 0x00) {
+      TION_LOGV(TAG, "Packet FRST");
+      this->rx_buf_.clear();
+      this->rx_buf_.insert(this->rx_buf_.end(), pkt_data, pkt_data + data_size);
+      return true;
+    }
+    if (type == 0x40) {
+      TION_LOGV(TAG, "Packet CURR");
+      this->rx_buf_.insert(this->rx_buf_.end(), pkt_data, pkt_data + data_size);
+      return true;
+    }
+    if (type == 0xC0) {
+      TION_LOGV(TAG, "Packet LAST");
+      this->rx_buf_.insert(this->rx_buf_.end(), pkt_data, pkt_data + data_size);
+      this->read_frame_(this->rx_buf_.data(), this->rx_buf_.size());
+      this->rx_buf_.clear();
+      this->rx_buf_.shrink_to_fit();
+      return true;
+    }
+    return false;
+  }
+
+ protected:
+  std::vector<uint8_t> rx_buf_;
+  void read_frame_(const uint8_t *data, size_t size) {
+    TION_LOGV(TAG, "Read frame: %s", dentra::tion::hex_cstr(data, size));
+    // size, magic and random before the frame
+    const size_t head = sizeof(uint16_t) + sizeof(uint8_t) * 2;
+    if (size > head + sizeof(uint16_t) && dentra::tion::crc16_ccitt_false_ffff(data, size) == 0) {
+      this->reader_(*reinterpret_cast<const tion_any_ble_frame_t *>(data + head), size - head - sizeof(uint16_t));
+    }
+  }
+};
+
+struct ReassemblyResult {
+  double allocs_per_frame;
+  size_t frames;
+};
+
+// Reassembly speed is measured by lt/ble_reassembly benchmarks.
+template<class reassembly_t> ReassemblyResult count_allocs(reassembly_t &&read_data, const packets_t &packets) {
+  const size_t repeats = 100;
+  cloak::AllocCounter counter;
+  for (size_t i = 0; i < repeats; i++) {
+    for (auto &packet : packets) {
+      read_data(packet.data(), packet.size());
+    }
+  }
+  return {double(counter.count()) / repeats, repeats};
+}
+
+}  // namespace
+
+bool test_api_ble_lt() {
+  bool res = true;
+
+  // real 4s state response
+  {
+    TestBleProtocol pr;
+    pr.feed(packets_t{
+        cloak::from_hex("00.2F.00.3A.D1.31.32.01.00.00.00.00.00.00.00.3C.51.00.10.01"),
+        cloak::from_hex("40.0C.17.12.1E.71.EF.29.00.D8.16.1F.00.28.37.CE.00.FE.56.43"),
+        cloak::from_hex("C0.00.00.00.00.00.06.00.63.1A"),
+    });
+    res &= check_frame("4s state", pr, 0x3231, 35);
+  }
+
+  // fragmented frames of any size up to the largest one
+  for (size_t size : {0, 7, 8, 26, 27, 100, (int) TionLtBleProtocol::FRAME_DATA_MAX_SIZE}) {
+    TestBleProtocol pr;
+    auto packets = pr.make_packets(0x1234, size);
+    pr.feed(packets);
+    res &= check_frame("fragmented " + std::to_string(size), pr, 0x1234, size);
+  }
+
+  // truncated: missing LAST, the next frame must be received
+  {
+    TestBleProtocol pr;
+    auto packets = pr.make_packets(0x1234, 100);
+    packets.pop_back();
+    pr.feed(packets);
+    pr.feed(pr.make_packets(0x5678, 50));
+    res &= check_frame("missing last", pr, 0x5678, 50);
+  }
+
+  // truncated: missing CURR, frame size or crc mismatch
+  {
+    TestBleProtocol pr;
+    auto packets = pr.make_packets(0x1234, 100);
+    packets.erase(packets.begin() + 2);
+    pr.feed(packets);
+    res &= cloak::check_data("missing curr", pr.frames.size(), 0);
+  }
+
+  // truncated: LONE packet shorter than frame header
+  {
+    TestBleProtocol pr;
+    res &= cloak::check_data("short lone", pr.feed(cloak::from_hex("80.0A.00.3A")), true);
+    res &= cloak::check_data("short lone frames", pr.frames.size(), 0);
+  }
+
+  // interleaved: CURR and LAST without FRST are rejected
+  {
+    TestBleProtocol pr;
+    auto packets = pr.make_packets(0x1234, 100);
+    res &= cloak::check_data("curr without frst", pr.feed(packets[1]), false);
+    res &= cloak::check_data("last without frst", pr.feed(packets.back()), false);
+    res &= cloak::check_data("without frst frames", pr.frames.size(), 0);
+  }
+
+  // interleaved: FRST of another frame restarts reassembly
+  {
+    TestBleProtocol pr;
+    auto packets1 = pr.make_packets(0x1234, 100);
+    auto packets2 = pr.make_packets(0x5678, 60);
+    pr.feed(packets1[0]);
+    pr.feed(packets1[1]);
+    pr.feed(packets2);
+    pr.feed(packets1[2]);
+    res &= check_frame("restarted", pr, 0x5678, 60);
+  }
+
+  // interleaved: LONE inside multi-packet frame does not break it
+  {
+    TestBleProtocol pr;
+    auto packets1 = pr.make_packets(0x1234, 100);
+    auto packets2 = pr.make_packets(0x5678, 4);
+    res &= cloak::check_data("lone packets", packets2.size(), 1);
+    pr.feed(packets1[0]);
+    pr.feed(packets2[0]);
+    pr.feed(std::vector(packets1.begin() + 1, packets1.end()));
+    res &= cloak::check_data("interleaved lone frames", pr.frames.size(), 2);
+    if (pr.frames.size() == 2) {
+      res &= cloak::check_data("interleaved lone type", pr.frames[0].type, 0x5678);
+      res &= cloak::check_data("interleaved frame type", pr.frames[1].type, 0x1234);
+    }
+  }
+
+  // overflow: frame larger than reassembly buffer is rejected without allocations
+  {
+    TestBleProtocol pr;
+    pr.frames.reserve(1);
+    const auto frst = cloak::from_hex("00.FF.FF.3A");
+    const auto curr = cloak::from_hex("40.00.00.00");
+    const auto last = cloak::from_hex("C0.00.00.00");
+    bool accepted = true;
+    cloak::AllocCounter counter;
+    accepted &= pr.read_data(frst.data(), frst.size());
+    for (size_t i = 0; i < TionLtBleProtocol::FRAME_MAX_SIZE / 3; i++) {
+      accepted &= pr.read_data(curr.data(), curr.size());
+    }
+    const bool last_accepted = pr.read_data(last.data(), last.size());
+    res &= cloak::check_data("overflow allocs", counter.count(), 0);
+    res &= cloak::check_data("overflow rejected", accepted, false);
+    res &= cloak::check_data("overflow last rejected", last_accepted, false);
+    res &= cloak::check_data("overflow frames", pr.frames.size(), 0);
+  }
+
+  return res;
+}
+
+bool test_api_ble_lt_allocs() {
+  bool res = true;
+
+  // 4s state response and 4s TEST response
+  for (size_t size : {35, (int) TionLtBleProtocol::FRAME_DATA_MAX_SIZE}) {
+    TestBleProtocol pr;
+    const auto packets = pr.make_packets(0x3231, size);
+
+    size_t frames{};
+    pr.set_protocol_reader([&frames](const tion_any_ble_frame_t &frame, size_t size) { frames++; });
+
+    size_t vec_frames{};
+    VectorBleProtocol vec;
+    vec.set_protocol_reader([&vec_frames](const tion_any_ble_frame_t &frame, size_t size) { vec_frames++; });
+    ReassemblyResult before, after;
+    {
+      cloak::MuteStdout mute;
+      before = count_allocs([&vec](const uint8_t *data, size_t size) { vec.read_data(data, size); }, packets);
+      after = count_allocs([&pr](const uint8_t *data, size_t size) { pr.read_data(data, size); }, packets);
+    }
+
+    ESP_LOGI(TAG, "%3zu bytes, %zu packets: vector %5.2f allocs/frame, fixed %5.2f allocs/frame", size,
+             packets.size(), before.allocs_per_frame, after.allocs_per_frame);
+    res &= cloak::check_data("vector frames", uint32_t(vec_frames), uint32_t(before.frames));
+    res &= cloak::check_data("fixed frames", uint32_t(frames), uint32_t(after.frames));
+    // both variants log the same, so only logging allocations are left
+    res &= cloak::check_data("fewer allocs", after.allocs_per_frame < before.allocs_per_frame, true);
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_api_ble_lt);
+REGISTER_TEST(test_api_ble_lt_allocs);
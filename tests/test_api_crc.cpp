@@ -10,6 +10,7 @@
 #include <iostream>
 #include <new>
 #include <vector>
+#include <algorithm>
 
 #include "utils.h"
 
@@ -27,7 +28,7 @@ using crc_fn_t = std::function<uint16_t(const void *, uint16_t)>;
 
 bool check_crc(crc_fn_t &&crc_fn, bool print) {
   uint8_t buf[32];
-  for (int i = 0; i < sizeof(buf); i++) {
+  for (size_t i = 0; i < sizeof(buf); i++) {
     buf[i] = fast_random_8();
   }
   if (print)
@@ -99,4 +100,68 @@ bool test_api_crc() {
   return res;
 }
 
+// reference bit by bit implementation
+static uint16_t crc16_ccitt_false_bitwise(uint16_t crc, const void *data, size_t size) {
+  const uint8_t *data_ptr = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data_ptr[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+static_assert(crc16_ccitt_false_table_entry(0x00) == 0x0000, "invalid table entry");
+static_assert(crc16_ccitt_false_table_entry(0x01) == 0x1021, "invalid table entry");
+static_assert(crc16_ccitt_false_table_entry(0x80) == 0x9188, "invalid table entry");
+static_assert(crc16_ccitt_false_table_entry(0xFF) == 0x1EF0, "invalid table entry");
+
+bool test_api_crc_variants() {
+  bool res = true;
+
+  // check value from the CRC catalogue
+  const char check[] = "123456789";
+  res &= cloak::check_data("check bytewise", crc16_ccitt_false_bytewise(0xFFFF, check, 9), (uint16_t) 0x29B1);
+  res &= cloak::check_data("check slice8", crc16_ccitt_false_slice8(0xFFFF, check, 9), (uint16_t) 0x29B1);
+  res &= cloak::check_data("check default", crc16_ccitt_false_ffff(check, 9), (uint16_t) 0x29B1);
+
+  std::vector<uint8_t> data(1024);
+  for (auto &b : data) {
+    b = fast_random_8();
+  }
+
+  bool match = true;
+  // all lengths up to and above 4s TEST response (440 bytes)
+  for (size_t size = 0; size <= data.size(); size++) {
+    const uint16_t init = size * 0x9E37;
+    const uint16_t exp = crc16_ccitt_false_bitwise(init, data.data(), size);
+    match &= crc16_ccitt_false_bytewise(init, data.data(), size) == exp;
+    match &= crc16_ccitt_false_slice8(init, data.data(), size) == exp;
+    match &= crc16_ccitt_false(init, data.data(), size) == exp;
+    // unaligned start
+    match &= crc16_ccitt_false_slice8(init, data.data() + 1, size - (size > 0)) ==
+             crc16_ccitt_false_bitwise(init, data.data() + 1, size - (size > 0));
+  }
+  res &= cloak::check_data("variants match", match, true);
+
+  // streaming in random chunks and by bytes
+  uint16_t state = 0xFFFF;
+  for (size_t pos = 0; pos < data.size();) {
+    size_t chunk = std::min<size_t>(fast_random_8() % 50, data.size() - pos);
+    state = crc16_update(state, data.data() + pos, chunk);
+    pos += chunk;
+  }
+  res &= cloak::check_data("streaming chunks", state, crc16_ccitt_false_ffff(data.data(), data.size()));
+
+  state = 0xFFFF;
+  for (auto b : data) {
+    state = crc16_update(state, b);
+  }
+  res &= cloak::check_data("streaming bytes", state, crc16_ccitt_false_ffff(data.data(), data.size()));
+
+  return res;
+}
+
 REGISTER_TEST(test_api_crc);
+REGISTER_TEST(test_api_crc_variants);
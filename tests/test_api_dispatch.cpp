@@ -0,0 +1,54 @@
+#include <vector>
+
+#include "../components/tion-api/tion-api-3s.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion-api/tion-api-lt.h"
+#include "../components/tion-api/tion-api-o2.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+namespace {
+
+// Dispatches every declared frame type with expected and wrong data size.
+template<class api_t, class handler_t, size_t N>
+bool check_frame_handlers(const char *model, const handler_t (&handlers)[N]) {
+  bool res = true;
+  api_t api;
+  std::vector<uint8_t> data(1024);
+  for (auto &handler : handlers) {
+    const size_t size = handler.size == handler_t::ANY_SIZE ? 17 : handler.size;
+    const auto name = std::string(model) + " " + handler.name;
+    res &= cloak::check_data(name + " found", dentra::tion::find_frame_handler(handlers, handler.type), &handler);
+    res &= cloak::check_data(name + " dispatched", api.read_frame(handler.type, data.data(), size), true);
+    if (handler.size != handler_t::ANY_SIZE) {
+      res &= cloak::check_data(name + " wrong size", api.read_frame(handler.type, data.data(), size + 1), false);
+    }
+  }
+  // types between and around declared ones must not be dispatched
+  for (auto &handler : handlers) {
+    for (uint16_t type : {uint16_t(handler.type - 1), uint16_t(handler.type + 1)}) {
+      if (dentra::tion::find_frame_handler(handlers, type) == nullptr) {
+        res &= cloak::check_data(std::string(model) + " unsupported", api.read_frame(type, data.data(), 1), false);
+      }
+    }
+  }
+  return res;
+}
+
+}  // namespace
+
+bool test_api_dispatch() {
+  bool res = true;
+
+  using namespace dentra;
+  res &= check_frame_handlers<tion_4s::Tion4sApi>("4s", tion_4s::tion4s_frame_handlers_t<tion_4s::Tion4sApi>::HANDLERS);
+  res &= check_frame_handlers<tion::Tion3sApi>("3s", tion_3s::tion3s_frame_handlers_t<tion::Tion3sApi>::HANDLERS);
+  res &= check_frame_handlers<tion_o2::TionO2Api>("o2", tion_o2::tiono2_frame_handlers_t<tion_o2::TionO2Api>::HANDLERS);
+  res &= check_frame_handlers<tion::TionLtApi>("lt", tion_lt::tionlt_frame_handlers_t<tion::TionLtApi>::HANDLERS);
+
+  return res;
+}
+
+REGISTER_TEST(test_api_dispatch);
@@ -0,0 +1,145 @@
+#include <cstring>
+#include <vector>
+
+#include "../components/tion-api/tion-api-frame.h"
+#include "../components/tion-api/tion-api-3s-internal.h"
+#include "../components/tion-api/tion-api-3s.h"
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion-api/tion-api-lt-internal.h"
+#include "../components/tion-api/tion-api-lt.h"
+#include "../components/tion-api/tion-api-o2-internal.h"
+#include "../components/tion-api/tion-api-o2.h"
+#include "../components/tion-api/tion-api-ble-lt.h"
+#include "../components/tion-api/tion-api-uart-3s.h"
+#include "../components/tion-api/tion-api-uart-4s.h"
+#include "../components/tion-api/tion-api-uart-o2.h"
+#include "../components/tion/tion_vport.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using namespace dentra;
+
+namespace {
+
+bool check_frame_builder() {
+  bool res = true;
+
+  tion::TionFrameBuilder<4, 8> fb;
+  auto &data = fb.emplace<uint32_t>(0x44332211);
+  res &= cloak::check_data("in place", fb.is_data(&data), true);
+  res &= cloak::check_data("data size", (uint32_t) fb.data_size(), (uint32_t) 4);
+
+  auto *head = fb.push_head(3);
+  head[0] = 0xA1;
+  head[1] = 0xA2;
+  head[2] = 0xA3;
+  res &= cloak::check_data("head is before data", head + 3 == fb.data(), true);
+  fb.push_head(1)[0] = 0xA0;
+  res &= cloak::check_data("head overflow", fb.push_head(1) == nullptr, true);
+  res &= cloak::check_data("frame", std::vector<uint8_t>(fb.frame(), fb.frame() + fb.frame_size()),
+                           "A0 A1 A2 A3 11 22 33 44");
+
+  // external data is copied and resets head
+  const uint8_t ext[] = {1, 2, 3};
+  res &= cloak::check_data("set data", fb.set_data(ext, sizeof(ext)), true);
+  res &= cloak::check_data("set data frame", std::vector<uint8_t>(fb.frame(), fb.frame() + fb.frame_size()),
+                           "01 02 03");
+  // data in place is not touched
+  res &= cloak::check_data("set data in place", fb.set_data(fb.data(), 2), true);
+  res &= cloak::check_data("in place frame", std::vector<uint8_t>(fb.frame(), fb.frame() + fb.frame_size()), "01 02");
+  uint8_t big[9]{};
+  res &= cloak::check_data("too large", fb.set_data(big, sizeof(big)), false);
+
+  return res;
+}
+
+// Counts frames passed from api to the transport and bytes copied on the way.
+struct CopyStat {
+  size_t frames;
+  size_t api_copied;
+};
+
+// Passes frames from the api to the protocol like vport without command queue does.
+template<class protocol_t> class TestVPort : public esphome::vport::VPort<typename protocol_t::frame_spec_type> {
+  using frame_spec_t = typename protocol_t::frame_spec_type;
+
+ public:
+  const uint8_t *api_tx_data{};
+  CopyStat stat{};
+
+  TestVPort() {
+    this->protocol_.set_protocol_writer([](const uint8_t *data, size_t size) { return true; });
+  }
+
+  void write(const frame_spec_t &frame, size_t size) override {
+    const size_t data_size = size - frame_spec_t::head_size();
+    this->stat.frames++;
+    if (reinterpret_cast<const uint8_t *>(frame.data) != this->api_tx_data) {
+      this->stat.api_copied += data_size;
+    }
+    this->protocol_.write_frame(frame.type, frame.data, data_size);
+  }
+
+ protected:
+  protocol_t protocol_;
+};
+
+template<class api_t, class protocol_t>
+class TestVPortApi : public esphome::tion::TionVPortApi<typename protocol_t::frame_spec_type, api_t> {
+ public:
+  explicit TestVPortApi(TestVPort<protocol_t> *vport)
+      : esphome::tion::TionVPortApi<typename protocol_t::frame_spec_type, api_t>(vport) {
+    vport->api_tx_data = this->tx_frame_.data();
+  }
+};
+
+// Api builds frames in place, so vport gets its buffer without a copy.
+template<class api_t, class protocol_t, class handlers_t>
+bool check_write_state(const char *model, const handlers_t &handlers, uint16_t state_type) {
+  TestVPort<protocol_t> vport;
+  TestVPortApi<api_t, protocol_t> api(&vport);
+
+  // make state initialized
+  const auto *handler = tion::find_frame_handler(handlers, state_type);
+  std::vector<uint8_t> state(handler->size);
+  api.read_frame(state_type, state.data(), state.size());
+
+  tion::TionStateCall call(&api);
+  call.set_fan_speed(2);
+  call.set_power_state(true);
+  api.write_state(&call);
+
+  const auto &stat = vport.stat;
+  bool res = true;
+  res &= cloak::check_data(std::string(model) + " frames", stat.frames > 0, true);
+  res &= cloak::check_data(std::string(model) + " api copied", (uint32_t) stat.api_copied, (uint32_t) 0);
+  return res;
+}
+
+}  // namespace
+
+bool test_api_frame() { return check_frame_builder(); }
+
+bool test_api_frame_in_place() {
+  bool res = true;
+
+  res &= check_write_state<tion_4s::Tion4sApi, tion::Tion4sUartProtocol>(
+      "4s uart", tion_4s::tion4s_frame_handlers_t<tion_4s::Tion4sApi>::HANDLERS, tion_4s::FRAME_TYPE_STATE_RSP);
+  res &= check_write_state<tion_4s::Tion4sApi, tion::TionLtBleProtocol>(
+      "4s ble", tion_4s::tion4s_frame_handlers_t<tion_4s::Tion4sApi>::HANDLERS, tion_4s::FRAME_TYPE_STATE_RSP);
+  res &= check_write_state<tion::Tion3sApi, tion::Tion3sUartProtocol>(
+      "3s uart", tion_3s::tion3s_frame_handlers_t<tion::Tion3sApi>::HANDLERS,
+      tion::Tion3sApi().get_state_type());
+  res &= check_write_state<tion::TionLtApi, tion::TionLtBleProtocol>(
+      "lt ble", tion_lt::tionlt_frame_handlers_t<tion::TionLtApi>::HANDLERS, tion_lt::FRAME_TYPE_STATE_RSP);
+  res &= check_write_state<tion_o2::TionO2Api, tion_o2::TionO2UartProtocol>(
+      "o2 uart", tion_o2::tiono2_frame_handlers_t<tion_o2::TionO2Api>::HANDLERS, tion_o2::FRAME_TYPE_STATE_GET_RSP);
+
+  return res;
+}
+
+REGISTER_TEST(test_api_frame);
+REGISTER_TEST(test_api_frame_in_place);
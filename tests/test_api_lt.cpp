@@ -11,6 +11,8 @@ class TionLtBleVPortApiTest
   TionLtBleVPortApiTest(vport_t *vport)
       : esphome::tion::TionVPortApi<TionLtBleIOTest::frame_spec_type, dentra::tion::TionLtApi>(vport) {
     this->state_.firmware_version = 0xFFFF;
+    // device info is known, so it is not requested with the state
+    this->planner_.complete(REQUEST_DEV_INFO);
     this->set_button_presets({20, 20, 20, 01, 03, 05});
   }
   bool request_dev_info() const { return this->request_dev_info_(); }
@@ -0,0 +1,199 @@
+#include "../components/tion-api/tion-api-3s-internal.h"
+#include "../components/tion-api/tion-api-3s.h"
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_3s;
+
+namespace {
+
+bool check_state_call() {
+  bool res = true;
+
+  TionStateCall call(nullptr);
+  res &= cloak::check_data("empty call", call.has_changes(), false);
+  res &= cloak::check_data("empty fan", call.get_fan_speed().has_value(), false);
+
+  call.set_fan_speed(3);
+  call.set_heater_state(false);
+  call.set_sound_state(true);
+  call.set_gate_state(true);
+  res &= cloak::check_data("has changes", call.has_changes(), true);
+  res &= cloak::check_data("changed mask", call.get_changed(),
+                           uint8_t(TionStateCall::FAN_SPEED | TionStateCall::HEATER_STATE |
+                                   TionStateCall::SOUND_STATE | TionStateCall::GATE_POSITION));
+  res &= cloak::check_data("fan", *call.get_fan_speed(), uint8_t(3));
+  res &= cloak::check_data("heater set", call.get_heater_state().has_value(), true);
+  res &= cloak::check_data("heater", *call.get_heater_state(), false);
+  res &= cloak::check_data("sound", *call.get_sound_state(), true);
+  res &= cloak::check_data("gate", *call.get_gate_position() == TionGatePosition::OPENED, true);
+  res &= cloak::check_data("power not set", call.get_power_state().has_value(), false);
+  res &= cloak::check_data("led not set", call.get_led_state().has_value(), false);
+
+  call.set_sound_state(false);
+  res &= cloak::check_data("sound reset", *call.get_sound_state(), false);
+
+  call.reset();
+  res &= cloak::check_data("reset", call.has_changes(), false);
+  res &= cloak::check_data("reset fan", call.get_fan_speed().has_value(), false);
+
+  return res;
+}
+
+tion3s_state_t make_state(bool heater_state, int8_t outdoor_temperature) {
+  tion3s_state_t state{};
+  state.fan_speed = 2;
+  state.target_temperature = 20;
+  state.flags.power_state = true;
+  state.flags.heater_state = heater_state;
+  state.outdoor_temperature = outdoor_temperature;
+  state.filter_time = 100;
+  return state;
+}
+
+// Feeds state response many times and returns number of allocations.
+size_t count_notify_allocs(Tion3sApi &api, const tion3s_state_t &state) {
+  // warm up, lazy statics and logger buffers may allocate on first call
+  api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &state, sizeof(state));
+
+  cloak::AllocCounter counter;
+  for (int i = 0; i < 100; i++) {
+    api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &state, sizeof(state));
+  }
+  return counter.count();
+}
+
+bool check_state_changes() {
+  bool res = true;
+
+  Tion3sApi api;
+  TionStateChangeMask changes{};
+  api.set_on_state([&changes](const TionState &, uint32_t, TionStateChangeMask c) { changes = c; });
+
+  const auto state = make_state(true, 10);
+  api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &state, sizeof(state));
+  res &= cloak::check_data("first state", (changes & TionState::INITIALIZED) != 0, true);
+
+  api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &state, sizeof(state));
+  res &= cloak::check_data("unchanged", changes, uint32_t(0));
+
+  const auto outdoor = make_state(true, 11);
+  api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &outdoor, sizeof(outdoor));
+  res &= cloak::check_data("outdoor changed", changes, uint32_t(TionState::OUTDOOR_TEMPERATURE));
+
+  const auto heater = make_state(false, 11);
+  api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &heater, sizeof(heater));
+  res &= cloak::check_data("heater changed", changes, uint32_t(TionState::HEATER_STATE));
+
+  return res;
+}
+
+// Traits reported with the state mark all fields changed, so entities depending on them are republished.
+bool check_traits_changes() {
+  bool res = true;
+
+  using namespace dentra::tion_4s;
+  Tion4sApi api;
+  TionStateChangeMask changes{};
+  api.set_on_state([&changes](const TionState &, uint32_t, TionStateChangeMask c) { changes = c; });
+
+  tion4s_raw_frame_t<tion4s_state_t> rsp{};
+  rsp.data.power_state = true;
+  rsp.data.fan_speed = 2;
+  rsp.data.max_fan_speed = 6;
+  rsp.data.heater_present = tion4s_state_t::HEATER_PRESENT_1000W;
+  api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+  api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+  res &= cloak::check_data("traits unchanged", changes, uint32_t(0));
+
+  rsp.data.heater_present = tion4s_state_t::HEATER_PRESENT_NONE;
+  api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+  res &= cloak::check_data("heater power changed", changes, uint32_t(TionState::ALL_FIELDS));
+  api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+  res &= cloak::check_data("heater power notified", changes, uint32_t(0));
+
+  rsp.data.max_fan_speed = 4;
+  api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+  res &= cloak::check_data("max fan speed changed", changes, uint32_t(TionState::ALL_FIELDS));
+
+  return res;
+}
+
+#ifdef TION_ENABLE_ANTIFREEZE
+// Antifreeze protection is performed with the first state received after the snapshot is restored.
+bool check_restored_antifreeze() {
+  bool res = true;
+
+  Tion3sApi api;
+  TionApiBase::Snapshot snapshot{};
+  snapshot.state.initialized = true;
+  snapshot.state.power_state = true;
+  snapshot.state.heater_state = true;
+  snapshot.state.fan_speed = 2;
+  snapshot.max_fan_speed = 6;
+  res &= cloak::check_data("restored", api.restore_snapshot(snapshot), true);
+
+  size_t writes{};
+  bool heater_state{};
+  api.set_api_writer([&writes, &heater_state](uint16_t type, const void *data, size_t size) {
+    if (type == FRAME_TYPE_REQ(FRAME_TYPE_STATE_SET)) {
+      writes++;
+      heater_state = static_cast<const tion3s_state_set_t *>(data)->flags.heater_state;
+    }
+    return true;
+  });
+
+  const auto state = make_state(false, -10);
+  api.read_frame(FRAME_TYPE_RSP(FRAME_TYPE_STATE_GET), &state, sizeof(state));
+  res &= cloak::check_data("restored stale", api.is_state_stale(), false);
+  res &= cloak::check_data("restored antifreeze writes", uint32_t(writes), uint32_t(1));
+  res &= cloak::check_data("restored antifreeze heater", heater_state, true);
+
+  return res;
+}
+#endif
+
+}  // namespace
+
+bool test_api_notify() {
+  bool res = true;
+
+  res &= check_state_call();
+  res &= check_state_changes();
+  res &= check_traits_changes();
+#ifdef TION_ENABLE_ANTIFREEZE
+  res &= check_restored_antifreeze();
+#endif
+
+  Tion3sApi api;
+  size_t states{};
+  size_t writes{};
+  api.set_on_state([&states](const TionState &, uint32_t, TionStateChangeMask) { states++; });
+  api.set_api_writer([&writes](uint16_t, const void *, size_t) {
+    writes++;
+    return true;
+  });
+
+  // steady state polling
+  res &= cloak::check_data("steady allocs", count_notify_allocs(api, make_state(true, 10)), 0);
+  res &= cloak::check_data("steady states", states, 101);
+  res &= cloak::check_data("steady writes", writes, 0);
+
+#ifdef TION_ENABLE_ANTIFREEZE
+  // antifreeze protection performs a call on every state, verbose frame logging allocates there, so only check
+  // that the call is performed
+  states = 0;
+  count_notify_allocs(api, make_state(false, -10));
+  res &= cloak::check_data("antifreeze states", states, 101);
+  res &= cloak::check_data("antifreeze writes", writes, 101);
+#endif
+
+  return res;
+}
+
+REGISTER_TEST(test_api_notify);
@@ -0,0 +1,174 @@
+#include <string>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_4s;
+
+namespace {
+
+// Breezer without heater which limits fan speed.
+class FakeBreezer : public Fake4sBreezer {
+ public:
+  bool drop{};
+  uint8_t fan_speed_limit{6};
+
+  explicit FakeBreezer(Tion4sApi &api) : Fake4sBreezer(&api) {
+    this->state.fan_speed = 2;
+    this->state.heater_present = tion4s_state_t::HEATER_PRESENT_NONE;
+    this->state.heater_mode = tion4s_state_t::HEATER_MODE_FANONLY;
+    this->state.comm_source = CommSource::USER;
+  }
+
+ protected:
+  void on_state_set_(const StateSetRequest &req) override {
+    if (this->drop) {
+      return;
+    }
+    this->state.power_state = req.data.power_state;
+    this->state.comm_source = req.data.comm_source;
+    this->state.fan_speed = std::min(req.data.fan_speed, this->fan_speed_limit);
+    Fake4sBreezer::on_state_set_(req);
+  }
+};
+
+struct Notification {
+  uint8_t fan_speed;
+  bool heater_state;
+  bool predicted;
+  TionStateChangeMask changes;
+};
+
+class OptimisticTest {
+ public:
+  Tion4sApi api;
+  FakeBreezer breezer{api};
+  std::vector<Notification> notifications;
+
+  OptimisticTest() {
+    esphome::test_set_millis(0);
+    this->api.set_optimistic(true);
+    this->api.set_write_retry(100, 1);
+    this->api.set_on_state([this](const TionState &state, uint32_t, TionStateChangeMask changes) {
+      this->notifications.push_back({state.fan_speed, state.heater_state, this->api.is_state_predicted(), changes});
+    });
+    this->api.request_state();
+    this->breezer.poll();
+    this->notifications.clear();
+  }
+
+  void perform(uint8_t fan_speed) {
+    TionStateCall call(&this->api);
+    call.set_fan_speed(fan_speed);
+    call.perform();
+  }
+
+  void run_until(uint32_t ms) {
+    for (uint32_t now = esphome::millis(); now <= ms; now += 10) {
+      esphome::test_set_millis(now);
+      this->breezer.poll();
+      this->api.check_requests();
+    }
+  }
+};
+
+bool check_notification(const std::string &name, const OptimisticTest &t, size_t index, uint8_t fan_speed,
+                        bool predicted) {
+  if (!cloak::check_data(name + " notified", t.notifications.size() > index, true)) {
+    return false;
+  }
+  bool res = true;
+  res &= cloak::check_data(name + " fan speed", t.notifications[index].fan_speed, fan_speed);
+  res &= cloak::check_data(name + " predicted", t.notifications[index].predicted, predicted);
+  return res;
+}
+
+}  // namespace
+
+bool test_api_optimistic() {
+  bool res = true;
+
+  // predicted state is published at once and confirmed by the response
+  {
+    OptimisticTest t;
+    t.perform(4);
+    res &= check_notification("confirm predicted", t, 0, 4, true);
+    res &= cloak::check_data("confirm pending", t.api.is_state_pending(), true);
+    t.breezer.poll();
+    res &= check_notification("confirm response", t, 1, 4, false);
+    res &= cloak::check_data("confirm no changes", t.notifications[1].changes, TionStateChangeMask(0));
+    res &= cloak::check_data("confirm not pending", t.api.is_state_pending(), false);
+  }
+
+  // regular state response received before the confirmation does not revert predicted value
+  {
+    OptimisticTest t;
+    t.api.request_state();
+    t.breezer.drop = true;
+    t.perform(4);
+    t.breezer.poll();
+    res &= check_notification("regular response", t, 1, 4, false);
+    res &= cloak::check_data("regular pending", t.api.is_state_pending(), true);
+  }
+
+  // fan speed above breezer limit is clamped
+  {
+    OptimisticTest t;
+    t.breezer.fan_speed_limit = 5;
+    t.perform(6);
+    res &= check_notification("clamp predicted", t, 0, 6, true);
+    t.breezer.poll();
+    res &= check_notification("clamp rollback", t, 1, 5, false);
+    res &= cloak::check_data("clamp changes", t.notifications[1].changes, TionStateChangeMask(TionState::FAN_SPEED));
+  }
+
+  // fan speed above max_fan_speed is not predicted
+  {
+    OptimisticTest t;
+    t.perform(7);
+    res &= cloak::check_data("max fan speed", t.notifications.empty(), true);
+  }
+
+  // heater request is rejected by breezer without heater
+  {
+    OptimisticTest t;
+    TionStateCall call(&t.api);
+    call.set_heater_state(true);
+    call.perform();
+    res &= cloak::check_data("heater predicted", t.notifications.size() > 0 && t.notifications[0].heater_state, true);
+    t.breezer.poll();
+    res &= cloak::check_data("heater rollback", t.notifications.size() > 1 && !t.notifications[1].heater_state, true);
+    res &= cloak::check_data("heater changes", t.notifications[1].changes,
+                             TionStateChangeMask(TionState::HEATER_STATE));
+  }
+
+  // not confirmed write is rolled back by the actual state
+  {
+    OptimisticTest t;
+    t.breezer.drop = true;
+    t.perform(4);
+    t.run_until(400);
+    t.breezer.drop = false;
+    res &= cloak::check_data("lost not pending", t.api.is_state_pending(), false);
+    t.breezer.poll();
+    res &= check_notification("lost rollback", t, t.notifications.size() - 1, 2, false);
+  }
+
+  // optimistic mode is disabled by default
+  {
+    OptimisticTest t;
+    t.api.set_optimistic(false);
+    t.perform(4);
+    res &= cloak::check_data("disabled", t.notifications.empty(), true);
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_api_optimistic);
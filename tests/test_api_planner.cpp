@@ -0,0 +1,119 @@
+#include <string>
+
+#include "test_api_planner.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_4s;
+using dentra::tion_o2::TionO2Api;
+
+namespace {
+
+using Planner = TionRequestPlanner<4>;
+
+}  // namespace
+
+bool test_api_planner() {
+  bool res = true;
+
+  // policies
+  {
+    Planner p;
+    p.set_policy(0, Planner::ONCE);
+    p.set_policy(1, Planner::ON_CHANGE, 1000);
+    p.set_policy(2, Planner::EVERY_POLLS, 3);
+    p.set_policy(3, Planner::EVERY_MILLIS, 500);
+
+    res &= cloak::check_data("once first", p.plan(0, 0), true);
+    res &= cloak::check_data("once not answered", p.plan(0, 100), true);
+    p.complete(0);
+    res &= cloak::check_data("once answered", p.plan(0, 200), false);
+
+    res &= cloak::check_data("change first", p.plan(1, 0), true);
+    p.complete(1);
+    res &= cloak::check_data("change fresh", p.plan(1, 100), false);
+    p.invalidate(1);
+    res &= cloak::check_data("change invalidated", p.plan(1, 200), true);
+    p.complete(1);
+    res &= cloak::check_data("change refresh wait", p.plan(1, 1100), false);
+    res &= cloak::check_data("change refresh", p.plan(1, 1200), true);
+
+    std::string polls;
+    for (int i = 0; i < 7; i++) {
+      polls += p.plan(2, 0) ? '+' : '-';
+    }
+    res &= cloak::check_data("every polls", polls, std::string("+--+--+"));
+
+    res &= cloak::check_data("every millis first", p.plan(3, 0), true);
+    res &= cloak::check_data("every millis wait", p.plan(3, 400), false);
+    res &= cloak::check_data("every millis", p.plan(3, 500), true);
+  }
+
+  // 4s turbo is requested only after the change and while it is active
+  {
+    Planner4s fake;
+    esphome::test_set_millis(0);
+    run_planner_polls(fake, 5000, 1000);
+    const auto idle = fake.link.stat.frames;
+    run_planner_polls(fake, 5000, 1000);
+    // state request and response per poll
+    res &= cloak::check_data("4s idle frames", uint32_t(fake.link.stat.frames - idle), uint32_t(5 * 2));
+
+    TionStateCall call(&fake.api);
+    static_cast<TionApiBase &>(fake.api).enable_boost(true, &call);
+    fake.link.poll();
+    const auto active = fake.link.stat.frames;
+    run_planner_polls(fake, 5000, 1000);
+    res &= cloak::check_data("4s active frames", uint32_t(fake.link.stat.frames - active), uint32_t(5 * 4));
+    res &= cloak::check_data("4s boost time", fake.api.get_boost_time_left(), fake.turbo.turbo_time);
+  }
+
+  // o2 dev mode is requested after the state change
+  {
+    PlannerO2 fake;
+    esphome::test_set_millis(0);
+    run_planner_polls(fake, 5000, 1000);
+    const auto requests = fake.dev_mode_requests;
+    run_planner_polls(fake, 5000, 1000);
+    res &= cloak::check_data("o2 idle dev mode", uint32_t(fake.dev_mode_requests), uint32_t(requests));
+    fake.state.fan_speed = 3;
+    run_planner_polls(fake, 2000, 1000);
+    res &= cloak::check_data("o2 changed dev mode", uint32_t(fake.dev_mode_requests), uint32_t(requests + 1));
+    res &= cloak::check_data("o2 firmware", fake.api.get_state().firmware_version, uint16_t(0x0240));
+  }
+
+  return res;
+}
+
+bool test_api_planner_traffic() {
+  bool res = true;
+
+  PlannerLinkStat stat[2][3];
+  for (int planned = 0; planned < 2; planned++) {
+    const auto policy = planned ? Planner::ON_CHANGE : Planner::ALWAYS;
+    {
+      Planner4s fake;
+      fake.api.set_request_policy(Tion4sApi::REQUEST_TURBO, policy, TION_4S_TURBO_REFRESH_INTERVAL);
+      stat[planned][0] = run_planner_fast_mode(fake);
+    }
+    {
+      PlannerLt fake;
+      stat[planned][1] = run_planner_fast_mode(fake);
+    }
+    {
+      PlannerO2 fake;
+      fake.api.set_request_policy(TionO2Api::REQUEST_DEV_MODE, policy, TION_O2_DEV_MODE_REFRESH_INTERVAL);
+      stat[planned][2] = run_planner_fast_mode(fake);
+    }
+  }
+
+  res &= cloak::check_data("4s fewer frames", stat[1][0].frames < stat[0][0].frames, true);
+  res &= cloak::check_data("lt same frames", uint32_t(stat[1][1].frames), uint32_t(stat[0][1].frames));
+  res &= cloak::check_data("o2 fewer frames", stat[1][2].frames < stat[0][2].frames, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_api_planner);
+REGISTER_TEST(test_api_planner_traffic);
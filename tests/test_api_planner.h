@@ -0,0 +1,215 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion-api/tion-api-lt.h"
+#include "../components/tion-api/tion-api-o2.h"
+#include "../components/tion-api/tion-api-ble-lt.h"
+#include "../components/tion-api/tion-api-uart-o2.h"
+
+#include "utils.h"
+
+struct PlannerLinkStat {
+  size_t frames;
+  size_t bytes;
+  size_t packets;
+};
+
+// Breezer link. Frames of both directions are encoded with the real protocol to count bytes and packets on the wire.
+// Frames written by the api of the breezer are answered by its respond(), responses are delivered on poll like the
+// real transport does.
+template<class protocol_t, class breezer_t> class PlannerLink {
+ public:
+  PlannerLinkStat stat{};
+
+  explicit PlannerLink(breezer_t &breezer) : breezer_(breezer) {
+    this->protocol_.set_protocol_writer([this](const uint8_t *data, size_t size) {
+      this->stat.bytes += size;
+      this->stat.packets++;
+      return true;
+    });
+    breezer.api.set_api_writer([this](uint16_t type, const void *data, size_t size) {
+      this->send_(type, data, size);
+      Response rsp{};
+      if (this->breezer_.respond(type, data, rsp.type, rsp.data)) {
+        this->send_(rsp.type, rsp.data.data(), rsp.data.size());
+        this->rx_.push_back(std::move(rsp));
+      }
+      return true;
+    });
+  }
+
+  void poll() {
+    while (!this->rx_.empty()) {
+      const auto rsp = std::move(this->rx_.front());
+      this->rx_.pop_front();
+      this->breezer_.api.read_frame(rsp.type, rsp.data.data(), rsp.data.size());
+    }
+  }
+
+  template<class T> static void make(std::vector<uint8_t> &rsp, const T &data) {
+    const auto *ptr = reinterpret_cast<const uint8_t *>(&data);
+    rsp.assign(ptr, ptr + sizeof(data));
+  }
+
+ protected:
+  struct Response {
+    uint16_t type;
+    std::vector<uint8_t> data;
+  };
+  breezer_t &breezer_;
+  protocol_t protocol_;
+  std::deque<Response> rx_;
+
+  void send_(uint16_t type, const void *data, size_t size) {
+    this->stat.frames++;
+    this->protocol_.write_frame(type, data, size);
+  }
+};
+
+// 4S over BLE, native turbo is supported only there.
+class Planner4s {
+ public:
+  using State = dentra::tion_4s::tion4s_state_t;
+  using Turbo = dentra::tion_4s::tion4s_turbo_t;
+
+  dentra::tion_4s::Tion4sApi api;
+  State state{};
+  Turbo turbo{};
+  PlannerLink<dentra::tion::TionLtBleProtocol, Planner4s> link{*this};
+
+  Planner4s() {
+    this->api.enable_native_boost_support();
+    this->state.power_state = true;
+    this->state.fan_speed = 2;
+    this->state.max_fan_speed = 6;
+  }
+
+  bool respond(uint16_t type, const void *data, uint16_t &rsp_type, std::vector<uint8_t> &rsp) {
+    using namespace dentra::tion_4s;
+    switch (type) {
+      case FRAME_TYPE_DEV_INFO_REQ: {
+        rsp_type = FRAME_TYPE_DEV_INFO_RSP;
+        dentra::tion::tion_dev_info_t dev_info{};
+        dev_info.firmware_version = 0x0240;
+        this->link.make(rsp, dev_info);
+        return true;
+      }
+      case FRAME_TYPE_STATE_REQ:
+        rsp_type = FRAME_TYPE_STATE_RSP;
+        this->link.make(rsp, tion4s_raw_frame_t<State>{.request_id = 1, .data = this->state});
+        return true;
+      case FRAME_TYPE_TURBO_SET: {
+        const auto &req = *static_cast<const tion4s_raw_frame_t<tion4s_turbo_set_t> *>(data);
+        this->turbo.is_active = req.data.time > 0;
+        this->turbo.turbo_time = req.data.time;
+        this->state.fan_speed = req.data.time > 0 ? this->state.max_fan_speed : 2;
+      }
+        // fallthrough
+      case FRAME_TYPE_TURBO_REQ:
+        rsp_type = FRAME_TYPE_TURBO_RSP;
+        this->link.make(rsp, tion4s_raw_frame_t<Turbo>{.request_id = 1, .data = this->turbo});
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+// LT over BLE, uart protocol of LT is a text console.
+class PlannerLt {
+ public:
+  dentra::tion::TionLtApi api;
+  dentra::tion_lt::tionlt_state_t state{};
+  PlannerLink<dentra::tion::TionLtBleProtocol, PlannerLt> link{*this};
+
+  PlannerLt() {
+    this->state.power_state = true;
+    this->state.fan_speed = 2;
+  }
+
+  bool respond(uint16_t type, const void *data, uint16_t &rsp_type, std::vector<uint8_t> &rsp) {
+    using namespace dentra::tion_lt;
+    switch (type) {
+      case FRAME_TYPE_DEV_INFO_REQ: {
+        rsp_type = FRAME_TYPE_DEV_INFO_RSP;
+        dentra::tion::tion_dev_info_t dev_info{};
+        dev_info.firmware_version = 0x0240;
+        this->link.make(rsp, dev_info);
+        return true;
+      }
+      case FRAME_TYPE_STATE_REQ:
+        rsp_type = FRAME_TYPE_STATE_RSP;
+        this->link.make(rsp, tionlt_state_get_req_t{.request_id = 1, .state = this->state});
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+class PlannerO2 {
+ public:
+  dentra::tion_o2::TionO2Api api;
+  dentra::tion_o2::tiono2_state_t state{};
+  size_t dev_mode_requests{};
+  PlannerLink<dentra::tion_o2::TionO2UartProtocol, PlannerO2> link{*this};
+
+  PlannerO2() {
+    this->state.power_state = true;
+    this->state.fan_speed = 2;
+  }
+
+  bool respond(uint16_t type, const void *data, uint16_t &rsp_type, std::vector<uint8_t> &rsp) {
+    using namespace dentra::tion_o2;
+    switch (type) {
+      case FRAME_TYPE_CONNECT_REQ:
+        rsp_type = FRAME_TYPE_CONNECT_RSP;
+        rsp = {0x04, 0x10, 0x01, 0x00};
+        return true;
+      case FRAME_TYPE_DEV_INFO_REQ: {
+        rsp_type = FRAME_TYPE_DEV_INFO_RSP;
+        tiono2_dev_info_t dev_info{};
+        dev_info.firmware_version = 0x0240;
+        this->link.make(rsp, dev_info);
+        return true;
+      }
+      case FRAME_TYPE_DEV_MODE_REQ:
+        this->dev_mode_requests++;
+        rsp_type = FRAME_TYPE_DEV_MODE_RSP;
+        rsp = {0x00};
+        return true;
+      case FRAME_TYPE_STATE_GET_REQ:
+        rsp_type = FRAME_TYPE_STATE_GET_RSP;
+        this->link.make(rsp, this->state);
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+// Polls the breezer for the given time.
+template<class breezer_t> void run_planner_polls(breezer_t &breezer, uint32_t duration, uint32_t poll_interval) {
+  const uint32_t start = esphome::millis();
+  for (uint32_t now = start; now - start < duration; now += poll_interval) {
+    esphome::test_set_millis(now);
+    breezer.api.request_state();
+    breezer.link.poll();
+  }
+}
+
+// Ten minutes of 1 s polls, like adaptive polling in fast mode.
+// @return traffic per minute.
+template<class breezer_t> PlannerLinkStat run_planner_fast_mode(breezer_t &breezer) {
+  esphome::test_set_millis(0);
+  run_planner_polls(breezer, 10 * 60 * 1000, 1000);
+  auto stat = breezer.link.stat;
+  stat.frames /= 10;
+  stat.bytes /= 10;
+  stat.packets /= 10;
+  return stat;
+}
@@ -0,0 +1,219 @@
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_4s;
+
+namespace {
+
+// Breezer behind the link that drops, reorders and duplicates responses to writes. Written state is not applied.
+class FakeVPort : public Fake4sBreezer {
+ public:
+  enum Policy { PASS, DROP, HOLD, DUPLICATE };
+
+  std::vector<uint32_t> writes;
+  Policy policy{PASS};
+
+  explicit FakeVPort(Tion4sApi &api) : Fake4sBreezer(&api) { this->state.fan_speed = 2; }
+
+  // Delivers held responses in reverse order.
+  void release_reversed() {
+    while (!this->held_.empty()) {
+      const auto rsp = this->held_.back();
+      this->held_.pop_back();
+      this->deliver_(rsp);
+    }
+  }
+
+ protected:
+  std::deque<Response> held_;
+
+  void on_frame_(uint16_t type, const void *data, size_t size) override {
+    // only writes are answered, so all responses follow the policy
+    if (type == FRAME_TYPE_STATE_SET) {
+      Fake4sBreezer::on_frame_(type, data, size);
+    }
+  }
+
+  void on_state_set_(const StateSetRequest &req) override {
+    this->writes.push_back(req.request_id);
+    switch (this->policy) {
+      case PASS:
+        Fake4sBreezer::on_state_set_(req);
+        break;
+      case DROP:
+        break;
+      case HOLD:
+        this->held_.push_back({FRAME_TYPE_STATE_RSP, 0, this->make_state_(req.request_id)});
+        break;
+      case DUPLICATE:
+        Fake4sBreezer::on_state_set_(req);
+        Fake4sBreezer::on_state_set_(req);
+        break;
+    }
+  }
+};
+
+struct Completion {
+  uint32_t request_id;
+  bool confirmed;
+  uint32_t rtt;
+};
+
+class RequestsTest {
+ public:
+  Tion4sApi api;
+  FakeVPort vport{api};
+  std::vector<Completion> completions;
+
+  RequestsTest() {
+    esphome::test_set_millis(0);
+    this->api.set_write_retry(100, 2);
+    this->api.set_on_write_complete([this](uint32_t request_id, bool confirmed, uint32_t rtt) {
+      this->completions.push_back({request_id, confirmed, rtt});
+    });
+    this->vport.send_state();
+  }
+
+  void write_fan_speed(uint8_t fan_speed) {
+    TionStateCall call(&this->api);
+    call.set_fan_speed(fan_speed);
+    call.perform();
+  }
+
+  // Runs loop every 10 ms.
+  void run_until(uint32_t ms) {
+    for (uint32_t now = esphome::millis(); now <= ms; now += 10) {
+      esphome::test_set_millis(now);
+      this->vport.poll();
+      this->api.check_requests();
+    }
+  }
+};
+
+bool check_completion(const std::string &name, const RequestsTest &t, size_t index, uint32_t request_id,
+                      bool confirmed) {
+  bool res = true;
+  if (!cloak::check_data(name + " completion", t.completions.size() > index, true)) {
+    return false;
+  }
+  res &= cloak::check_data(name + " request id", t.completions[index].request_id, request_id);
+  res &= cloak::check_data(name + " confirmed", t.completions[index].confirmed, confirmed);
+  return res;
+}
+
+}  // namespace
+
+bool test_api_requests() {
+  bool res = true;
+
+  // confirmed by the response with the same request id
+  {
+    RequestsTest t;
+    esphome::test_set_millis(20);
+    t.vport.policy = FakeVPort::HOLD;
+    t.write_fan_speed(3);
+    // regular state response does not confirm the write
+    t.vport.send_state();
+    res &= cloak::check_data("pass pending", uint32_t(t.api.get_pending_requests()), uint32_t(1));
+    esphome::test_set_millis(65);
+    t.vport.release_reversed();
+    res &= check_completion("pass", t, 0, t.vport.writes[0], true);
+    res &= cloak::check_data("pass request id", t.vport.writes[0] > 1, true);
+    res &= cloak::check_data("pass rtt", t.completions[0].rtt, uint32_t(45));
+    res &= cloak::check_data("pass rtt last", t.api.get_last_rtt(), uint32_t(45));
+    res &= cloak::check_data("pass drained", uint32_t(t.api.get_pending_requests()), uint32_t(0));
+  }
+
+  // dropped response: resent with the same request id
+  {
+    RequestsTest t;
+    t.vport.policy = FakeVPort::DROP;
+    t.write_fan_speed(3);
+    t.vport.policy = FakeVPort::PASS;
+    t.run_until(150);
+    res &= cloak::check_data("drop writes", uint32_t(t.vport.writes.size()), uint32_t(2));
+    res &= cloak::check_data("drop same id", t.vport.writes[1], t.vport.writes[0]);
+    res &= check_completion("drop", t, 0, t.vport.writes[0], true);
+    // resent at 100 ms, response is received on the next loop
+    res &= cloak::check_data("drop rtt", t.completions[0].rtt, uint32_t(110));
+  }
+
+  // all responses dropped: retries with backoff and then not confirmed
+  {
+    RequestsTest t;
+    t.vport.policy = FakeVPort::DROP;
+    t.write_fan_speed(3);
+    t.run_until(250);
+    res &= cloak::check_data("lost retries", uint32_t(t.vport.writes.size()), uint32_t(2));
+    t.run_until(300);
+    res &= cloak::check_data("lost backoff", uint32_t(t.vport.writes.size()), uint32_t(3));
+    res &= cloak::check_data("lost waiting", t.completions.empty(), true);
+    t.run_until(1000);
+    res &= cloak::check_data("lost writes", uint32_t(t.vport.writes.size()), uint32_t(3));
+    res &= check_completion("lost", t, 0, t.vport.writes[0], false);
+    res &= cloak::check_data("lost drained", uint32_t(t.api.get_pending_requests()), uint32_t(0));
+  }
+
+  // reordered responses: both writes are confirmed, superseded write is not resent
+  {
+    RequestsTest t;
+    t.vport.policy = FakeVPort::HOLD;
+    t.write_fan_speed(3);
+    t.write_fan_speed(4);
+    res &= cloak::check_data("reorder pending", uint32_t(t.api.get_pending_requests()), uint32_t(2));
+    t.vport.release_reversed();
+    res &= cloak::check_data("reorder completions", uint32_t(t.completions.size()), uint32_t(2));
+    res &= check_completion("reorder newer", t, 0, t.vport.writes[1], true);
+    res &= check_completion("reorder older", t, 1, t.vport.writes[0], true);
+    t.run_until(1000);
+    res &= cloak::check_data("reorder writes", uint32_t(t.vport.writes.size()), uint32_t(2));
+  }
+
+  // superseded write with lost response expires without retries
+  {
+    RequestsTest t;
+    t.vport.policy = FakeVPort::DROP;
+    t.write_fan_speed(3);
+    t.vport.policy = FakeVPort::PASS;
+    t.write_fan_speed(4);
+    t.run_until(1000);
+    res &= cloak::check_data("superseded writes", uint32_t(t.vport.writes.size()), uint32_t(2));
+    res &= check_completion("superseded newer", t, 0, t.vport.writes[1], true);
+    res &= check_completion("superseded older", t, 1, t.vport.writes[0], false);
+  }
+
+  // duplicated response completes the request once
+  {
+    RequestsTest t;
+    t.vport.policy = FakeVPort::DUPLICATE;
+    t.write_fan_speed(3);
+    t.vport.poll();
+    res &= cloak::check_data("duplicate completions", uint32_t(t.completions.size()), uint32_t(1));
+    res &= check_completion("duplicate", t, 0, t.vport.writes[0], true);
+  }
+
+  // table overflow drops the oldest request
+  {
+    RequestsTest t;
+    t.vport.policy = FakeVPort::HOLD;
+    for (int i = 0; i <= TION_MAX_PENDING_REQUESTS; i++) {
+      t.write_fan_speed(1 + i % 6);
+    }
+    res &= cloak::check_data("overflow pending", uint32_t(t.api.get_pending_requests()),
+                             uint32_t(TION_MAX_PENDING_REQUESTS));
+    res &= check_completion("overflow dropped", t, 0, t.vport.writes[0], false);
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_api_requests);
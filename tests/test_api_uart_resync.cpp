@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../components/tion-api/tion-api-3s-internal.h"
+#include "../components/tion-api/tion-api-o2-internal.h"
+#include "../components/tion-api/tion-api-uart-3s.h"
+#include "../components/tion-api/tion-api-uart-4s.h"
+#include "../components/tion-api/tion-api-uart-o2.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using dentra::tion::tion_any_frame_t;
+using frames_t = std::vector<std::vector<uint8_t>>;
+
+namespace {
+
+// Reads data in chunks like hardware uart fifo does.
+class ChunkUartReader : public dentra::tion::TionUartReader {
+ public:
+  explicit ChunkUartReader(const std::vector<uint8_t> &data) : data_(data) {}
+  int available() override {
+    const size_t left = this->data_.size() - this->pos_;
+    return left < CHUNK_SIZE ? left : CHUNK_SIZE;
+  }
+  bool read_array(void *data, size_t size) override {
+    if (this->pos_ + size > this->data_.size()) {
+      return false;
+    }
+    std::memcpy(data, this->data_.data() + this->pos_, size);
+    this->pos_ += size;
+    return true;
+  }
+  bool empty() const { return this->pos_ == this->data_.size(); }
+
+ protected:
+  enum { CHUNK_SIZE = 64 };
+  const std::vector<uint8_t> &data_;
+  size_t pos_{};
+};
+
+struct ResyncResult {
+  size_t frames_injected;
+  size_t frames_received;
+  size_t frames_recovered;
+  size_t noise_bytes;
+};
+
+// Generates frame with random payload using protocol writer.
+template<class protocol_t> std::vector<uint8_t> make_frame(protocol_t &protocol, uint16_t type, size_t size) {
+  std::vector<uint8_t> payload(size);
+  for (auto &b : payload) {
+    b = fast_random_8();
+  }
+  std::vector<uint8_t> frame;
+  protocol.set_protocol_writer([&frame](const uint8_t *data, size_t size) {
+    frame.assign(data, data + size);
+    return true;
+  });
+  protocol.write_frame(type, payload.data(), payload.size());
+  return frame;
+}
+
+// Injects noise burst before each frame and feeds protocol with noise+frame at once. Time-to-resync is measured by
+// */uart_resync benchmarks.
+template<class protocol_t, class make_frame_t>
+ResyncResult feed_noise(protocol_t &protocol, make_frame_t &&make_frame, size_t noise_total) {
+  std::mt19937 rnd(0x7107);
+  std::uniform_int_distribution<size_t> burst_dist(1, 64);
+
+  frames_t received;
+  protocol.set_protocol_reader([&received](const tion_any_frame_t &frame, size_t size) {
+    auto *frame8 = reinterpret_cast<const uint8_t *>(&frame);
+    received.emplace_back(frame8, frame8 + size);
+  });
+
+  ResyncResult res{};
+  frames_t injected;
+  while (res.noise_bytes < noise_total) {
+    std::vector<uint8_t> data(burst_dist(rnd));
+    for (auto &b : data) {
+      b = rnd();
+    }
+    res.noise_bytes += data.size();
+
+    auto frame = make_frame(&injected);
+    data.insert(data.end(), frame.begin(), frame.end());
+
+    ChunkUartReader io(data);
+    while (!io.empty()) {
+      protocol.read_uart_data(&io);
+    }
+  }
+
+  res.frames_injected = injected.size();
+  res.frames_received = received.size();
+  // count injected frames found in received ones in the same order, noise may produce false frames,
+  // short frames may repeat, so look ahead only a few received frames
+  auto it = received.begin();
+  for (auto &frame : injected) {
+    auto last = received.end() - it > 4 ? it + 4 : received.end();
+    auto found = std::find(it, last, frame);
+    if (found != last) {
+      res.frames_recovered++;
+      it = found + 1;
+    }
+  }
+  return res;
+}
+
+bool report_resync(const char *model, const ResyncResult &res, double min_recovered) {
+  const double noise_mb = res.noise_bytes / (1024.0 * 1024.0);
+  const double recovered = double(res.frames_recovered) / res.frames_injected;
+  ESP_LOGI(TAG, "%s: noise %zu bytes, frames injected %zu, received %zu, recovered %zu (%.2f%%)", model,
+           res.noise_bytes, res.frames_injected, res.frames_received, res.frames_recovered, recovered * 100);
+  ESP_LOGI(TAG, "%s: frames recovered per MB of noise %.0f", model, res.frames_recovered / noise_mb);
+  return cloak::check_data(std::string(model) + " recovered", recovered >= min_recovered, true);
+}
+
+constexpr size_t NOISE_TOTAL = 256 * 1024;
+
+}  // namespace
+
+bool test_uart_resync() {
+  bool res = true;
+
+  // truncated frame followed by valid one must not be lost
+  {
+    dentra::tion::Tion4sUartProtocol protocol;
+    size_t frames{};
+    protocol.set_protocol_reader([&frames](const tion_any_frame_t &frame, size_t size) { frames++; });
+    auto data = cloak::from_hex("3A 2A 00 31 32 00 00 00 00 1F E1 00 0A 02 "
+                                "3A 08 00 31 39 00 E8 2B 3A 08 00 31 39 00 E8 2B "
+                                "3A 08 00 31 39 00 E8 2B 3A 08 00 31 39 00 E8 2B");
+    ChunkUartReader io(data);
+    protocol.read_uart_data(&io);
+    res &= cloak::check_data("4s truncated frame", frames, 4);
+  }
+  {
+    dentra::tion::Tion3sUartProtocol protocol;
+    size_t frames{};
+    protocol.set_protocol_reader([&frames](const tion_any_frame_t &frame, size_t size) { frames++; });
+    auto data = cloak::from_hex("B3 10 00 00 B3 10 21 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 5A");
+    ChunkUartReader io(data);
+    protocol.read_uart_data(&io);
+    res &= cloak::check_data("3s truncated frame", frames, 1);
+  }
+  {
+    dentra::tion_o2::TionO2UartProtocol protocol;
+    size_t frames{};
+    protocol.set_protocol_reader([&frames](const tion_any_frame_t &frame, size_t size) { frames++; });
+    auto data = cloak::from_hex("11 0C 0C 13 11 0C 0C 13 10 02 3C 04 00 00 B4 D6 DC 01 01 F6 CA 01 54");
+    ChunkUartReader io(data);
+    protocol.read_uart_data(&io);
+    res &= cloak::check_data("o2 truncated frame", frames, 1);
+  }
+
+  return res;
+}
+
+bool test_uart_resync_noise() {
+  bool res = true;
+
+  ResyncResult res_4s, res_3s, res_o2;
+  {
+    // protocol logs every skipped byte, so hide stdout while noise is processed
+    cloak::MuteStdout mute;
+
+    dentra::tion::Tion4sUartProtocol proto_4s;
+    res_4s = feed_noise(
+        proto_4s,
+        [&proto_4s](frames_t *injected) {
+          auto frame = make_frame(proto_4s, 0x3231, fast_random_8() % 30);
+          // type and data without magic, size and crc
+          injected->emplace_back(frame.begin() + 3, frame.end() - 2);
+          return frame;
+        },
+        NOISE_TOTAL);
+
+    dentra::tion::Tion3sUartProtocol proto_3s;
+    res_3s = feed_noise(
+        proto_3s,
+        [&proto_3s](frames_t *injected) {
+          auto frame = make_frame(proto_3s, FRAME_TYPE(dentra::tion_3s::FRAME_MAGIC_RSP, 0x10), 17);
+          // without end magic
+          injected->emplace_back(frame.begin(), frame.end() - 1);
+          return frame;
+        },
+        NOISE_TOTAL);
+
+    dentra::tion_o2::TionO2UartProtocol proto_o2;
+    res_o2 = feed_noise(
+        proto_o2,
+        [&proto_o2](frames_t *injected) {
+          static const uint8_t types[] = {dentra::tion_o2::FRAME_TYPE_STATE_GET_RSP,
+                                          dentra::tion_o2::FRAME_TYPE_CONNECT_RSP,
+                                          dentra::tion_o2::FRAME_TYPE_DEV_MODE_RSP};
+          const uint8_t type = types[fast_random_8() % sizeof(types)];
+          auto frame = make_frame(proto_o2, type, dentra::tion_o2::get_rsp_frame_size(type) - 1);
+          // 16-bit type and data without crc
+          std::vector<uint8_t> exp{type, 0};
+          exp.insert(exp.end(), frame.begin() + 1, frame.end() - 1);
+          injected->push_back(exp);
+          return frame;
+        },
+        NOISE_TOTAL);
+  }
+
+  res &= report_resync("4s", res_4s, 0.99);
+  // 3s has no crc and o2 has only xor crc, so noise may hide some frames
+  res &= report_resync("3s", res_3s, 0.95);
+  res &= report_resync("o2", res_o2, 0.90);
+
+  return res;
+}
+
+REGISTER_TEST(test_uart_resync);
+REGISTER_TEST(test_uart_resync_noise);
@@ -0,0 +1,160 @@
+// RX events are backed by the fake ESP-IDF uart driver.
+#define USE_ESP_IDF
+
+#include <string>
+#include <vector>
+
+#include "../components/tion-api/tion-api-3s-internal.h"
+#include "../components/tion-api/tion-api-3s.h"
+#include "../components/tion-api/tion-api-o2-internal.h"
+#include "../components/tion-api/tion-api-uart-3s.h"
+#include "../components/tion-api/tion-api-uart-lt.h"
+#include "../components/tion-api/tion-api-uart-o2.h"
+#include "../components/tion/tion_vport_uart.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using esphome::uart::IDFUARTComponent;
+
+namespace {
+
+// Uart io which counts reads.
+template<class protocol_t> class TestUartIO : public esphome::tion::TionUartIO<protocol_t> {
+ public:
+  size_t reads{};
+  explicit TestUartIO(esphome::uart::UARTComponent *uart) : esphome::tion::TionUartIO<protocol_t>(uart) {}
+  bool read_array(void *data, size_t size) override {
+    this->reads++;
+    return esphome::tion::TionUartIO<protocol_t>::read_array(data, size);
+  }
+};
+
+struct RxResult {
+  size_t loops;
+  size_t reads;
+  size_t frames;
+  uint32_t latency_us_max;
+};
+
+enum RxMode { RX_POLL, RX_PATTERN, RX_TIMEOUT, RX_PATTERN_LOST };
+
+// Receives response every 500 ms, loop runs every millisecond.
+template<class protocol_t>
+RxResult run_rx(RxMode mode, int pattern, uint32_t timeout, const std::vector<uint8_t> &response) {
+  const size_t responses = 4;
+  const uint32_t period = 500;
+
+  RxResult res{};
+  IDFUARTComponent uart(1);
+  uart.set_baud_rate(9600);
+  TestUartIO<protocol_t> io(&uart);
+  if (mode == RX_PATTERN || mode == RX_PATTERN_LOST) {
+    io.set_rx_pattern(pattern);
+  }
+  if (mode != RX_POLL) {
+    io.set_rx_timeout(timeout);
+  }
+  io.setup_rx();
+
+  uint32_t last_us{};
+  io.set_on_frame([&](const dentra::tion::tion_any_frame_t &, size_t) {
+    res.frames++;
+    const uint32_t latency = esphome::micros() - last_us;
+    if (latency > res.latency_us_max) {
+      res.latency_us_max = latency;
+    }
+  });
+
+  for (uint32_t ms = 0; ms < responses * period; ms++) {
+    esphome::test_set_millis(ms);
+    if (ms % period == period / 2) {
+      uart.test_rx_push(response);
+      last_us = uart.test_rx_last_us();
+    }
+    if (mode == RX_PATTERN_LOST) {
+      uart.test_pattern_drop();
+    }
+    io.poll();
+    res.loops++;
+  }
+  res.reads = io.reads;
+  return res;
+}
+
+template<class protocol_t>
+bool check_rx(const char *model, int pattern, uint32_t timeout, const std::vector<uint8_t> &response) {
+  bool res = true;
+  const auto poll = run_rx<protocol_t>(RX_POLL, pattern, timeout, response);
+  const auto event = run_rx<protocol_t>(pattern < 0 ? RX_TIMEOUT : RX_PATTERN, pattern, timeout, response);
+
+  ESP_LOGI(TAG, "%s poll : %zu frames, %4zu reads, %zu idle loops, last byte to frame %u us", model, poll.frames,
+           poll.reads, poll.loops - poll.reads, poll.latency_us_max);
+  ESP_LOGI(TAG, "%s event: %zu frames, %4zu reads, %zu idle loops, last byte to frame %u us", model, event.frames,
+           event.reads, event.loops - event.reads, event.latency_us_max);
+
+  const std::string name(model);
+  res &= cloak::check_data(name + " frames", uint32_t(event.frames), uint32_t(poll.frames));
+  res &= cloak::check_data(name + " fewer reads", event.reads < poll.reads, true);
+  // pattern wakes up in the loop after the last byte, timeout wakes up after the line is idle for timeout
+  const uint32_t latency_max = (pattern < 0 ? timeout + 1 : 1) * 1000;
+  res &= cloak::check_data(name + " latency", event.latency_us_max <= latency_max, true);
+
+  if (pattern >= 0) {
+    // data of lost pattern event is read after RX timeout or the fallback one
+    const auto lost = run_rx<protocol_t>(RX_PATTERN_LOST, pattern, timeout, response);
+    const uint32_t lost_timeout =
+        timeout != 0 ? timeout : esphome::tion::TionUartIO<protocol_t>::RX_PATTERN_FALLBACK_TIMEOUT;
+    res &= cloak::check_data(name + " lost pattern frames", uint32_t(lost.frames), uint32_t(poll.frames));
+    res &= cloak::check_data(name + " lost pattern latency", lost.latency_us_max <= (lost_timeout + 1) * 1000, true);
+  }
+  return res;
+}
+
+template<class protocol_t> std::vector<uint8_t> make_frame(protocol_t &protocol, uint16_t type, size_t size) {
+  std::vector<uint8_t> res;
+  protocol.set_protocol_writer([&res](const uint8_t *data, size_t size) {
+    res.assign(data, data + size);
+    return true;
+  });
+  std::vector<uint8_t> data(size);
+  protocol.write_frame(type, data.data(), data.size());
+  return res;
+}
+
+}  // namespace
+
+bool test_api_uart_rx() {
+  bool res = true;
+
+  {
+    dentra::tion::Tion3sUartProtocol protocol;
+    auto frame = make_frame(protocol, dentra::tion::Tion3sApi().get_state_type(), 0);
+    res &= check_rx<dentra::tion::Tion3sUartProtocol>("3s", dentra::tion_3s::FRAME_MAGIC_END, 50, frame);
+  }
+
+  {
+    const char *state = "Current Mode: Work\r\n"
+                        "Speed: 2\r\n"
+                        "Sensors T_set: 20, T_In: 10, T_out: 21 \r\n"
+                        "PID_Value: 0 0\r\n"
+                        "Filter Time: 100\r\n"
+                        "Working Time: 100\r\n"
+                        "Power On Time: 100\r\n"
+                        "Error register: 0\r\n";
+    res &= check_rx<dentra::tion_lt::TionLtUartProtocol>("lt", '\n', 0,
+                                                        std::vector<uint8_t>(state, state + std::strlen(state)));
+  }
+
+  {
+    dentra::tion_o2::TionO2UartProtocol protocol;
+    const uint8_t type = dentra::tion_o2::FRAME_TYPE_STATE_GET_RSP;
+    auto frame = make_frame(protocol, type, dentra::tion_o2::get_rsp_frame_size(type) - 1);
+    res &= check_rx<dentra::tion_o2::TionO2UartProtocol>("o2", -1, 10, frame);
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_api_uart_rx);
@@ -0,0 +1,132 @@
+#include <vector>
+
+#include "test_api_uart_tx.h"
+
+DEFINE_TAG;
+
+using esphome::uart::UARTComponent;
+
+namespace {
+
+bool check_tx_queue() {
+  bool res = true;
+
+  dentra::tion::TionUartTxQueue<16> q;
+  const uint8_t f1[] = {1, 2, 3, 4, 5, 6};
+  const uint8_t f2[] = {7, 8, 9, 10, 11};
+  res &= cloak::check_data("queue empty", q.empty(), true);
+  res &= cloak::check_data("queue empty frame", q.push(f1, 0), false);
+  res &= cloak::check_data("queue push 1", q.push(f1, sizeof(f1)), true);
+  res &= cloak::check_data("queue push 2", q.push(f2, sizeof(f2)), true);
+  res &= cloak::check_data("queue full", q.push(f1, sizeof(f1)), false);
+  res &= cloak::check_data("queue frames", uint32_t(q.frames()), uint32_t(2));
+  res &= cloak::check_data("queue front 1", std::vector<uint8_t>(q.front_data(), q.front_data() + q.front_size()),
+                           "01 02 03 04 05 06");
+  q.pop();
+  // the freed room at the beginning is reused
+  res &= cloak::check_data("queue push 3", q.push(f1, sizeof(f1)), true);
+  res &= cloak::check_data("queue front 2", std::vector<uint8_t>(q.front_data(), q.front_data() + q.front_size()),
+                           "07 08 09 0A 0B");
+  q.pop();
+  res &= cloak::check_data("queue front 3", std::vector<uint8_t>(q.front_data(), q.front_data() + q.front_size()),
+                           "01 02 03 04 05 06");
+  q.pop();
+  res &= cloak::check_data("queue drained", q.empty(), true);
+
+  return res;
+}
+
+}  // namespace
+
+bool test_api_uart_tx() {
+  bool res = true;
+
+  res &= check_tx_queue();
+
+  // write to the TX FIFO only what fits there
+  {
+    UARTComponent uart;
+    uart.set_baud_rate(9600);
+    TxUartIO io(&uart);
+    size_t completed{};
+    io.set_on_tx_complete([&completed](const uint8_t *, size_t) { completed++; });
+    const auto r = run_tx_burst(io, uart, 12, 10);
+    res &= cloak::check_data("queued write blocked", r.write_us, uint32_t(0));
+    res &= cloak::check_data("queued loop blocked", r.loop_us_max, uint32_t(0));
+    res &= cloak::check_data("queued completed", uint32_t(completed), uint32_t(12));
+  }
+
+  // queue overflow rejects frames, accepted ones are sent
+  {
+    UARTComponent uart;
+    uart.set_baud_rate(9600);
+    TxUartIO io(&uart);
+    const uint8_t data[32]{};
+    esphome::test_set_millis(0);
+    size_t accepted{};
+    for (int i = 0; i < 20; i++) {
+      accepted += io.write_frame(0x1234, data, sizeof(data)) ? 1 : 0;
+    }
+    res &= cloak::check_data("queue overflow rejected", accepted < 20, true);
+    for (uint32_t ms = 1; ms < 1000; ms++) {
+      esphome::test_set_millis(ms);
+      io.poll();
+    }
+    res &= cloak::check_data("queue overflow sent", uint32_t(uart.test_data().size()),
+                             uint32_t(accepted * make_tx_frame(0x1234, sizeof(data)).size()));
+  }
+
+  // half duplex: next frame waits for the response or timeout
+  {
+    UARTComponent uart(make_tx_frame(0x3231, 8));
+    TxUartIO io(&uart);
+    size_t rx_frames{};
+    io.set_on_frame([&rx_frames](const dentra::tion::tion_any_frame_t &, size_t) { rx_frames++; });
+    io.set_half_duplex(true);
+    const uint8_t data[4]{};
+    esphome::test_set_millis(0);
+    io.write_frame(0x1234, data, sizeof(data));
+    io.write_frame(0x1234, data, sizeof(data));
+    io.write_frame(0x1234, data, sizeof(data));
+    io.poll();
+    res &= cloak::check_data("half duplex first sent", uint32_t(io.tx_queued()), uint32_t(2));
+    io.rx_enabled = true;
+    io.poll();
+    res &= cloak::check_data("half duplex response", uint32_t(rx_frames), uint32_t(1));
+    res &= cloak::check_data("half duplex second sent", uint32_t(io.tx_queued()), uint32_t(1));
+    esphome::test_set_millis(50);
+    io.poll();
+    res &= cloak::check_data("half duplex waiting", uint32_t(io.tx_queued()), uint32_t(1));
+    esphome::test_set_millis(200);
+    io.poll();
+    res &= cloak::check_data("half duplex timeout", uint32_t(io.tx_queued()), uint32_t(0));
+  }
+
+  return res;
+}
+
+bool test_api_uart_tx_blocking() {
+  bool res = true;
+
+  // 4s timers setup is the largest burst: 12 frames
+  const size_t frames = 12;
+  const size_t data_size = 10;
+
+  UARTComponent blocking_uart;
+  blocking_uart.set_baud_rate(9600);
+  TxBlockingUartIO blocking_io(&blocking_uart);
+  const auto before = run_tx_burst(blocking_io, blocking_uart, frames, data_size);
+
+  UARTComponent queued_uart;
+  queued_uart.set_baud_rate(9600);
+  TxUartIO queued_io(&queued_uart);
+  const auto after = run_tx_burst(queued_io, queued_uart, frames, data_size);
+
+  res &= cloak::check_data("same data", queued_uart.test_data() == blocking_uart.test_data(), true);
+  res &= cloak::check_data("less blocking", after.write_us + after.loop_us_max < before.write_us, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_api_uart_tx);
+REGISTER_TEST(test_api_uart_tx_blocking);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "../components/tion-api/tion-api-uart.h"
+#include "../components/tion-api/tion-api-uart-4s.h"
+#include "../components/tion/tion_vport_uart.h"
+
+#include "utils.h"
+
+// Writes frames like TionUartIO did before TX queue.
+class TxBlockingUartIO : public esphome::tion::TionIO<dentra::tion::Tion4sUartProtocol> {
+ public:
+  explicit TxBlockingUartIO(esphome::uart::UARTComponent *uart) {
+    this->protocol_.set_protocol_writer([uart](const uint8_t *data, size_t size) {
+      uart->write_array(data, size);
+      uart->flush();
+      return true;
+    });
+  }
+  void poll() {}
+};
+
+// Uart io with response delivery controlled by the test.
+class TxUartIO : public esphome::tion::TionUartIO<dentra::tion::Tion4sUartProtocol> {
+ public:
+  bool rx_enabled{};
+  explicit TxUartIO(esphome::uart::UARTComponent *uart)
+      : esphome::tion::TionUartIO<dentra::tion::Tion4sUartProtocol>(uart) {
+    this->set_on_frame([](const dentra::tion::tion_any_frame_t &, size_t) {});
+  }
+  int available() override { return this->rx_enabled ? this->uart_->available() : 0; }
+  size_t tx_queued() const { return this->tx_queue_.frames(); }
+  bool write_frame(uint16_t type, const void *data, size_t size) {
+    return this->protocol_.write_frame(type, data, size);
+  }
+};
+
+// Returns frame bytes as they go to the uart.
+inline std::vector<uint8_t> make_tx_frame(uint16_t type, size_t size) {
+  std::vector<uint8_t> res;
+  dentra::tion::Tion4sUartProtocol protocol;
+  protocol.set_protocol_writer([&res](const uint8_t *data, size_t size) {
+    res.assign(data, data + size);
+    return true;
+  });
+  std::vector<uint8_t> data(size);
+  protocol.write_frame(type, data.data(), data.size());
+  return res;
+}
+
+struct TxResult {
+  uint32_t write_us;
+  uint32_t loop_us_max;
+  uint32_t done_ms;
+};
+
+// Writes burst of frames at once and then runs loop every millisecond until all data is transmitted.
+template<class io_t>
+TxResult run_tx_burst(io_t &io, esphome::uart::UARTComponent &uart, size_t frames, size_t data_size) {
+  TxResult res{};
+  // type and data
+  std::vector<uint8_t> frame(sizeof(uint16_t) + data_size);
+  const size_t tx_size = frames * make_tx_frame(0, data_size).size();
+
+  esphome::test_set_millis(0);
+  for (size_t i = 0; i < frames; i++) {
+    frame[sizeof(uint16_t)] = i;
+    io.write(*reinterpret_cast<const dentra::tion::tion_any_frame_t *>(frame.data()), frame.size());
+  }
+  res.write_us = uart.get_tx_blocked_us();
+
+  for (uint32_t ms = 1; uart.test_data().size() < tx_size && ms < 10000; ms++) {
+    esphome::test_set_millis(ms);
+    const uint32_t blocked = uart.get_tx_blocked_us();
+    io.poll();
+    const uint32_t loop_us = uart.get_tx_blocked_us() - blocked;
+    if (loop_us > res.loop_us_max) {
+      res.loop_us_max = loop_us;
+    }
+    res.done_ms = ms;
+  }
+  return res;
+}
@@ -138,12 +138,14 @@ bool test_auto() {
     capi.api()->auto_update(sp, call);
     call->perform();
     esphome::test_set_millis(esphome::millis() + 10 * ONE_MINUTE);
+    capi.call_loop();
   }
 
   for (int i = 0; i < 100; i++) {
     capi.api()->auto_update(650, call);
     call->perform();
     esphome::test_set_millis(esphome::millis() + 10 * ONE_MINUTE);
+    capi.call_loop();
   }
 
   return res;
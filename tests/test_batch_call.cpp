@@ -0,0 +1,89 @@
+#include "test_batch_call.h"
+
+DEFINE_TAG;
+
+bool test_batch_call() {
+  bool res = true;
+
+  // trailing edge debounce
+  {
+    BatchTest t(200, 1000);
+    t.perform(2);
+    t.run_until(100);
+    t.perform(3);
+    t.run_until(290);
+    res &= cloak::check_data("debounce waiting", uint32_t(t.result.frames), uint32_t(0));
+    t.run_until(300);
+    res &= cloak::check_data("debounce written", uint32_t(t.result.frames), uint32_t(1));
+    res &= cloak::check_data("debounce latency", t.result.latency_max, uint32_t(300));
+    t.run_until(2000);
+    res &= cloak::check_data("debounce once", uint32_t(t.result.frames), uint32_t(1));
+  }
+
+  // continuous changes are written out not later than max latency
+  {
+    const auto r = run_batch_slider(200, 1000);
+    res &= cloak::check_data("max latency frames", uint32_t(r.frames), uint32_t(3));
+    res &= cloak::check_data("max latency", r.latency_max, uint32_t(1000));
+  }
+
+  // priority change is written at once with the pending ones
+  {
+    BatchTest t(200, 1000);
+    t.perform(2);
+    t.run_until(100);
+    t.perform_power_off();
+    res &= cloak::check_data("priority frames", uint32_t(t.result.frames), uint32_t(1));
+    res &= cloak::check_data("priority latency", t.result.latency_max, uint32_t(100));
+    t.run_until(2000);
+    res &= cloak::check_data("priority once", uint32_t(t.result.frames), uint32_t(1));
+  }
+
+  // heater in frost is priority for breezers with manual antifreeze
+  {
+    BatchTest t(200, 1000);
+    t.api.set_manual_antifreeze(true);
+    auto *call = t.component.make_call();
+    call->set_heater_state(true);
+    call->perform();
+    res &= cloak::check_data("antifreeze frames", uint32_t(t.result.frames), uint32_t(1));
+  }
+
+  // and is batched for others
+  {
+    BatchTest t(200, 1000);
+    auto *call = t.component.make_call();
+    call->set_heater_state(true);
+    call->perform();
+    res &= cloak::check_data("no antifreeze frames", uint32_t(t.result.frames), uint32_t(0));
+    t.run_until(200);
+    res &= cloak::check_data("no antifreeze batched", uint32_t(t.result.frames), uint32_t(1));
+  }
+
+  // zero batch timeout writes at once
+  {
+    BatchTest t(0, 1000);
+    t.perform(2);
+    res &= cloak::check_data("no batch frames", uint32_t(t.result.frames), uint32_t(1));
+  }
+
+  return res;
+}
+
+bool test_batch_call_latency() {
+  bool res = true;
+
+  const auto slider_unbound = run_batch_slider(200, 0);
+  const auto slider = run_batch_slider(200, 1000);
+  const auto clicks = run_batch_clicks(200, 1000);
+
+  res &= cloak::check_data("bounded latency", slider.latency_max < slider_unbound.latency_max, true);
+  res &= cloak::check_data("slider merged", slider.frames < slider.calls / 10, true);
+  res &= cloak::check_data("clicks written", uint32_t(clicks.frames), uint32_t(clicks.calls));
+  res &= cloak::check_data("clicks latency", clicks.latency_max, uint32_t(200));
+
+  return res;
+}
+
+REGISTER_TEST(test_batch_call);
+REGISTER_TEST(test_batch_call_latency);
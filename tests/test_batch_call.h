@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion/tion_component.h"
+
+#include "utils.h"
+
+struct BatchResult {
+  size_t calls;
+  size_t frames;
+  uint32_t latency_max;
+};
+
+class BatchApi : public dentra::tion_4s::Tion4sApi {
+ public:
+  void set_manual_antifreeze(bool value) { this->traits_.supports_manual_antifreeze = value; }
+};
+
+class BatchTest {
+ public:
+  BatchApi api;
+  esphome::tion::TionApiComponent component{&api};
+  BatchResult result{};
+
+  BatchTest(uint32_t batch_timeout, uint32_t batch_max_latency) {
+    esphome::test_set_millis(0);
+    this->component.set_batch_timeout(batch_timeout);
+    this->component.set_batch_max_latency(batch_max_latency);
+    this->component.test_timeout(true);
+    // writes are not confirmed here, so they are not resent
+    this->api.set_write_retry(1000, 0);
+    this->api.set_api_writer([this](uint16_t type, const void *data, size_t size) {
+      if (type == dentra::tion_4s::FRAME_TYPE_STATE_SET) {
+        this->on_write_();
+      }
+      return true;
+    });
+    // make state initialized
+    dentra::tion_4s::tion4s_raw_frame_t<dentra::tion_4s::tion4s_state_t> rsp{};
+    rsp.data.power_state = true;
+    rsp.data.fan_speed = 1;
+    rsp.data.max_fan_speed = 6;
+    rsp.data.outdoor_temperature = -10;
+    this->api.read_frame(dentra::tion_4s::FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+  }
+
+  void perform(uint8_t fan_speed) {
+    auto *call = this->component.make_call();
+    call->set_fan_speed(fan_speed);
+    this->perform_(call);
+  }
+
+  void perform_power_off() {
+    auto *call = this->component.make_call();
+    call->set_power_state(false);
+    this->perform_(call);
+  }
+
+  // Runs loop every 10 ms.
+  void run_until(uint32_t ms) {
+    for (uint32_t now = esphome::millis() + 10; now <= ms; now += 10) {
+      esphome::test_set_millis(now);
+      this->component.call_loop();
+    }
+  }
+
+ protected:
+  // times of calls not written yet
+  std::vector<uint32_t> pending_;
+
+  void perform_(dentra::tion::TionStateCall *call) {
+    this->result.calls++;
+    this->pending_.push_back(esphome::millis());
+    call->perform();
+  }
+
+  void on_write_() {
+    this->result.frames++;
+    for (auto time : this->pending_) {
+      this->result.latency_max = std::max(this->result.latency_max, esphome::millis() - time);
+    }
+    this->pending_.clear();
+  }
+};
+
+// Slider is moved for 3 s, each 50 ms a new value.
+inline BatchResult run_batch_slider(uint32_t batch_timeout, uint32_t batch_max_latency) {
+  BatchTest t(batch_timeout, batch_max_latency);
+  for (uint32_t ms = 0; ms < 3000; ms += 50) {
+    t.run_until(ms);
+    t.perform(1 + (ms / 50) % 6);
+  }
+  t.run_until(5000);
+  return t.result;
+}
+
+// Button is clicked every 500 ms.
+inline BatchResult run_batch_clicks(uint32_t batch_timeout, uint32_t batch_max_latency) {
+  BatchTest t(batch_timeout, batch_max_latency);
+  for (uint32_t ms = 0; ms < 3000; ms += 500) {
+    t.run_until(ms);
+    t.perform(1 + (ms / 500) % 6);
+  }
+  t.run_until(5000);
+  return t.result;
+}
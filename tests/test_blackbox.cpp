@@ -0,0 +1,96 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../components/tion-api/tion-api-blackbox.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using dentra::tion::TionBlackBoxRecord;
+
+bool test_blackbox() {
+  bool res = true;
+
+  // record line is parsed from the log line
+  {
+    TionBlackBoxRecord record;
+    uint8_t data[TionBlackBoxRecord::DATA_MAX_SIZE];
+    res &= cloak::check_data("parse not record", TionBlackBoxRecord::parse("[I][tion:1]: state", &record, data), false);
+    res &= cloak::check_data("parse short", TionBlackBoxRecord::parse("bb 0102", &record, data), false);
+    // size does not match data
+    res &= cloak::check_data("parse size", TionBlackBoxRecord::parse("bb 0A000000823132030102", &record, data), false);
+    res &= cloak::check_data("parse", TionBlackBoxRecord::parse("[I][bb]: bb 0A00000083313202AABB", &record, data),
+                             true);
+    res &= cloak::check_data("parse time", record.time, uint32_t(10));
+    res &= cloak::check_data("parse tx", record.is_tx(), true);
+    res &= cloak::check_data("parse vport", record.get_vport(), uint8_t(0));
+    res &= cloak::check_data("parse model", uint8_t(record.get_model()), uint8_t(TionBlackBoxRecord::MODEL_LT));
+    res &= cloak::check_data("parse type", record.type, uint16_t(0x3231));
+    res &= cloak::check_data("parse data", std::vector<uint8_t>(data, data + record.size), "AA BB");
+  }
+
+#ifdef TION_ENABLE_BLACKBOX
+  using dentra::tion::TionBlackBox;
+  auto &bb = TionBlackBox::get();
+  const auto source = TionBlackBoxRecord::make_source(2, TionBlackBoxRecord::MODEL_4S);
+
+  // recorded frames are dumped from the oldest one
+  {
+    bb.clear();
+    const uint8_t rsp[3] = {1, 2, 3};
+    esphome::test_set_millis(100);
+    TION_BLACKBOX_TX(source, 0x3232, nullptr, 0);
+    esphome::test_set_millis(150);
+    TION_BLACKBOX_RX(source, 0x3231, rsp, sizeof(rsp));
+    std::vector<std::string> lines;
+    bb.for_each_line([&lines](const char *line) { lines.emplace_back(line); });
+    res &= cloak::check_data("records", bb.get_records(), uint32_t(2));
+    res &= cloak::check_data("lines", uint32_t(lines.size()), uint32_t(2));
+    res &= cloak::check_data("line tx", lines[0], std::string("bb 64000000A2323200"));
+    res &= cloak::check_data("line rx", lines[1], std::string("bb 9600000022313203010203"));
+
+    TionBlackBoxRecord record;
+    uint8_t data[TionBlackBoxRecord::DATA_MAX_SIZE];
+    res &= cloak::check_data("line parse", TionBlackBoxRecord::parse(lines[1].c_str(), &record, data), true);
+    res &= cloak::check_data("line parse rx", record.is_tx(), false);
+    res &= cloak::check_data("line parse vport", record.get_vport(), uint8_t(2));
+    res &= cloak::check_data("line parse model", uint8_t(record.get_model()), uint8_t(TionBlackBoxRecord::MODEL_4S));
+    res &= cloak::check_data("line parse data", std::vector<uint8_t>(data, data + record.size), "01 02 03");
+  }
+
+  // the oldest records are overwritten, records wrapped around the buffer end are read back
+  {
+    bb.clear();
+    uint8_t payload[TionBlackBoxRecord::DATA_MAX_SIZE + 10];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+      payload[i] = i;
+    }
+    constexpr uint32_t RECORD_SIZE = sizeof(TionBlackBoxRecord) + TionBlackBoxRecord::DATA_MAX_SIZE;
+    constexpr uint32_t CAPACITY = TionBlackBox::SIZE / RECORD_SIZE;
+    const uint32_t total = CAPACITY * 3 + 1;
+    for (uint32_t i = 0; i < total; i++) {
+      TION_BLACKBOX_RX(source, i, payload, sizeof(payload));
+    }
+    res &= cloak::check_data("wrap records", bb.get_records(), CAPACITY);
+    res &= cloak::check_data("wrap lost", bb.get_lost(), total - CAPACITY);
+    uint32_t expected = total - CAPACITY;
+    bool in_order = true;
+    bool truncated = true;
+    bb.for_each_line([&](const char *line) {
+      TionBlackBoxRecord record;
+      uint8_t data[TionBlackBoxRecord::DATA_MAX_SIZE];
+      in_order &= TionBlackBoxRecord::parse(line, &record, data) && record.type == expected++;
+      truncated &= record.size == TionBlackBoxRecord::DATA_MAX_SIZE && std::memcmp(data, payload, record.size) == 0;
+    });
+    res &= cloak::check_data("wrap order", in_order, true);
+    res &= cloak::check_data("wrap truncated", truncated, true);
+    bb.clear();
+  }
+#endif
+
+  return res;
+}
+
+REGISTER_TEST(test_blackbox);
@@ -0,0 +1,111 @@
+#include <string>
+
+#include "test_command_queue.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_4s;
+
+namespace {
+
+using Queue = TionCommandQueue<4, 8>;
+
+}  // namespace
+
+bool test_command_queue() {
+  bool res = true;
+  const uint8_t data1[] = {1};
+  const uint8_t data2[] = {2};
+
+  // strict priority, fifo within the class
+  {
+    Queue q;
+    q.push(1, TionCommandClass::DIAGNOSTIC, nullptr, 0);
+    q.push(2, TionCommandClass::STATE, nullptr, 0);
+    q.push(3, TionCommandClass::CONTROL, data1, 1);
+    q.push(4, TionCommandClass::CONTROL, data2, 1);
+    std::string order;
+    while (!q.empty()) {
+      order += std::to_string(q.front().type);
+      q.pop();
+    }
+    res &= cloak::check_data("priority order", order, std::string("3421"));
+  }
+
+  // idempotent requests are replaced in place, control frames are kept
+  {
+    TionCommandQueue<8, 8> q;
+    q.push(1, TionCommandClass::STATE, data1, 1);
+    q.push(1, TionCommandClass::STATE, data2, 1);
+    q.push(2, TionCommandClass::DIAGNOSTIC, data1, 1);
+    q.push(2, TionCommandClass::DIAGNOSTIC, data2, 1);
+    q.push(2, TionCommandClass::DIAGNOSTIC, data2, 1);
+    q.push(3, TionCommandClass::CONTROL, data1, 1);
+    q.push(3, TionCommandClass::CONTROL, data1, 1);
+    res &= cloak::check_data("coalesce size", uint32_t(q.size()), uint32_t(5));
+    res &= cloak::check_data("coalesce count", q.get_coalesced(), uint32_t(2));
+    res &= cloak::check_data("coalesce data", q.front().data[0], uint8_t(1));
+    q.pop();
+    q.pop();
+    res &= cloak::check_data("coalesce replaced", q.front().data[0], uint8_t(2));
+  }
+
+  // overflow evicts the lowest class, control frame is never evicted
+  {
+    Queue q;
+    for (uint16_t type = 1; type <= 4; type++) {
+      q.push(type, TionCommandClass::DIAGNOSTIC, nullptr, 0);
+    }
+    res &= cloak::check_data("overflow same class", q.push(5, TionCommandClass::DIAGNOSTIC, nullptr, 0), false);
+    for (uint16_t type = 6; type <= 9; type++) {
+      res &= cloak::check_data("overflow control", q.push(type, TionCommandClass::CONTROL, nullptr, 0), true);
+    }
+    res &= cloak::check_data("overflow state", q.push(10, TionCommandClass::STATE, nullptr, 0), false);
+    res &= cloak::check_data("overflow dropped", q.get_dropped(), uint32_t(6));
+    res &= cloak::check_data("overflow high water", uint32_t(q.get_high_water()), uint32_t(4));
+    res &= cloak::check_data("overflow control high water",
+                             uint32_t(q.get_high_water(TionCommandClass::CONTROL)), uint32_t(4));
+    res &= cloak::check_data("overflow front", q.front().type, uint16_t(6));
+  }
+
+  // flooded link keeps control latency bounded by response time
+  {
+    const auto r = run_queue_flood(250);
+    res &= cloak::check_data("flood control sent", r.control_sent, true);
+    res &= cloak::check_data("flood control latency", r.control_latency <= 100, true);
+    res &= cloak::check_data("flood high water", r.high_water <= TION_COMMAND_QUEUE_SIZE, true);
+    res &= cloak::check_data("flood coalesced", r.coalesced > 0, true);
+    // heartbeat is not waiting for response
+    res &= cloak::check_data("flood link", r.tx_max <= 2, true);
+  }
+
+  // rejected frame does not wait for response
+  {
+    esphome::test_set_millis(0);
+    QueueVPort vport(50);
+    esphome::tion::TionVPortApi<tion_any_frame_t, Tion4sApi> api(&vport);
+    api.set_response_timeout(250);
+    const uint8_t large[Tion4sApi::TX_DATA_MAX_SIZE + 1]{};
+    res &= cloak::check_data("rejected frame", api.write_frame(FRAME_TYPE_STATE_SET, large, sizeof(large)), false);
+    api.write_frame(FRAME_TYPE_STATE_REQ);
+    res &= cloak::check_data("rejected frame next sent", uint32_t(vport.get_tx_size()), uint32_t(1));
+    res &= cloak::check_data("rejected frame queue", api.get_command_queue().empty(), true);
+  }
+
+  return res;
+}
+
+bool test_command_queue_flood() {
+  bool res = true;
+
+  const auto fifo = run_queue_flood(0);
+  const auto queue = run_queue_flood(250);
+
+  res &= cloak::check_data("latency reduced", queue.control_latency < fifo.control_latency, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_command_queue);
+REGISTER_TEST(test_command_queue_flood);
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion/tion_vport.h"
+
+#include "utils.h"
+
+// Link transmits one frame per interval in order of writes, breezer responds at once to all frames except heartbeat.
+class QueueVPort : public esphome::vport::VPort<dentra::tion::tion_any_frame_t>, public Fake4sBreezer {
+ public:
+  explicit QueueVPort(uint32_t interval) : Fake4sBreezer(nullptr), interval_(interval) {}
+
+  struct Sent {
+    uint16_t type;
+    uint32_t time;
+  };
+  std::vector<Sent> sent;
+
+  void write(const dentra::tion::tion_any_frame_t &frame, size_t size) override {
+    const auto *data = reinterpret_cast<const uint8_t *>(&frame);
+    this->tx_.emplace_back(data, data + size);
+  }
+
+  void loop() {
+    const auto now = esphome::millis();
+    if (this->tx_.empty() || now - this->last_time_ < this->interval_) {
+      return;
+    }
+    this->last_time_ = now;
+    const auto tx = this->tx_.front();
+    this->tx_.pop_front();
+    const auto &frame = *reinterpret_cast<const dentra::tion::tion_any_frame_t *>(tx.data());
+    this->sent.push_back({frame.type, now});
+    this->handle_frame(frame.type, frame.data, tx.size() - dentra::tion::tion_any_frame_t::head_size());
+    Fake4sBreezer::poll();
+  }
+
+  size_t get_tx_size() const { return this->tx_.size(); }
+
+ protected:
+  uint32_t interval_;
+  uint32_t last_time_{};
+  std::deque<std::vector<uint8_t>> tx_;
+
+  void on_frame_(uint16_t type, const void *data, size_t size) override {
+    if (type == dentra::tion_4s::FRAME_TYPE_STATE_SET) {
+      Fake4sBreezer::on_frame_(type, data, size);
+    } else if (type != dentra::tion_4s::FRAME_TYPE_HEARTBEAT_REQ) {
+      this->respond_(dentra::tion_4s::FRAME_TYPE_STATE_RSP, 1);
+    }
+  }
+
+  void deliver_(const Response &rsp) override {
+    struct {
+      uint16_t type;
+      RawStateFrame data;
+    } __attribute__((__packed__)) rx{rsp.type, rsp.state};
+    this->fire_frame(*reinterpret_cast<const dentra::tion::tion_any_frame_t *>(&rx), sizeof(rx));
+  }
+};
+
+struct FloodResult {
+  uint32_t control_latency;
+  bool control_sent;
+  size_t tx_max;
+  size_t high_water;
+  uint32_t dropped;
+  uint32_t coalesced;
+};
+
+// Floods the link with diagnostic, state and keepalive frames and then changes the state.
+inline FloodResult run_queue_flood(uint32_t response_timeout) {
+  esphome::test_set_millis(0);
+  QueueVPort vport(50);
+  esphome::tion::TionVPortApi<dentra::tion::tion_any_frame_t, dentra::tion_4s::Tion4sApi> api(&vport);
+  api.set_response_timeout(response_timeout);
+
+  // make state initialized
+  Fake4sBreezer::RawStateFrame rsp{};
+  rsp.data.power_state = true;
+  rsp.data.fan_speed = 1;
+  rsp.data.max_fan_speed = 6;
+  api.read_frame(dentra::tion_4s::FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+
+  FloodResult res{};
+  api.request_timers();
+  for (int i = 0; i < 3; i++) {
+    api.request_errors();
+    api.request_state();
+    api.send_heartbeat();
+  }
+  dentra::tion::TionStateCall call(&api);
+  call.set_fan_speed(4);
+  call.perform();
+  res.tx_max = vport.get_tx_size();
+
+  for (uint32_t now = 10; now <= 3000; now += 10) {
+    esphome::test_set_millis(now);
+    vport.loop();
+    api.check_requests();
+    res.tx_max = std::max(res.tx_max, vport.get_tx_size());
+  }
+
+  for (auto &&sent : vport.sent) {
+    if (sent.type == dentra::tion_4s::FRAME_TYPE_STATE_SET) {
+      res.control_sent = true;
+      res.control_latency = sent.time;
+      break;
+    }
+  }
+  const auto &queue = api.get_command_queue();
+  res.high_water = queue.get_high_water();
+  res.dropped = queue.get_dropped();
+  res.coalesced = queue.get_coalesced();
+  return res;
+}
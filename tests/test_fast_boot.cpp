@@ -0,0 +1,117 @@
+#include "test_fast_boot.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_4s;
+
+namespace {
+
+using RawStateFrame = tion4s_raw_frame_t<tion4s_state_t>;
+
+}  // namespace
+
+bool test_fast_boot() {
+  bool res = true;
+
+  const auto snapshot = make_saved_snapshot();
+  res &= cloak::check_data("snapshot firmware", snapshot.state.firmware_version, uint16_t(0x4242));
+  res &= cloak::check_data("snapshot fan speed", uint8_t(snapshot.state.fan_speed), uint8_t(3));
+  res &= cloak::check_data("snapshot max fan speed", snapshot.max_fan_speed, uint8_t(6));
+
+  // snapshot is published at once and replaced by the received state
+  {
+    const auto r = run_cold_start(8000, true);
+    res &= cloak::check_data("fast boot publish", r.first_publish, uint32_t(0));
+    res &= cloak::check_data("fast boot stale", r.first_stale, true);
+    res &= cloak::check_data("fast boot kept", r.lost, false);
+    res &= cloak::check_data("fast boot received", r.first_received, uint32_t(8100));
+    res &= cloak::check_data("fast boot dev info", uint32_t(r.dev_info_requests), uint32_t(0));
+  }
+
+  // snapshot is dropped when breezer is not available too long
+  {
+    const auto r = run_cold_start(60000, true);
+    res &= cloak::check_data("unavailable lost", r.lost, true);
+  }
+
+  // state is not restored over the received one
+  {
+    ColdStart t(0);
+    t.run_until(2000);
+    res &= cloak::check_data("received not restored", t.api.restore_snapshot(snapshot), false);
+  }
+
+  // changes are not based on the stale state, they are held until the state is received
+  {
+    ColdStart t(8000);
+    t.api.restore_snapshot(snapshot);
+    size_t writes = 0;
+    tion4s_state_set_t set(TionState{});
+    t.api.set_api_writer([&writes, &set](uint16_t type, const void *data, size_t size) {
+      if (type == FRAME_TYPE_STATE_SET) {
+        writes++;
+        set = static_cast<const tion4s_raw_state_set_req_t *>(data)->data;
+      }
+      return true;
+    });
+    TionStateCall call(&t.api);
+    call.set_fan_speed(5);
+    call.perform();
+    res &= cloak::check_data("stale write", uint32_t(writes), uint32_t(0));
+    call.set_sound_state(true);
+    call.perform();
+    res &= cloak::check_data("stale write again", uint32_t(writes), uint32_t(0));
+
+    RawStateFrame rsp{};
+    rsp.request_id = 1;
+    rsp.data.power_state = true;
+    rsp.data.fan_speed = 2;
+    rsp.data.max_fan_speed = 6;
+    rsp.data.target_temperature = 25;
+    t.api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+    res &= cloak::check_data("held write", uint32_t(writes), uint32_t(1));
+    res &= cloak::check_data("held fan speed", set.fan_speed, uint8_t(5));
+    res &= cloak::check_data("held sound", bool(set.sound_state), true);
+    res &= cloak::check_data("held based on received", set.target_temperature, int8_t(25));
+
+    t.api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+    res &= cloak::check_data("held write once", uint32_t(writes), uint32_t(1));
+  }
+
+#ifdef USE_TION_FAST_BOOT
+  // snapshot is written on settings changes only
+  {
+    ColdStart t(0);
+    t.component.set_snapshot_key("test_fast_boot");
+    t.component.call_setup();
+    t.run_until(2000);
+    const auto writes = t.component.get_flash_writes();
+    res &= cloak::check_data("snapshot written", writes > 0, true);
+    t.breezer.state.outdoor_temperature = -5;
+    t.breezer.state.current_temperature = 15;
+    t.run_until(4000);
+    res &= cloak::check_data("snapshot temperatures", t.component.get_flash_writes(), writes);
+    t.breezer.state.fan_speed = 4;
+    t.run_until(6000);
+    res &= cloak::check_data("snapshot fan speed", t.component.get_flash_writes(), writes + 1);
+  }
+#endif
+
+  return res;
+}
+
+bool test_fast_boot_publish() {
+  bool res = true;
+
+  const auto cold = run_cold_start(8000, false);
+  const auto fast = run_cold_start(8000, true);
+
+  res &= cloak::check_data("time to first publish", fast.first_publish < cold.first_publish, true);
+  res &= cloak::check_data("dev info skipped", fast.dev_info_requests < cold.dev_info_requests, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_fast_boot);
+REGISTER_TEST(test_fast_boot_publish);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../components/tion-api/tion-api-internal.h"
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion/tion_component.h"
+
+#include "utils.h"
+
+constexpr uint32_t BOOT_NOT_PUBLISHED = UINT32_MAX;
+
+struct BootResult {
+  // time of the first published state.
+  uint32_t first_publish{BOOT_NOT_PUBLISHED};
+  // time of the first state received from the breezer.
+  uint32_t first_received{BOOT_NOT_PUBLISHED};
+  bool first_stale{};
+  bool lost{};
+  size_t dev_info_requests{};
+};
+
+class ColdStart {
+ public:
+  dentra::tion_4s::Tion4sApi api;
+  // breezer is not reachable until connect_time, e.g. BLE scanning and connection after boot
+  Fake4sBreezer breezer{&api};
+  esphome::tion::TionApiComponent component{&api};
+  BootResult result{};
+
+  explicit ColdStart(uint32_t connect_time) {
+    esphome::test_set_millis(0);
+    this->breezer.connect_time = connect_time;
+    this->breezer.rtt = 100;
+    this->breezer.state.fan_speed = 3;
+    this->breezer.state.outdoor_temperature = 5;
+    this->breezer.state.target_temperature = 20;
+    this->component.set_state_timeout(3000);
+    this->component.test_timeout(true);
+    this->component.add_on_state_callback([this](const dentra::tion::TionState *state) {
+      const auto now = esphome::millis();
+      if (state == nullptr) {
+        this->result.lost = true;
+        return;
+      }
+      if (this->result.first_publish == BOOT_NOT_PUBLISHED) {
+        this->result.first_publish = now;
+        this->result.first_stale = this->component.is_state_stale();
+      }
+      if (!this->component.is_state_stale() && this->result.first_received == BOOT_NOT_PUBLISHED) {
+        this->result.first_received = now;
+      }
+    });
+  }
+
+  // Polls every second with state timeout, runs loop every 10 ms.
+  void run_until(uint32_t ms) {
+    for (uint32_t now = esphome::millis() + 10; now <= ms; now += 10) {
+      esphome::test_set_millis(now);
+      if (now % 1000 == 0) {
+        // fire state timeout of the previous poll
+        this->component.test_timeout(false);
+        this->component.test_timeout(true);
+        this->component.update();
+      }
+      this->breezer.poll();
+      this->component.call_loop();
+    }
+    this->result.dev_info_requests = this->breezer.dev_info_requests;
+  }
+};
+
+// Snapshot saved before reboot.
+inline dentra::tion::TionApiBase::Snapshot make_saved_snapshot() {
+  ColdStart t(0);
+  t.run_until(2000);
+  return t.api.make_snapshot();
+}
+
+inline BootResult run_cold_start(uint32_t connect_time, bool fast_boot) {
+  const auto snapshot = make_saved_snapshot();
+  ColdStart t(connect_time);
+  if (fast_boot) {
+    // loaded from preferences at setup
+    t.api.restore_snapshot(snapshot);
+  }
+  t.run_until(connect_time + 3000);
+  return t.result;
+}
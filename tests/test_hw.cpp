@@ -190,7 +190,7 @@ class Tion4sCompTest : public TionComponentTest<Tion4sApi> {
  public:
   Tion4sCompTest(Tion4sApi *api) : TionComponentTest(api) {
     using this_t = typename std::remove_pointer_t<decltype(this)>;
-    api->set_on_state([this](auto st, auto rid) { this->on_state(st, rid) });
+    api->set_on_state([this](auto st, auto rid, auto) { this->on_state(st, rid) });
     api->set_on_heartbeat([this](auto work_mode) { this->on_heartbeat(wm) });
   }
   void on_state(const TionState &state, uint32_t request_id) {}
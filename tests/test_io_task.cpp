@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../components/tion-api/tion-api-uart-4s.h"
+#include "../components/tion/tion_io_task.h"
+#include "../components/tion/tion_vport_uart.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using dentra::tion::Tion4sUartProtocol;
+using esphome::tion::TionFrameQueue;
+using esphome::uart::UARTComponent;
+
+namespace {
+
+constexpr uint16_t FRAME_TYPE = 0x3231;
+
+struct Payload {
+  uint32_t seq;
+  uint32_t check;
+} __attribute__((__packed__));
+
+// Returns frames with sequential payload as they are received from the uart.
+std::vector<uint8_t> make_frames(uint32_t count) {
+  std::vector<uint8_t> res;
+  Tion4sUartProtocol protocol;
+  protocol.set_protocol_writer([&res](const uint8_t *data, size_t size) {
+    res.insert(res.end(), data, data + size);
+    return true;
+  });
+  for (uint32_t seq = 0; seq < count; seq++) {
+    const Payload payload{seq, ~seq};
+    protocol.write_frame(FRAME_TYPE, &payload, sizeof(payload));
+  }
+  return res;
+}
+
+// Uart io receiving prepared data, the main thread makes it arrive by parts.
+class TestUartIO : public esphome::tion::TionUartIO<Tion4sUartProtocol> {
+ public:
+  explicit TestUartIO(UARTComponent *uart, std::vector<uint8_t> &&rx)
+      : esphome::tion::TionUartIO<Tion4sUartProtocol>(uart), rx_(std::move(rx)) {}
+
+  /// @return false when all data has arrived.
+  bool arrive(size_t size) {
+    const size_t arrived = std::min(this->arrived_.load(std::memory_order_relaxed) + size, this->rx_.size());
+    this->arrived_.store(arrived, std::memory_order_release);
+    return arrived < this->rx_.size();
+  }
+
+  int available() override { return this->arrived_.load(std::memory_order_acquire) - this->pos_; }
+  bool read_array(void *data, size_t size) override {
+    if (size > static_cast<size_t>(this->available())) {
+      return false;
+    }
+    std::memcpy(data, this->rx_.data() + this->pos_, size);
+    this->pos_ += size;
+    return true;
+  }
+
+ protected:
+  const std::vector<uint8_t> rx_;
+  std::atomic<size_t> arrived_{};
+  // accessed by the task only
+  size_t pos_{};
+};
+
+constexpr uint32_t TASK_FRAMES = 100;
+
+struct TaskResult {
+  uint32_t received;
+  bool in_order;
+  bool payload_ok;
+  bool dispatched_on_main;
+};
+
+// Receives frames by the task while the main thread polls, stall makes all data arrive before the first poll.
+TaskResult run_task(bool stall) {
+  UARTComponent uart;
+  TestUartIO io(&uart, make_frames(TASK_FRAMES));
+  std::vector<uint32_t> received;
+  TaskResult res{0, true, true, true};
+  const auto main_thread = std::this_thread::get_id();
+  io.set_on_frame([&](const dentra::tion::tion_any_frame_t &frame, size_t size) {
+    res.dispatched_on_main &= std::this_thread::get_id() == main_thread;
+    const auto *payload = reinterpret_cast<const Payload *>(frame.data);
+    res.payload_ok &= frame.type == FRAME_TYPE && size == sizeof(frame.type) + sizeof(Payload) &&
+                      payload->check == ~payload->seq;
+    received.push_back(payload->seq);
+  });
+
+  if (!io.start_io_task()) {
+    return res;
+  }
+  if (stall) {
+    io.arrive(TASK_FRAMES * 64);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (received.size() < TASK_FRAMES && std::chrono::steady_clock::now() < deadline) {
+    // part of the frame and the next frames arrive while the task is parsing
+    io.arrive(23);
+    io.poll();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  io.stop_io_task();
+  io.poll();
+
+  res.received = received.size();
+  for (size_t i = 0; i < received.size(); i++) {
+    res.in_order &= received[i] == i;
+  }
+  return res;
+}
+
+}  // namespace
+
+bool test_io_task() {
+  bool res = true;
+
+  // fifo order, one slot is reserved to distinguish full queue from empty
+  {
+    TionFrameQueue<4, 4> q;
+    const uint8_t data[5] = {1, 2, 3, 4, 5};
+    res &= cloak::check_data("queue empty", q.empty(), true);
+    res &= cloak::check_data("queue front empty", q.front() == nullptr, true);
+    for (uint8_t i = 1; i <= 3; i++) {
+      res &= cloak::check_data("queue push", q.push(&i, sizeof(i)), true);
+    }
+    res &= cloak::check_data("queue full", q.push(data, 1), false);
+    res &= cloak::check_data("queue too large", q.push(data, sizeof(data)), false);
+    res &= cloak::check_data("queue size", uint32_t(q.size()), uint32_t(3));
+    res &= cloak::check_data("queue dropped", uint32_t(q.get_and_reset_dropped_count()), uint32_t(2));
+    res &= cloak::check_data("queue dropped reset", uint32_t(q.get_and_reset_dropped_count()), uint32_t(0));
+    std::vector<uint8_t> order;
+    while (const auto *frame = q.front()) {
+      order.insert(order.end(), frame->data, frame->data + frame->size);
+      q.pop();
+    }
+    res &= cloak::check_data("queue order", order, "01 02 03");
+    res &= cloak::check_data("queue reused", q.push(data, 4), true);
+  }
+
+  // frames are parsed by the task and dispatched in order from poll
+  {
+    const auto r = run_task(false);
+    res &= cloak::check_data("task received", r.received, TASK_FRAMES);
+    res &= cloak::check_data("task order", r.in_order, true);
+    res &= cloak::check_data("task payload", r.payload_ok, true);
+    res &= cloak::check_data("task dispatched on main", r.dispatched_on_main, true);
+  }
+
+  // while the loop is stalled the task waits for the room in the queue instead of dropping frames
+  {
+    const auto r = run_task(true);
+    res &= cloak::check_data("stall received", r.received, TASK_FRAMES);
+    res &= cloak::check_data("stall order", r.in_order, true);
+  }
+
+  // frames written from the loop are passed to the task and written by it
+  {
+    UARTComponent uart;
+    TestUartIO io(&uart, {});
+    const auto main_thread = std::this_thread::get_id();
+    std::atomic<uint32_t> written{};
+    std::atomic<bool> written_on_main{};
+    io.set_on_tx_complete([&](const uint8_t *, size_t) {
+      written_on_main = std::this_thread::get_id() == main_thread;
+      written++;
+    });
+    if (io.start_io_task()) {
+      dentra::tion::tion_frame_t<uint8_t> frame{FRAME_TYPE, 1};
+      io.write(reinterpret_cast<const dentra::tion::tion_any_frame_t &>(frame), sizeof(frame));
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+      while (written == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      io.stop_io_task();
+    }
+    res &= cloak::check_data("task written", written.load(), uint32_t(1));
+    res &= cloak::check_data("task written on main", written_on_main.load(), false);
+    res &= cloak::check_data("task written data", uint32_t(uart.test_data().size()), uint32_t(8));
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_io_task);
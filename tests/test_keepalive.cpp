@@ -0,0 +1,142 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-uart-4s.h"
+#include "../components/tion/tion_vport_uart.h"
+
+#include "test_keepalive.h"
+
+DEFINE_TAG;
+
+using dentra::tion::Tion4sUartProtocol;
+using esphome::tion::TionKeepalive;
+using esphome::tion::TionKeepaliveJitter;
+using esphome::uart::UARTComponent;
+
+bool test_keepalive() {
+  bool res = true;
+
+  // percentile is the upper bound of the bucket, bucket is 1/20 of the interval
+  {
+    TionKeepaliveJitter jitter;
+    jitter.set_interval(200);
+    for (int i = 0; i < 98; i++) {
+      jitter.add(200);
+    }
+    jitter.add(230);
+    jitter.add(1700);
+    res &= cloak::check_data("jitter p50", jitter.get_percentile(50), uint32_t(210));
+    res &= cloak::check_data("jitter p99", jitter.get_percentile(99), uint32_t(240));
+    res &= cloak::check_data("jitter p100", jitter.get_percentile(100), uint32_t(1700));
+    res &= cloak::check_data("jitter max", jitter.get_max(), uint32_t(1700));
+    jitter.reset();
+    res &= cloak::check_data("jitter empty", jitter.get_percentile(50), uint32_t(0));
+  }
+
+  // keepalive frame is encoded by the protocol, the timer only marks it as due and it is written by the io
+  {
+    esphome::test_set_millis(0);
+    UARTComponent uart;
+    esphome::tion::TionUartIO<Tion4sUartProtocol> io(&uart);
+    uint8_t buf[TionKeepalive::FRAME_MAX_SIZE];
+    const auto size = io.encode_frame(dentra::tion_4s::FRAME_TYPE_HEARTBEAT_REQ, nullptr, 0, buf, sizeof(buf));
+    res &= cloak::check_data("encode heartbeat", std::vector<uint8_t>(buf, buf + size), "3A 07 00 32 39 CE EC");
+    res &= cloak::check_data("encode not sent", uart.test_data().empty(), true);
+    res &= cloak::check_data("encode too large",
+                             uint32_t(io.encode_frame(0x3232, buf, sizeof(buf), buf, sizeof(buf))), uint32_t(0));
+    TionKeepalive keepalive;
+    keepalive.set_interval(200);
+    keepalive.set_frame(buf, size);
+    io.set_keepalive(&keepalive);
+    keepalive.start();
+    esphome::test_set_millis(200);
+    esp_timer_test_run();
+    res &= cloak::check_data("timer not written", uart.test_data().empty(), true);
+    io.poll();
+    res &= cloak::check_data("keepalive written", uart.test_data(), "3A 07 00 32 39 CE EC");
+    keepalive.stop();
+  }
+
+  // disabled keepalive sends nothing and does not count the pause as interval
+  {
+    esphome::test_set_millis(0);
+    uint32_t frames = 0;
+    TionKeepalive keepalive;
+    const uint8_t frame[] = {1};
+    keepalive.set_interval(200);
+    keepalive.set_frame(frame, sizeof(frame));
+    keepalive.set_writer([&frames](const uint8_t *data, size_t size) { frames++; });
+    keepalive.start();
+    res &= cloak::check_data("timer used", keepalive.is_timer(), true);
+    for (uint32_t now = 1; now <= 2000; now++) {
+      esphome::test_set_millis(now);
+      keepalive.set_enabled(now < 500 || now > 1500);
+      esp_timer_test_run();
+      keepalive.loop(now);
+    }
+    res &= cloak::check_data("disabled frames", frames, uint32_t(5));
+    res &= cloak::check_data("disabled max", keepalive.get_jitter().get_max(), uint32_t(200));
+  }
+
+  // cadence holds while loop stalls, frames are written by the task
+  {
+    const auto r = run_keepalive_stalls(200, true, true);
+    res &= cloak::check_data("stall frames", r.frames, uint32_t(300));
+    res &= cloak::check_data("stall max", r.max, uint32_t(200));
+  }
+
+  // without io_task keepalive is written by the TX task, loop does not poll io at all
+  {
+    esphome::test_set_millis(0);
+    UARTComponent uart;
+    esphome::tion::TionUartIO<Tion4sUartProtocol> io(&uart);
+    std::atomic<uint32_t> written{};
+    io.set_on_tx_complete([&written](const uint8_t *data, size_t size) { written++; });
+    uint8_t buf[TionKeepalive::FRAME_MAX_SIZE];
+    const auto size = io.encode_frame(dentra::tion_4s::FRAME_TYPE_HEARTBEAT_REQ, nullptr, 0, buf, sizeof(buf));
+    TionKeepalive keepalive;
+    keepalive.set_interval(200);
+    keepalive.set_frame(buf, size);
+    io.set_keepalive(&keepalive);
+    keepalive.start();
+    if (io.start_tx_task()) {
+      for (uint32_t now = 200; now <= 1000; now += 200) {
+        esphome::test_set_millis(now);
+        esp_timer_test_run();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (written < now / 200 && std::chrono::steady_clock::now() < deadline) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+      res &= cloak::check_data("tx task", io.is_tx_task(), true);
+      io.stop_io_task();
+    }
+    keepalive.stop();
+    res &= cloak::check_data("tx task frames", written.load(), uint32_t(5));
+    res &= cloak::check_data("tx task data", uint32_t(uart.test_data().size()), uint32_t(5 * size));
+    res &= cloak::check_data("tx task max", keepalive.get_jitter().get_max(), uint32_t(200));
+  }
+
+  return res;
+}
+
+bool test_keepalive_stalls() {
+  bool res = true;
+
+  const auto loop_wm = run_keepalive_stalls(200, false, false);
+  const auto timer_wm = run_keepalive_stalls(200, true, true);
+  const auto loop_hb = run_keepalive_stalls(5000, false, false);
+  const auto timer_hb = run_keepalive_stalls(5000, true, true);
+
+  res &= cloak::check_data("work mode p99", timer_wm.p99 < loop_wm.p99, true);
+  res &= cloak::check_data("work mode max", timer_wm.max < loop_wm.max, true);
+  res &= cloak::check_data("heartbeat max", timer_hb.max < loop_hb.max, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_keepalive);
+REGISTER_TEST(test_keepalive_stalls);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../components/tion/tion_keepalive.h"
+
+#include "utils.h"
+
+struct StallResult {
+  uint32_t frames;
+  uint32_t p50;
+  uint32_t p99;
+  uint32_t max;
+};
+
+constexpr uint32_t KEEPALIVE_TASK_PERIOD = 10;
+
+// Sends frame every interval ms for a minute while loop runs every 16 ms and stalls for 300 ms every 2 s
+// (API flush, logger) and for 1500 ms every 20 s (WiFi reconnect). With task frames are written by the I/O or TX
+// task running every KEEPALIVE_TASK_PERIOD ms, which does not stall.
+inline StallResult run_keepalive_stalls(uint32_t interval, bool use_timer, bool task) {
+  esphome::test_set_millis(0);
+  uint32_t frames = 0;
+  esphome::tion::TionKeepalive keepalive;
+  const uint8_t frame[] = {1, 2, 3};
+  keepalive.set_interval(interval);
+  keepalive.set_frame(frame, sizeof(frame));
+  keepalive.set_writer([&frames](const uint8_t *data, size_t size) { frames++; });
+  keepalive.start(use_timer);
+
+  uint32_t loop_time = 0;
+  for (uint32_t now = 1; now <= 60 * 1000; now++) {
+    esphome::test_set_millis(now);
+    esp_timer_test_run();
+    if (task) {
+      if (now % KEEPALIVE_TASK_PERIOD == 0) {
+        keepalive.loop(now);
+      }
+      continue;
+    }
+    if (now < loop_time) {
+      continue;
+    }
+    keepalive.loop(now);
+    loop_time = now + 16;
+    if (now % 20000 < 16) {
+      loop_time += 1500;
+    } else if (now % 2000 < 16) {
+      loop_time += 300;
+    }
+  }
+  keepalive.stop();
+
+  const auto &jitter = keepalive.get_jitter();
+  return {frames, jitter.get_percentile(50), jitter.get_percentile(99), jitter.get_max()};
+}
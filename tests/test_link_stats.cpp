@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../components/tion-api/tion-api-uart-4s.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion/tion_component.h"
+#include "../components/tion/tion_vport_uart.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using dentra::tion::TionLinkStats;
+using dentra::tion::Tion4sUartProtocol;
+using esphome::uart::UARTComponent;
+
+namespace {
+
+class BufUartReader : public dentra::tion::TionUartReader {
+ public:
+  explicit BufUartReader(const std::vector<uint8_t> &data) : data_(data) {}
+  int available() override { return this->data_.size() - this->pos_; }
+  bool read_array(void *data, size_t size) override {
+    if (this->pos_ + size > this->data_.size()) {
+      return false;
+    }
+    std::memcpy(data, this->data_.data() + this->pos_, size);
+    this->pos_ += size;
+    return true;
+  }
+
+ protected:
+  const std::vector<uint8_t> &data_;
+  size_t pos_{};
+};
+
+class LinkStatsComponent : public esphome::tion::Tion4sApiComponent {
+ public:
+  using Tion4sApiComponent::Tion4sApiComponent;
+  void link_summary() { this->link_summary_(); }
+};
+
+// Uart io receiving prepared data read by the I/O task, the main thread makes it arrive by parts.
+class TaskUartIO : public esphome::tion::TionUartIO<Tion4sUartProtocol> {
+ public:
+  explicit TaskUartIO(UARTComponent *uart, std::vector<uint8_t> &&rx)
+      : esphome::tion::TionUartIO<Tion4sUartProtocol>(uart), rx_(std::move(rx)) {}
+
+  /// @return false when all data has arrived.
+  bool arrive(size_t size) {
+    const size_t arrived = std::min(this->arrived_.load(std::memory_order_relaxed) + size, this->rx_.size());
+    this->arrived_.store(arrived, std::memory_order_release);
+    return arrived < this->rx_.size();
+  }
+
+  int available() override { return this->arrived_.load(std::memory_order_acquire) - this->pos_; }
+  bool read_array(void *data, size_t size) override {
+    if (size > static_cast<size_t>(this->available())) {
+      return false;
+    }
+    std::memcpy(data, this->rx_.data() + this->pos_, size);
+    this->pos_ += size;
+    return true;
+  }
+
+ protected:
+  const std::vector<uint8_t> rx_;
+  std::atomic<size_t> arrived_{};
+  // accessed by the task only
+  size_t pos_{};
+};
+
+}  // namespace
+
+bool test_link_stats() {
+  bool res = true;
+
+  Tion4sUartProtocol protocol;
+  std::vector<uint8_t> tx;
+  protocol.set_protocol_writer([&tx](const uint8_t *data, size_t size) {
+    tx.insert(tx.end(), data, data + size);
+    return true;
+  });
+  uint32_t received = 0;
+  protocol.set_protocol_reader([&received](const dentra::tion::tion_any_frame_t &, size_t) { received++; });
+
+  const uint8_t payload[4] = {1, 2, 3, 4};
+  protocol.write_frame(0x3231, payload, sizeof(payload));
+  const auto frame = tx;
+  protocol.write_frame(0x3231, payload, sizeof(payload));
+  const auto &stats = protocol.get_link_stats();
+  res &= cloak::check_data("tx frames", stats.tx_frames.load(), uint32_t(2));
+  res &= cloak::check_data("tx bytes", stats.tx_bytes.load(), uint32_t(frame.size() * 2));
+
+  // noise, valid frame, frame with broken crc and valid frame again
+  std::vector<uint8_t> rx{0x00, 0x11};
+  rx.insert(rx.end(), frame.begin(), frame.end());
+  auto broken = frame;
+  broken[broken.size() - 1] ^= 0xFF;
+  rx.insert(rx.end(), broken.begin(), broken.end());
+  rx.insert(rx.end(), frame.begin(), frame.end());
+  BufUartReader reader(rx);
+  protocol.read_uart_data(&reader);
+  res &= cloak::check_data("rx received", received, uint32_t(2));
+  res &= cloak::check_data("rx frames", stats.rx_frames.load(), uint32_t(2));
+  res &= cloak::check_data("rx bytes", stats.rx_bytes.load(), uint32_t(rx.size()));
+  res &= cloak::check_data("crc errors", stats.crc_errors.load(), uint32_t(1));
+  res &= cloak::check_data("resyncs", stats.resyncs.load() > 0, true);
+  res &= cloak::check_data("errors", stats.errors() >= 2, true);
+
+  // rates are increase of counters during the last minute
+  {
+    dentra::tion_4s::Tion4sApi api;
+    LinkStatsComponent component(&api, esphome::tion::TionVPortType::VPORT_UART);
+    TionLinkStats link{};
+    component.set_link_stats(&link);
+    component.set_state_timeout(3000);
+    res &= cloak::check_data("rate not ready", std::isnan(component.get_link_rate(&TionLinkStats::rx_frames)), true);
+
+    link.rx_frames = 10;
+    component.link_summary();
+    link.rx_frames = 25;
+    link.crc_errors = 3;
+    // state is not received, cloak fires timeout at once
+    component.update();
+    component.link_summary();
+    res &= cloak::check_data("rate rx frames", component.get_link_rate(&TionLinkStats::rx_frames), 15.0f);
+    res &= cloak::check_data("rate crc errors", component.get_link_rate(&TionLinkStats::crc_errors), 3.0f);
+    res &= cloak::check_data("rate timeouts", component.get_link_rate(&TionLinkStats::timeouts), 1.0f);
+
+    component.link_summary();
+    res &= cloak::check_data("rate idle", component.get_link_rate(&TionLinkStats::rx_frames), 0.0f);
+  }
+
+  // counters are incremented by the I/O task while the loop takes summaries, rates add up to the totals
+  {
+    constexpr uint32_t frames = 200;
+    std::vector<uint8_t> task_rx;
+    for (uint32_t i = 0; i < frames; i++) {
+      // noise before every frame makes the task resync
+      task_rx.push_back(0x00);
+      task_rx.insert(task_rx.end(), frame.begin(), frame.end());
+    }
+    const uint32_t task_rx_size = task_rx.size();
+
+    UARTComponent uart;
+    TaskUartIO io(&uart, std::move(task_rx));
+    uint32_t dispatched = 0;
+    io.set_on_frame([&dispatched](const dentra::tion::tion_any_frame_t &, size_t) { dispatched++; });
+    dentra::tion_4s::Tion4sApi api;
+    LinkStatsComponent component(&api, esphome::tion::TionVPortType::VPORT_UART);
+    component.set_link_stats(io.get_link_stats());
+
+    uint32_t rate_frames = 0;
+    uint32_t rate_bytes = 0;
+    const auto summary = [&]() {
+      component.link_summary();
+      rate_frames += component.get_link_rate(&TionLinkStats::rx_frames);
+      rate_bytes += component.get_link_rate(&TionLinkStats::rx_bytes);
+    };
+    if (io.start_io_task()) {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (dispatched < frames && std::chrono::steady_clock::now() < deadline) {
+        io.arrive(13);
+        io.poll();
+        summary();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+      io.stop_io_task();
+    }
+    io.poll();
+    summary();
+    const auto &task_stats = *io.get_link_stats();
+    res &= cloak::check_data("task dispatched", dispatched, frames);
+    res &= cloak::check_data("task rx frames", task_stats.rx_frames.load(), frames);
+    res &= cloak::check_data("task rx bytes", task_stats.rx_bytes.load(), task_rx_size);
+    res &= cloak::check_data("task resyncs", task_stats.resyncs.load() > 0, true);
+    res &= cloak::check_data("task rate frames", rate_frames, frames);
+    res &= cloak::check_data("task rate bytes", rate_bytes, task_rx_size);
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_link_stats);
@@ -0,0 +1,70 @@
+#include "test_poll.h"
+
+DEFINE_TAG;
+
+bool test_poll() {
+  bool res = true;
+
+  PollTest t(0);
+  res &= cloak::check_data("poll initial", t.component.get_poll_interval(), uint32_t(1000));
+
+  // same responses: back off up to max interval, response is received on the next loop
+  t.run_until(1010);
+  res &= cloak::check_data("poll backoff 1", t.component.get_poll_interval(), uint32_t(2000));
+  t.run_until(3020);
+  res &= cloak::check_data("poll backoff 2", t.component.get_poll_interval(), uint32_t(4000));
+  const auto requests = t.breezer.requests;
+  t.run_until(7010);
+  res &= cloak::check_data("poll no request", uint32_t(t.breezer.requests), uint32_t(requests));
+  t.run_until(30 * 60 * 1000);
+  res &= cloak::check_data("poll max", t.component.get_poll_interval(), uint32_t(300000));
+
+  // changed state: fast polling again
+  t.wait(4);
+  t.breezer.set_fan_speed(4);
+  while (t.wait_fan_speed != 0 && esphome::millis() < 40 * 60 * 1000) {
+    t.run_until(esphome::millis() + 10);
+  }
+  res &= cloak::check_data("poll changed", t.component.get_poll_interval(), uint32_t(1000));
+
+  // command: fast polling during fast window even if state is not changed
+  t.run_until(esphome::millis() + 60000);
+  res &= cloak::check_data("poll idle", t.component.get_poll_interval() > 1000, true);
+  t.write_fan_speed(4);
+  t.run_until(esphome::millis() + 25000);
+  res &= cloak::check_data("poll fast window", t.component.get_poll_interval(), uint32_t(1000));
+  t.run_until(esphome::millis() + 10000);
+  res &= cloak::check_data("poll fast window end", t.component.get_poll_interval() > 1000, true);
+
+  // delayed change is confirmed by the next fast poll
+  t.write_fan_speed(5);
+  t.run_until(esphome::millis() + 5000);
+  res &= cloak::check_data("poll confirmed", t.latencies.empty(), false);
+  res &= cloak::check_data("poll confirmed latency", t.latencies.back() <= 3000, true);
+
+  return res;
+}
+
+// Adaptive polling sends fewer requests than fixed polling with the same confirmation latency.
+bool test_poll_adaptive() {
+  bool res = true;
+
+  const uint32_t min = 60 * 1000;
+  {
+    const auto slow = run_poll_hour(60000, 0);
+    const auto adaptive = run_poll_hour(0, 0);
+    res &= cloak::check_data("idle fewer requests", adaptive.requests < slow.requests, true);
+  }
+  {
+    const auto slow = run_poll_hour(60000, 15 * min);
+    const auto fast = run_poll_hour(1000, 15 * min);
+    const auto adaptive = run_poll_hour(0, 15 * min);
+    res &= cloak::check_data("active fewer requests", adaptive.requests < fast.requests, true);
+    res &= cloak::check_data("active faster confirmation", adaptive.latency_max < slow.latency_avg, true);
+  }
+
+  return res;
+}
+
+REGISTER_TEST(test_poll);
+REGISTER_TEST(test_poll_adaptive);
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion/tion_component.h"
+
+#include "utils.h"
+
+// Breezer which applies written fan speed with delay, like a real one spinning up the fan.
+// Write response reports the state before the change.
+class PollBreezer : public Fake4sBreezer {
+ public:
+  uint32_t apply_delay{2000};
+
+  explicit PollBreezer(dentra::tion_4s::Tion4sApi &api) : Fake4sBreezer(&api) {}
+
+  /// Change made with the remote control.
+  void set_fan_speed(uint8_t fan_speed) { this->state.fan_speed = fan_speed; }
+
+  void poll() {
+    if (this->fan_speed_ != 0 && static_cast<int32_t>(esphome::millis() - this->apply_time_) >= 0) {
+      this->state.fan_speed = this->fan_speed_;
+      this->fan_speed_ = 0;
+    }
+    Fake4sBreezer::poll();
+  }
+
+ protected:
+  uint8_t fan_speed_{};
+  uint32_t apply_time_{};
+
+  void on_state_set_(const StateSetRequest &req) override {
+    this->fan_speed_ = req.data.fan_speed;
+    this->apply_time_ = esphome::millis() + this->apply_delay;
+    Fake4sBreezer::on_state_set_(req);
+  }
+};
+
+class PollTest {
+ public:
+  dentra::tion_4s::Tion4sApi api;
+  PollBreezer breezer{api};
+  esphome::tion::TionApiComponent component{&api};
+  // fan speed the latency is measured for
+  uint8_t wait_fan_speed{};
+  uint32_t wait_start{};
+  std::vector<uint32_t> latencies;
+
+  // update_interval 0 means adaptive polling.
+  explicit PollTest(uint32_t update_interval) {
+    const bool adaptive = update_interval == 0;
+    esphome::test_set_millis(0);
+    this->update_interval_ = update_interval;
+    this->component.set_update_interval(adaptive ? 60000 : update_interval);
+    this->component.set_state_timeout(3000);
+    this->component.set_batch_timeout(0);
+    if (adaptive) {
+      this->component.set_adaptive_polling(1000, 300000, 2.0f, 30000);
+    }
+    // keep state timeout scheduled instead of calling it at once
+    this->component.test_timeout(true);
+    this->component.add_on_state_callback([this](const dentra::tion::TionState *state) {
+      if (state && this->wait_fan_speed != 0 && state->fan_speed == this->wait_fan_speed) {
+        this->latencies.push_back(esphome::millis() - this->wait_start);
+        this->wait_fan_speed = 0;
+      }
+    });
+    this->component.call_setup();
+    this->component.update();
+    this->breezer.poll();
+  }
+
+  void write_fan_speed(uint8_t fan_speed) {
+    this->wait(fan_speed);
+    auto *call = this->component.make_call();
+    call->set_fan_speed(fan_speed);
+    call->perform();
+  }
+
+  void wait(uint8_t fan_speed) {
+    this->wait_fan_speed = fan_speed;
+    this->wait_start = esphome::millis();
+  }
+
+  // Runs loop every 10 ms, fixed polling is emulated by calling update.
+  void run_until(uint32_t ms) {
+    for (uint32_t now = esphome::millis() + 10; now <= ms; now += 10) {
+      esphome::test_set_millis(now);
+      if (this->update_interval_ != 0 && now % this->update_interval_ == 0) {
+        this->component.update();
+      }
+      this->breezer.poll();
+      this->component.call_loop();
+    }
+  }
+
+ protected:
+  uint32_t update_interval_;
+};
+
+struct PollResult {
+  size_t requests;
+  uint32_t latency_avg;
+  uint32_t latency_max;
+  uint32_t remote_latency_avg;
+};
+
+inline uint32_t poll_avg(const std::vector<uint32_t> &v) {
+  uint32_t sum{};
+  for (auto x : v) {
+    sum += x;
+  }
+  return v.empty() ? 0 : sum / v.size();
+}
+
+// An hour of breezer with a command and a change made with the remote control every events_period.
+// Change made with the remote control is detected by the next poll, it has whole rest of the period for this.
+inline PollResult run_poll_hour(uint32_t update_interval, uint32_t events_period) {
+  const uint32_t min = 60 * 1000;
+  PollTest t(update_interval);
+  PollResult res{};
+
+  std::vector<uint32_t> remote;
+  uint8_t fan_speed = 1;
+  for (uint32_t at = 0; events_period != 0 && at < 60 * min; at += events_period) {
+    t.run_until(at + min);
+    t.write_fan_speed(++fan_speed);
+    t.run_until(at + 5 * min);
+    t.wait(++fan_speed);
+    t.breezer.set_fan_speed(fan_speed);
+    const auto confirmed = t.latencies.size();
+    t.run_until(at + events_period - 10);
+    if (t.latencies.size() > confirmed) {
+      remote.push_back(t.latencies.back());
+      t.latencies.pop_back();
+    }
+  }
+  t.run_until(60 * min);
+
+  res.requests = t.breezer.requests;
+  res.latency_avg = poll_avg(t.latencies);
+  for (auto x : t.latencies) {
+    res.latency_max = std::max(res.latency_max, x);
+  }
+  res.remote_latency_avg = poll_avg(remote);
+  return res;
+}
@@ -0,0 +1,71 @@
+#include "test_prefs.h"
+
+DEFINE_TAG;
+
+using esphome::tion::TionWriteBehindPreference;
+
+namespace {
+
+struct Record {
+  int8_t fan_speed;
+  int8_t target_temperature;
+};
+
+}  // namespace
+
+bool test_prefs() {
+  bool res = true;
+
+  // first change is written at once, following ones are coalesced until the interval is passed
+  {
+    TionWriteBehindPreference<Record> pref;
+    pref.init(esphome::global_preferences->make_preference<Record>(2, true), 1000);
+    pref.save({1, 20}, 0);
+    res &= cloak::check_data("first write", pref.get_writes(), uint32_t(1));
+    pref.save({2, 20}, 100);
+    pref.save({3, 20}, 200);
+    pref.check(900);
+    res &= cloak::check_data("coalesced", pref.get_writes(), uint32_t(1));
+    res &= cloak::check_data("coalesced dirty", pref.is_dirty(), true);
+    pref.check(1000);
+    res &= cloak::check_data("interval write", pref.get_writes(), uint32_t(2));
+    res &= cloak::check_data("interval value", pref.get().fan_speed, int8_t(3));
+  }
+
+  // same value is not written again
+  {
+    TionWriteBehindPreference<Record> pref;
+    pref.init(esphome::global_preferences->make_preference<Record>(3, true), 1000);
+    pref.save({1, 20}, 0);
+    pref.save({1, 20}, 5000);
+    res &= cloak::check_data("shadow", pref.get_writes(), uint32_t(1));
+    res &= cloak::check_data("shadow dirty", pref.is_dirty(), false);
+  }
+
+  // pending value is flushed on shutdown
+  {
+    TionWriteBehindPreference<Record> pref;
+    pref.init(esphome::global_preferences->make_preference<Record>(4, true), 1000);
+    pref.save({1, 20}, 0);
+    pref.save({2, 20}, 100);
+    res &= cloak::check_data("flush", pref.flush(200), true);
+    res &= cloak::check_data("flush writes", pref.get_writes(), uint32_t(2));
+    res &= cloak::check_data("flush clean", pref.flush(300), false);
+  }
+
+  return res;
+}
+bool test_prefs_week() {
+  bool res = true;
+
+  const auto on_change = run_prefs_week(0);
+  const auto write_behind = run_prefs_week(10 * PREFS_MINUTE);
+
+  res &= cloak::check_data("writes reduced", write_behind * 3 < on_change, true);
+  res &= cloak::check_data("writes bounded", write_behind <= 7 * PREFS_DAY / (10 * PREFS_MINUTE) + 1, true);
+
+  return res;
+}
+
+REGISTER_TEST(test_prefs);
+REGISTER_TEST(test_prefs_week);
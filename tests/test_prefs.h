@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion/tion_prefs.h"
+
+#include "utils.h"
+
+constexpr uint32_t PREFS_MINUTE = 60 * 1000;
+constexpr uint32_t PREFS_HOUR = 60 * PREFS_MINUTE;
+constexpr uint32_t PREFS_DAY = 24 * PREFS_HOUR;
+
+// A week of the breezer in auto mode: CO2 control changes fan speed every 3 minutes, outdoor temperature changes
+// every 20 minutes and the user changes target temperature twice a day. State is polled every 10 s and saved as
+// snapshot on every response.
+// @return flash writes.
+inline uint32_t run_prefs_week(uint32_t save_interval) {
+  using Snapshot = dentra::tion::TionApiBase::Snapshot;
+  dentra::tion_4s::Tion4sApi api;
+  api.set_api_writer([](uint16_t type, const void *data, size_t size) { return true; });
+  esphome::tion::TionWriteBehindPreference<Snapshot> pref;
+  pref.init(esphome::global_preferences->make_preference<Snapshot>(1, false), save_interval);
+
+  dentra::tion_4s::tion4s_raw_frame_t<dentra::tion_4s::tion4s_state_t> rsp{};
+  rsp.data.power_state = true;
+  rsp.data.max_fan_speed = 6;
+  rsp.data.target_temperature = 20;
+  for (uint32_t now = 0; now < 7 * PREFS_DAY; now += 10 * 1000) {
+    esphome::test_set_millis(now);
+    rsp.data.fan_speed = 2 + (now / (3 * PREFS_MINUTE)) % 3;
+    rsp.data.outdoor_temperature = (now / (20 * PREFS_MINUTE)) % 5;
+    rsp.data.target_temperature = 18 + (now / (PREFS_DAY / 2)) % 2 * 4;
+    api.read_frame(dentra::tion_4s::FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+    pref.save(api.make_snapshot(), now);
+    pref.check(now);
+  }
+  // shutdown
+  pref.flush(7 * PREFS_DAY);
+  return pref.get_writes();
+}
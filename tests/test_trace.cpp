@@ -0,0 +1,114 @@
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+#include "../components/tion-api/tion-api-trace.h"
+#include "../components/tion/tion_component.h"
+
+#include "utils.h"
+
+DEFINE_TAG;
+
+using namespace dentra::tion;
+using namespace dentra::tion_4s;
+
+namespace {
+
+#ifdef TION_ENABLE_TRACE
+using RawStateFrame = tion4s_raw_frame_t<tion4s_state_t>;
+
+// Receives state response, marks are taken at the given ms.
+void receive_state(Tion4sApi &api, uint32_t rx_time, uint32_t frame_time, uint32_t state_time, bool traced = true) {
+  RawStateFrame rsp{};
+  rsp.request_id = 1;
+  rsp.data.fan_speed = 1;
+  esphome::test_set_millis(rx_time);
+  if (traced) {
+    TION_TRACE_RX(true);
+    // next data of the same frame does not restart it
+    esphome::test_set_millis(rx_time + 1);
+    TION_TRACE_RX(true);
+    esphome::test_set_millis(frame_time);
+    TION_TRACE_FRAME();
+  }
+  esphome::test_set_millis(state_time);
+  api.read_frame(FRAME_TYPE_STATE_RSP, &rsp, sizeof(rsp));
+}
+#endif
+
+}  // namespace
+
+bool test_trace() {
+  bool res = true;
+
+  // percentile is the upper bound of log2 bucket
+  {
+    TionTraceHistogram histogram;
+    res &= cloak::check_data("histogram empty", histogram.get_percentile(50), uint32_t(0));
+    histogram.add(0);
+    histogram.add(1);
+    histogram.add(3);
+    for (int i = 0; i < 96; i++) {
+      histogram.add(100);
+    }
+    histogram.add(5000);
+    res &= cloak::check_data("histogram count", histogram.get_count(), uint32_t(100));
+    res &= cloak::check_data("histogram p1", histogram.get_percentile(1), uint32_t(0));
+    res &= cloak::check_data("histogram p50", histogram.get_percentile(50), uint32_t(128));
+    res &= cloak::check_data("histogram p99", histogram.get_percentile(99), uint32_t(128));
+    res &= cloak::check_data("histogram p100", histogram.get_percentile(100), uint32_t(5000));
+    res &= cloak::check_data("histogram max", histogram.get_max(), uint32_t(5000));
+    histogram.reset();
+    res &= cloak::check_data("histogram reset", histogram.get_count(), uint32_t(0));
+  }
+
+#ifdef TION_ENABLE_TRACE
+  // every stage of received state is traced until entities are published
+  {
+    Tion4sApi api;
+    esphome::tion::TionApiComponent component(&api);
+    uint32_t publish_time = 0;
+    component.add_on_state_callback([&publish_time](const TionState *state) {
+      esphome::test_set_millis(esphome::millis() + publish_time);
+    });
+    publish_time = 7;
+    receive_state(api, 0, 2, 3);
+    const auto &trace = api.get_trace();
+    res &= cloak::check_data("trace rx", trace.get_histogram(TionTrace::STAGE_RX).get_max(), uint32_t(2000));
+    res &= cloak::check_data("trace dispatch", trace.get_histogram(TionTrace::STAGE_DISPATCH).get_max(),
+                             uint32_t(1000));
+    // cloak runs deferred callbacks at once
+    res &= cloak::check_data("trace defer", trace.get_histogram(TionTrace::STAGE_DEFER).get_max(), uint32_t(0));
+    res &= cloak::check_data("trace publish", trace.get_histogram(TionTrace::STAGE_PUBLISH).get_max(),
+                             uint32_t(7000));
+    res &= cloak::check_data("trace total", trace.get_histogram(TionTrace::STAGE_TOTAL).get_max(),
+                             uint32_t(10000));
+    res &= cloak::check_data("trace string", trace.to_string(),
+                             std::string("rx 2000/2000/2000 dispatch 1000/1000/1000 defer 0/0/0 "
+                                         "publish 7000/7000/7000 total 10000/10000/10000"));
+
+    // state without decoded frame mark is not traced
+    receive_state(api, 20, 20, 20, false);
+    res &= cloak::check_data("untraced count", trace.get_histogram(TionTrace::STAGE_TOTAL).get_count(),
+                             uint32_t(1));
+
+    // several frames received at once start at the frame
+    publish_time = 0;
+    esphome::test_set_millis(30);
+    TION_TRACE_RX(true);
+    TION_TRACE_FRAME();
+    esphome::test_set_millis(35);
+    TION_TRACE_FRAME();
+    receive_state(api, 35, 35, 35, false);
+    res &= cloak::check_data("second frame rx", trace.get_histogram(TionTrace::STAGE_RX).get_percentile(1),
+                             uint32_t(0));
+    res &= cloak::check_data("second frame count", trace.get_histogram(TionTrace::STAGE_TOTAL).get_count(),
+                             uint32_t(2));
+
+    api.get_trace().reset();
+    res &= cloak::check_data("trace reset", trace.get_histogram(TionTrace::STAGE_TOTAL).get_count(), uint32_t(0));
+  }
+#endif
+
+  return res;
+}
+
+REGISTER_TEST(test_trace);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -9,6 +10,9 @@
 
 #include "cloak.h"
 
+#include "../components/tion-api/tion-api-4s-internal.h"
+#include "../components/tion-api/tion-api-4s.h"
+
 
 uint8_t fast_random_8();
 
@@ -32,3 +36,102 @@ template<class Tp> struct NAlloc {
 };
 template<class T, class U> bool operator==(const NAlloc<T> &, const NAlloc<U> &) { return true; }
 template<class T, class U> bool operator!=(const NAlloc<T> &, const NAlloc<U> &) { return false; }
+
+// Tion 4S breezer for api tests. Written frames are handled at once, responses are delivered on poll after rtt ms
+// like the real transport does. Frames written before connect_time are rejected. Tests change the behaviour by
+// overriding handlers.
+class Fake4sBreezer {
+ public:
+  using RawStateFrame = dentra::tion_4s::tion4s_raw_frame_t<dentra::tion_4s::tion4s_state_t>;
+  using StateSetRequest = dentra::tion_4s::tion4s_raw_state_set_req_t;
+
+  dentra::tion_4s::tion4s_state_t state{};
+  // state requests and writes
+  size_t requests{};
+  size_t dev_info_requests{};
+  uint32_t rtt{};
+  uint32_t connect_time{};
+
+  /// Intercepts frames written by the api, without api frames are passed with handle_frame.
+  explicit Fake4sBreezer(dentra::tion_4s::Tion4sApi *api) : api_(api) {
+    this->state.power_state = true;
+    this->state.fan_speed = 1;
+    this->state.max_fan_speed = 6;
+    if (api != nullptr) {
+      api->set_api_writer(
+          [this](uint16_t type, const void *data, size_t size) { return this->handle_frame(type, data, size); });
+    }
+  }
+  virtual ~Fake4sBreezer() {}
+
+  bool handle_frame(uint16_t type, const void *data, size_t size) {
+    if (esphome::millis() < this->connect_time) {
+      return false;
+    }
+    this->on_frame_(type, data, size);
+    return true;
+  }
+
+  /// Sends current state at once, breezer always uses 1 as request id for it.
+  void send_state() { this->deliver_({dentra::tion_4s::FRAME_TYPE_STATE_RSP, 0, this->make_state_(1)}); }
+
+  void poll() {
+    while (!this->rx_.empty() && static_cast<int32_t>(esphome::millis() - this->rx_.front().time) >= 0) {
+      const auto rsp = this->rx_.front();
+      this->rx_.pop_front();
+      this->deliver_(rsp);
+    }
+  }
+
+ protected:
+  struct Response {
+    uint16_t type;
+    uint32_t time;
+    RawStateFrame state;
+  };
+  dentra::tion_4s::Tion4sApi *api_;
+  std::deque<Response> rx_;
+
+  virtual void on_frame_(uint16_t type, const void *data, size_t size) {
+    using namespace dentra::tion_4s;
+    if (type == FRAME_TYPE_STATE_SET) {
+      this->requests++;
+      this->on_state_set_(*static_cast<const StateSetRequest *>(data));
+    } else if (type == FRAME_TYPE_STATE_REQ) {
+      this->requests++;
+      this->respond_(FRAME_TYPE_STATE_RSP, 1);
+    } else if (type == FRAME_TYPE_DEV_INFO_REQ) {
+      this->dev_info_requests++;
+      this->respond_(FRAME_TYPE_DEV_INFO_RSP, 0);
+    }
+  }
+
+  /// Responds with the state before the change, tests which need the change apply it here.
+  virtual void on_state_set_(const StateSetRequest &req) {
+    this->respond_(dentra::tion_4s::FRAME_TYPE_STATE_RSP, req.request_id);
+  }
+
+  void respond_(uint16_t type, uint32_t request_id) {
+    this->rx_.push_back({type, esphome::millis() + this->rtt, this->make_state_(request_id)});
+  }
+
+  RawStateFrame make_state_(uint32_t request_id) const {
+    RawStateFrame rsp{};
+    rsp.request_id = request_id;
+    rsp.data = this->state;
+    return rsp;
+  }
+
+  virtual void deliver_(const Response &rsp) {
+    if (rsp.type == dentra::tion_4s::FRAME_TYPE_DEV_INFO_RSP) {
+      dentra::tion::tion_dev_info_t dev_info{};
+      dev_info.work_mode = dentra::tion::tion_dev_info_t::NORMAL;
+      dev_info.device_type = dentra::tion::tion_dev_info_t::BR4S;
+      dev_info.firmware_version = 0x4242;
+      dev_info.hardware_version = 0x0202;
+      this->api_->read_frame(rsp.type, &dev_info, sizeof(dev_info));
+      return;
+    }
+    this->api_->read_frame(rsp.type, &rsp.state, sizeof(rsp.state));
+  }
+};